@@ -0,0 +1,54 @@
+#pragma once
+
+#include <dtracker/audio/device_manager.hpp>
+#include <dtracker/audio/types.hpp>
+#include <optional>
+
+namespace dtracker::audio::backend
+{
+    /// Called by a backend on its audio thread to fill one block of
+    /// interleaved float output.
+    /// @param output The buffer to fill; nFrames * channels samples.
+    /// @param xrun True if the backend dropped or delayed audio since the last
+    /// block (an underflow on a device, a missed deadline on a timer).
+    /// @param userData The pointer handed to openStream().
+    using RenderCallback = void (*)(float *output, unsigned int nFrames,
+                                    unsigned int channels, bool xrun,
+                                    void *userData);
+
+    /// Defines the contract for the driver that pulls audio out of the engine.
+    /// The Engine owns exactly one backend and only talks to the audio
+    /// hardware (or lack thereof) through this interface.
+    class IAudioBackend
+    {
+      public:
+        virtual ~IAudioBackend() = default;
+
+        /// Opens a stream that will invoke the callback once per block.
+        /// @param deviceId The output device, if the backend needs one.
+        /// @param settings The requested format. Backends may update
+        /// bufferFrames to the block size they actually granted.
+        /// @return True if the stream is open and ready to start.
+        virtual bool openStream(std::optional<unsigned int> deviceId,
+                                types::AudioSettings &settings,
+                                RenderCallback callback, void *userData) = 0;
+
+        /// Begins invoking the callback.
+        virtual bool startStream() = 0;
+
+        /// Stops invoking the callback. The stream stays open.
+        virtual void stopStream() = 0;
+
+        /// Releases the stream. Stops it first if needed.
+        virtual void closeStream() = 0;
+
+        virtual bool isStreamOpen() const = 0;
+        virtual bool isStreamRunning() const = 0;
+
+        /// Returns true if openStream() needs an output device ID.
+        virtual bool requiresDevice() const = 0;
+
+        /// Creates a helper object for querying available audio devices.
+        virtual DeviceManager createDeviceManager() const = 0;
+    };
+} // namespace dtracker::audio::backend
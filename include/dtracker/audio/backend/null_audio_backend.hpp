@@ -0,0 +1,79 @@
+#pragma once
+
+#include <dtracker/audio/backend/i_audio_backend.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace dtracker::audio::backend
+{
+    /// An IAudioBackend with no audio device. A private thread pulls the
+    /// engine's callback on its own clock, either paced like a sound card or
+    /// as fast as possible. Output is discarded or streamed to a render sink.
+    /// This lets headless machines run and profile the real callback path.
+    class NullAudioBackend : public IAudioBackend
+    {
+      public:
+        /// How the driver thread paces its callbacks.
+        enum class Mode
+        {
+            Realtime, // One block per block duration, like a device.
+            FreeRun   // Back-to-back blocks as fast as the CPU allows.
+        };
+
+        explicit NullAudioBackend(Mode mode = Mode::Realtime);
+        ~NullAudioBackend() override;
+
+        /// Overrides the block size requested in AudioSettings. 0 keeps the
+        /// engine's setting. Takes effect on the next openStream().
+        void setBlockFrames(unsigned int frames);
+
+        /// Stops the stream on its own after this many blocks. 0 runs until
+        /// stopStream(). Takes effect on the next startStream().
+        void setBlockLimit(size_t blocks);
+
+        /// Streams every rendered block into the sink. The sink is opened on
+        /// startStream() and closed on stopStream(). Not owned.
+        void setSink(render::IRenderSink *sink);
+
+        /// Returns the number of callbacks made since the stream opened.
+        size_t blocksProcessed() const;
+
+        /// Returns the number of realtime deadlines the callback missed.
+        size_t missedDeadlines() const;
+
+        bool openStream(std::optional<unsigned int> deviceId,
+                        types::AudioSettings &settings,
+                        RenderCallback callback, void *userData) override;
+        bool startStream() override;
+        void stopStream() override;
+        void closeStream() override;
+        bool isStreamOpen() const override;
+        bool isStreamRunning() const override;
+        bool requiresDevice() const override;
+        DeviceManager createDeviceManager() const override;
+
+      private:
+        // The body of the driver thread.
+        void run();
+
+        Mode m_mode;
+        unsigned int m_blockFramesOverride{0};
+        size_t m_blockLimit{0};
+        render::IRenderSink *m_sink{nullptr};
+
+        // Stream state, fixed while the stream is open.
+        RenderCallback m_callback{nullptr};
+        void *m_userData{nullptr};
+        types::AudioSettings m_settings;
+        std::vector<float> m_buffer;
+        bool m_isOpen{false};
+
+        std::thread m_thread;
+        std::atomic<bool> m_running{false};
+        std::atomic<size_t> m_blocksProcessed{0};
+        std::atomic<size_t> m_missedDeadlines{0};
+    };
+} // namespace dtracker::audio::backend
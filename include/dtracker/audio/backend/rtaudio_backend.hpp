@@ -0,0 +1,41 @@
+#pragma once
+
+#include <RtAudio.h>
+
+#include <dtracker/audio/backend/i_audio_backend.hpp>
+#include <memory>
+
+namespace dtracker::audio::backend
+{
+    /// An IAudioBackend that plays through a sound card using RtAudio.
+    class RtAudioBackend : public IAudioBackend
+    {
+      public:
+        RtAudioBackend();
+        ~RtAudioBackend() override;
+
+        bool openStream(std::optional<unsigned int> deviceId,
+                        types::AudioSettings &settings,
+                        RenderCallback callback, void *userData) override;
+        bool startStream() override;
+        void stopStream() override;
+        void closeStream() override;
+        bool isStreamOpen() const override;
+        bool isStreamRunning() const override;
+        bool requiresDevice() const override;
+        DeviceManager createDeviceManager() const override;
+
+      private:
+        // Bridges RtAudio's C-style callback to our RenderCallback.
+        static int rtAudioCallback(void *outputBuffer, void *inputBuffer,
+                                   unsigned int nFrames, double streamTime,
+                                   RtAudioStreamStatus status, void *userData);
+
+        std::unique_ptr<RtAudio> m_audio; // RtAudio instance
+
+        // The engine's callback and its user data, set by openStream().
+        RenderCallback m_callback{nullptr};
+        void *m_userData{nullptr};
+        unsigned int m_channels{0};
+    };
+} // namespace dtracker::audio::backend
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dtracker::audio::dsp
+{
+    /// A forward FFT of real input, sized once and reused.
+    ///
+    /// The input is packed into a complex sequence of half the length, which
+    /// a radix-2 Stockham FFT transforms, and a last pass splits that into
+    /// the spectrum of the real signal. Real and imaginary parts are kept in
+    /// separate arrays and the Stockham order never shuffles bits, so each
+    /// pass is a plain loop over contiguous floats the compiler vectorizes.
+    /// Twiddles and work buffers are made by the constructor; transforms do
+    /// not allocate.
+    class RealFft
+    {
+      public:
+        /// @param size Samples per transform. Must be a power of two of at
+        /// least 4.
+        /// @throws std::invalid_argument for any other size.
+        explicit RealFft(size_t size);
+
+        /// Returns the samples per transform.
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        /// Returns the bins in a spectrum, from DC to Nyquist: size() / 2 + 1.
+        size_t bins() const
+        {
+            return m_size / 2 + 1;
+        }
+
+        /// Transforms size() samples into bins() complex values, unscaled.
+        /// Not thread-safe; use one instance per thread.
+        void forward(const float *input, float *real, float *imag);
+
+        /// Transforms size() samples into bins() magnitudes, unscaled.
+        void magnitudes(const float *input, float *out);
+
+      private:
+        // Transforms m_real/m_imag in place as one complex sequence of
+        // size() / 2 points.
+        void transformHalf();
+
+        size_t m_size;
+
+        // The packed half-length sequence, and the buffers each Stockham
+        // pass writes into.
+        std::vector<float> m_real;
+        std::vector<float> m_imag;
+        std::vector<float> m_workReal;
+        std::vector<float> m_workImag;
+
+        // e^(-2 pi i k / (size / 2)) for the complex passes, and
+        // e^(-2 pi i k / size) for the final split.
+        std::vector<float> m_twiddleReal;
+        std::vector<float> m_twiddleImag;
+        std::vector<float> m_splitReal;
+        std::vector<float> m_splitImag;
+
+        // Scratch for magnitudes().
+        std::vector<float> m_binReal;
+        std::vector<float> m_binImag;
+    };
+} // namespace dtracker::audio::dsp
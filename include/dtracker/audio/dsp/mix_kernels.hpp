@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dtracker::audio::dsp
+{
+    /// The instruction sets the mixing kernels are built for.
+    enum class InstructionSet
+    {
+        Scalar, // Portable C++, always available
+        SSE2,
+        AVX2,
+        AVX512 // AVX-512F
+    };
+
+    /// A table of the inner loops every render path is built from. One table
+    /// exists per instruction set; the best one the CPU supports is picked
+    /// once, the first time kernels() is called.
+    ///
+    /// Buffers may be unaligned and may have any length. Stereo kernels work
+    /// on interleaved frames, so they touch frames * 2 samples.
+    struct MixKernels
+    {
+        /// dst[i] = 0
+        void (*clear)(float *dst, size_t n);
+
+        /// dst[i] += src[i]
+        void (*accumulate)(float *dst, const float *src, size_t n);
+
+        /// dst[i] += src[i] * gain
+        void (*accumulateScaled)(float *dst, const float *src, float gain,
+                                 size_t n);
+
+        /// dst[L] += src[L] * gainLeft, dst[R] += src[R] * gainRight
+        void (*accumulateStereo)(float *dst, const float *src, float gainLeft,
+                                 float gainRight, size_t frames);
+
+        /// buf[L] *= gainLeft, buf[R] *= gainRight
+        void (*applyStereoGain)(float *buffer, float gainLeft, float gainRight,
+                                size_t frames);
+
+        /// dst[i] = int16(clamp(src[i], -1, 1) * 32767), truncating
+        void (*floatToInt16)(std::int16_t *dst, const float *src, size_t n);
+
+        /// dst[i] = src[i] / 32767
+        void (*int16ToFloat)(float *dst, const std::int16_t *src, size_t n);
+
+        /// peaks[i & 1] = max(peaks[i & 1], |src[i]|),
+        /// sumSquares[i & 1] += src[i] * src[i]
+        /// Even and odd samples are kept apart, so stereo frames reduce to
+        /// left and right. The sums may be added in any order.
+        void (*measure)(const float *src, size_t n, float *peaks,
+                        float *sumSquares);
+
+        /// sums[i & 1] += src[i] * coeffs[i]
+        /// The dot product of interleaved frames with a filter, kept apart
+        /// per channel like measure(). The sums may be added in any order.
+        void (*dotStereo)(const float *src, const float *coeffs, size_t n,
+                          float *sums);
+    };
+
+    /// Returns the kernels for the best instruction set this CPU supports.
+    const MixKernels &kernels();
+
+    /// Returns the instruction set kernels() dispatches to.
+    InstructionSet activeInstructionSet();
+
+    /// Returns the kernels for a specific instruction set, or null if this
+    /// build or this CPU cannot run them. Used for testing and benchmarking.
+    const MixKernels *kernelsFor(InstructionSet set);
+
+    /// Returns a printable name for an instruction set.
+    const char *instructionSetName(InstructionSet set);
+
+    /// Splits a track's volume and pan into per-channel stereo gains.
+    /// @param pan Stereo position [-1.0 (L) to 1.0 (R)]; the opposite side is
+    /// attenuated linearly and the near side is left at full volume.
+    inline void panGains(float volume, float pan, float &gainLeft,
+                         float &gainRight)
+    {
+        gainLeft = volume * (1.0f - (pan > 0.0f ? pan : 0.0f));
+        gainRight = volume * (1.0f + (pan < 0.0f ? pan : 0.0f));
+    }
+
+    // --- Convenience wrappers over the dispatched table ---
+
+    inline void clear(float *dst, size_t n)
+    {
+        kernels().clear(dst, n);
+    }
+
+    inline void accumulate(float *dst, const float *src, size_t n)
+    {
+        kernels().accumulate(dst, src, n);
+    }
+
+    inline void accumulateScaled(float *dst, const float *src, float gain,
+                                 size_t n)
+    {
+        kernels().accumulateScaled(dst, src, gain, n);
+    }
+
+    inline void accumulateStereo(float *dst, const float *src, float gainLeft,
+                                 float gainRight, size_t frames)
+    {
+        kernels().accumulateStereo(dst, src, gainLeft, gainRight, frames);
+    }
+
+    inline void applyStereoGain(float *buffer, float gainLeft,
+                                float gainRight, size_t frames)
+    {
+        kernels().applyStereoGain(buffer, gainLeft, gainRight, frames);
+    }
+
+    inline void floatToInt16(std::int16_t *dst, const float *src, size_t n)
+    {
+        kernels().floatToInt16(dst, src, n);
+    }
+
+    inline void int16ToFloat(float *dst, const std::int16_t *src, size_t n)
+    {
+        kernels().int16ToFloat(dst, src, n);
+    }
+
+    inline void measure(const float *src, size_t n, float *peaks,
+                        float *sumSquares)
+    {
+        kernels().measure(src, n, peaks, sumSquares);
+    }
+
+    inline void dotStereo(const float *src, const float *coeffs, size_t n,
+                          float *sums)
+    {
+        kernels().dotStereo(src, coeffs, n, sums);
+    }
+
+    namespace detail
+    {
+        // Per-instruction-set tables, each defined in its own translation
+        // unit. Null when the build target cannot compile that variant.
+        const MixKernels *scalarKernels();
+        const MixKernels *sse2Kernels();
+        const MixKernels *avx2Kernels();
+        const MixKernels *avx512Kernels();
+    } // namespace detail
+} // namespace dtracker::audio::dsp
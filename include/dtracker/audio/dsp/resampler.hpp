@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dtracker::audio::dsp
+{
+    /// How a sample played at another rate is read between its frames.
+    enum class ResampleQuality : std::uint8_t
+    {
+        Linear, // Two frames per output frame; cheapest, dulls the top end
+        Cubic,  // Four-frame Hermite spline; good for dense live patterns
+        Sinc    // Windowed-sinc polyphase filter; for exports
+    };
+
+    /// Frames the sinc filter reads per output frame.
+    constexpr size_t kSincTaps = 16;
+
+    /// Filter phases precomputed between two source frames. Positions in
+    /// between blend the two nearest phases.
+    constexpr size_t kSincPhases = 256;
+
+    /// The most the sinc filter is stretched when reading below the
+    /// source's rate. Stretching moves the filter's cutoff down to the
+    /// output's Nyquist frequency; past this ratio, the cutoff stays at
+    /// 1/kSincMaxStretch of the source's.
+    constexpr size_t kSincMaxStretch = 8;
+
+    /// Adds stereo audio read at a fractional position into 'dst', scaled by
+    /// the given gains. Frames outside the source read as silence. The sinc
+    /// filter comes from tables built at startup, and its inner product
+    /// runs on the dispatched dotStereo kernel. When 'step' is above 1, the
+    /// sinc filter is band-limited to the output's Nyquist frequency, so
+    /// downsampling does not alias.
+    /// @param src Interleaved stereo, 'srcFrames' frames long.
+    /// @param position The source frame the first output frame is read at.
+    /// Advanced by 'step' for every frame written.
+    /// @param step Source frames per output frame: the source rate over the
+    /// output rate.
+    /// @return The frames written. Fewer than 'frames' once the position
+    /// passes the end of the source.
+    size_t resampleStereo(float *dst, size_t frames, const float *src,
+                          size_t srcFrames, double &position, double step,
+                          float gainLeft, float gainRight,
+                          ResampleQuality quality);
+} // namespace dtracker::audio::dsp
@@ -1,24 +1,58 @@
 #pragma once
 
-#include <RtAudio.h>
-
 #include "i_engine.hpp"
+#include <dtracker/audio/backend/i_audio_backend.hpp>
 #include <dtracker/audio/device_manager.hpp>
+#include <dtracker/audio/performance_monitor.hpp>
 #include <dtracker/audio/playback/mixer_playback.hpp>
 #include <dtracker/audio/playback/proxy_playback_unit.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <dtracker/audio/playback/transport.hpp>
+#include <dtracker/audio/realtime.hpp>
+#include <dtracker/audio/rt_log.hpp>
 #include <dtracker/audio/types.hpp>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
+
+// The engine's default processing quantum in frames: 32, 64 or 128, or 0 to
+// render each device buffer in one piece. Set by the build.
+#ifndef DTRACKER_PROCESSING_QUANTUM
+#define DTRACKER_PROCESSING_QUANTUM 64
+#endif
 
 namespace dtracker::audio
 {
-    /// An implementation of the IEngine interface using the RtAudio
-    /// library.
+    /// An implementation of the IEngine interface that renders the playback
+    /// graph through a pluggable audio backend. By default the backend is
+    /// RtAudio; headless machines can use backend::NullAudioBackend instead.
     class Engine : public IEngine
     {
       public:
+        /// The largest processing quantum, in frames.
+        static constexpr unsigned int kMaxProcessingQuantum = 128;
+
+        /// The processing quantum the engine starts with.
+        static constexpr unsigned int kDefaultProcessingQuantum =
+            DTRACKER_PROCESSING_QUANTUM;
+
+        /// Returns true for the quanta the engine has a render loop for.
+        static constexpr bool isSupportedQuantum(unsigned int frames)
+        {
+            return frames == 0 || frames == 32 || frames == 64 ||
+                   frames == 128;
+        }
+
+        /// Creates an engine that plays through RtAudio.
         Engine();
-        ~Engine() = default;
+
+        /// Creates an engine that is driven by the given backend.
+        explicit Engine(std::unique_ptr<backend::IAudioBackend> backend);
+        ~Engine();
 
         // --- IEngine Interface Implementation ---
         // See i_engine.hpp for detailed documentation on these methods.
@@ -30,6 +64,10 @@ namespace dtracker::audio
         playback::ProxyPlaybackUnit *proxyUnit() override;
         DeviceManager createDeviceManager() const override;
         types::AudioSettings const &getSettings() const override;
+        bool lockMemory(const void *data, size_t bytes) override;
+        void unlockMemory(const void *data, size_t bytes) override;
+        playback::ReclaimQueue *reclaimQueue() const override;
+        PerformanceSnapshot performanceSnapshot() const override;
 
         // --- Engine-Specific Public Methods ---
         // These provide lower-level access not part of the general IEngine
@@ -37,23 +75,152 @@ namespace dtracker::audio
         std::optional<unsigned int> currentDeviceId() const;
         bool isStreamOpen() const;
 
+        /// Gets the backend driving this engine.
+        backend::IAudioBackend *audioBackend() const;
+
+        /// Gets the log the audio thread writes to. Its flusher prints the
+        /// records to std::cout and std::cerr.
+        RtLog &realtimeLog();
+
+        /// Gets the sample clock that times the playback graph.
+        const playback::Transport &transport() const override;
+
+        /// Sets how many worker threads help the audio thread render the
+        /// mixer's children. Zero renders everything on the audio thread.
+        /// Takes effect the next time the stream is opened.
+        void setRenderThreadCount(size_t count);
+
+        /// Gets the number of render worker threads requested.
+        size_t renderThreadCount() const;
+
+        /// Sets the number of frames the graph is rendered in. Each device
+        /// buffer is split into quanta of this size, and frames left over
+        /// from the last quantum are handed out at the start of the next
+        /// buffer, so tempo, step and parameter changes land on the same
+        /// frames whatever the device buffer size. 0 renders each device
+        /// buffer in one piece. Safe to call while the stream runs.
+        /// @return False if the size is not supported.
+        bool setProcessingQuantum(unsigned int frames);
+
+        /// Gets the requested processing quantum.
+        unsigned int processingQuantum() const;
+
+        /// Sets how the audio thread and its memory are prepared. Thread
+        /// settings are applied by the first callback after the stream
+        /// opens; memory is locked when the stream opens. Takes effect the
+        /// next time the stream is opened.
+        void setRealtimeOptions(const realtime::Options &options);
+
+        /// Gets the realtime options requested.
+        const realtime::Options &realtimeOptions() const;
+
+        /// Reports which realtime settings took effect for the current
+        /// stream.
+        realtime::Report realtimeReport() const;
+
+        /// Zeroes the performance counters. Best called while the stream
+        /// is stopped.
+        void resetPerformanceCounters();
+
       private:
-        // Helper to bridge the engine with RtAudio's C-style callback.
-        playback::ProxyPlaybackUnit *proxyPlaybackUnit();
+        // Helper to bridge the engine with the backend's C-style callback.
+        static void audioCallback(float *buffer, unsigned int nFrames,
+                                  unsigned int channels, bool xrun,
+                                  void *userData);
+
+        // Renders one block of the graph. Runs on the audio thread.
+        void processBlock(float *buffer, unsigned int nFrames,
+                          unsigned int channels, bool xrun);
+
+        // Fills the device buffer in fixed quanta, carrying the frames of
+        // the last quantum that do not fit over to the next buffer.
+        template <unsigned int Quantum>
+        void processQuanta(float *buffer, unsigned int nFrames,
+                           unsigned int channels);
+
+        // Fills the device buffer in pieces the scratch arena can hold.
+        void processDeviceBlock(float *buffer, unsigned int nFrames,
+                                unsigned int channels);
+
+        // Renders 'nFrames' of the graph at the transport position and
+        // advances the transport.
+        void renderSubBlock(float *buffer, unsigned int nFrames,
+                            unsigned int channels);
+
+        // Applies the realtime thread settings. Runs on the audio thread.
+        void applyRealtimeSettings();
+
+        // Locks or unlocks every registered region to match the options.
+        void syncLockedMemory();
 
         // Helper to start and open the stream
-        bool openStream(unsigned int deviceId);
+        bool openStream(std::optional<unsigned int> deviceId);
 
-        std::unique_ptr<RtAudio> m_audio;               // RtAudio instance
+        std::unique_ptr<backend::IAudioBackend> m_backend; // Audio driver
         audio::types::AudioSettings m_settings;         // Audio stream settings
         std::optional<unsigned int> m_selectedDeviceId; // Selected device ID
 
+        // Collects units, voices and sample data retired by the audio thread.
+        // Declared before the graph so it is destroyed after it.
+        std::unique_ptr<playback::ReclaimQueue> m_reclaimQueue;
+
+        // Records logged on the render path, printed by a flusher thread.
+        // Declared before the graph so it outlives it.
+        RtLog m_log;
+
+        // Temporary buffers units borrow while rendering. Sized for the
+        // stream's block size when the stream opens.
+        playback::ScratchArena m_scratchArena;
+
+        // Workers that render the mixer's children in parallel. Created
+        // when the stream opens; null when rendering on one thread.
+        std::unique_ptr<playback::RenderWorkerPool> m_workerPool;
+        size_t m_renderThreads{0};
+
+        // Counts the frames rendered since the engine was created.
+        playback::Transport m_transport;
+
+        // Callback timing, xruns and activity, written by the audio thread.
+        PerformanceMonitor m_monitor;
+
+        // The quantum requested by the control thread, and the one the
+        // audio thread is using. They differ until the carried frames of
+        // the old quantum have been played.
+        std::atomic<unsigned int> m_processingQuantum{
+            kDefaultProcessingQuantum};
+        unsigned int m_activeQuantum{kDefaultProcessingQuantum};
+
+        // One quantum rendered ahead, of which the last m_carryFrames have
+        // not been played yet. Sized when the stream opens.
+        std::vector<float> m_carry;
+        unsigned int m_carryFrames{0};
+
+        // Realtime setup. The options are copied for the audio thread when
+        // the stream opens, and it publishes what it managed as flags.
+        realtime::Options m_realtimeOptions;
+        realtime::Options m_streamRealtime;
+        bool m_realtimePending{false};
+        std::atomic<unsigned int> m_realtimeFlags{0};
+
+        // Memory registered through lockMemory().
+        struct LockedRegion
+        {
+            const void *data;
+            size_t bytes;
+            bool locked;
+        };
+        std::vector<LockedRegion> m_lockedRegions;
+        mutable std::mutex m_lockedRegionsMutex;
+
         // The root of our audio graph.
         std::unique_ptr<playback::MixerPlaybackUnit> m_mixerUnit;
-        // The proxy that is passed to the RtAudio callback.
+        // The proxy that is rendered by the audio callback.
         std::unique_ptr<playback::ProxyPlaybackUnit> m_proxyUnit;
 
         // Internal state flag.
         bool m_started{false};
     };
-} // namespace dtracker::audio
\ No newline at end of file
+
+    static_assert(Engine::isSupportedQuantum(Engine::kDefaultProcessingQuantum),
+                  "DTRACKER_PROCESSING_QUANTUM must be 0, 32, 64 or 128");
+} // namespace dtracker::audio
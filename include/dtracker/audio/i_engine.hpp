@@ -1,8 +1,11 @@
 #pragma once
 
 #include <dtracker/audio/device_manager.hpp>
+#include <dtracker/audio/performance_monitor.hpp>
 #include <dtracker/audio/playback/mixer_playback.hpp>
 #include <dtracker/audio/playback/proxy_playback_unit.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+#include <dtracker/audio/playback/transport.hpp>
 #include <optional>
 
 namespace dtracker::audio
@@ -39,6 +42,26 @@ namespace dtracker::audio
         virtual DeviceManager createDeviceManager() const = 0;
 
         virtual const types::AudioSettings &getSettings() const = 0;
+
+        /// Gets the sample clock the stream advances after every block.
+        virtual const playback::Transport &transport() const = 0;
+
+        /// Registers memory the audio thread reads, such as a pool or sample
+        /// data, to be locked into RAM when memory locking is enabled. The
+        /// region must stay valid until it is unregistered.
+        /// @return True if the region is locked now.
+        virtual bool lockMemory(const void *data, size_t bytes) = 0;
+
+        /// Unlocks and unregisters a region passed to lockMemory().
+        virtual void unlockMemory(const void *data, size_t bytes) = 0;
+
+        /// Gets the queue that defers destruction of objects the audio
+        /// thread lets go of, or null if there is none.
+        virtual playback::ReclaimQueue *reclaimQueue() const = 0;
+
+        /// Copies the audio thread's performance counters: callback load,
+        /// xruns and activity. Cheap enough to poll every GUI frame.
+        virtual PerformanceSnapshot performanceSnapshot() const = 0;
     };
 
 } // namespace dtracker::audio
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <dtracker/audio/playback/buffer_pool.hpp>
 #include <dtracker/audio/playback/sample_playback_unit.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
 #include <memory>
 
 namespace dtracker::audio
@@ -33,13 +33,18 @@ namespace dtracker::audio
         /// Prepares and starts playback of all tracks.
         virtual void playAllTracks() = 0;
 
+        /// Renders all tracks once, faster than realtime, into the given sink.
+        /// This does not touch the audio device or the live playback graph.
+        /// @param maxFrames Upper bound on the length of the render.
+        /// @return True if the render completed and the sink was written.
+        virtual bool renderAllTracks(render::IRenderSink &sink,
+                                     size_t maxFrames) = 0;
+
         /// Set the playback looping state.
         virtual void setLoopPlayback(bool shouldLoop) = 0;
 
         /// Sets the playback BPM state.
         virtual void setBpm(float bpm) = 0;
-
-        virtual playback::BufferPool *getBufferPool() = 0;
     };
 
 } // namespace dtracker::audio
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace dtracker::audio
+{
+    /// A copy of the engine's performance counters at one moment.
+    struct PerformanceSnapshot
+    {
+        /// The number of buckets in loadHistogram.
+        static constexpr size_t kLoadBins = 20;
+
+        /// The share of a buffer's duration each bucket covers.
+        static constexpr float kLoadBinWidth = 0.1f;
+
+        /// Callbacks run since the stream opened or the last reset.
+        std::uint64_t callbacks{0};
+
+        /// Callbacks the backend flagged as an underflow or overflow.
+        std::uint64_t xruns{0};
+
+        /// Callbacks that took longer than the audio they produced.
+        std::uint64_t overloads{0};
+
+        /// Time spent in the last callback, in nanoseconds.
+        std::uint64_t lastCallbackNanos{0};
+
+        /// Time spent in a callback as a share of the buffer's duration:
+        /// for the last callback, on average, and at worst.
+        float load{0.0f};
+        float averageLoad{0.0f};
+        float peakLoad{0.0f};
+
+        /// Units in the master mixer and voices sounding, as of the last
+        /// rendered block.
+        size_t activeUnits{0};
+        size_t activeVoices{0};
+
+        /// Scratch buffers the audio thread or a render worker asked for
+        /// while its arena was exhausted, since the stream opened.
+        std::uint64_t scratchOverflows{0};
+
+        /// Callback counts by load. Bucket i counts loads from
+        /// i * kLoadBinWidth up to the next bucket; the last bucket also
+        /// counts everything above it.
+        std::array<std::uint64_t, kLoadBins> loadHistogram{};
+    };
+
+    /// Collects timing and activity counters on the audio thread without
+    /// locks, allocation or I/O. Every counter is a preallocated atomic, so
+    /// the GUI can take a snapshot() at any rate without disturbing the
+    /// callback.
+    class PerformanceMonitor
+    {
+      public:
+        /// Records one callback. Audio thread only.
+        /// @param elapsedNanos Time spent producing the buffer.
+        /// @param bufferNanos The duration of the audio produced.
+        /// @param xrun True if the backend reported an xrun.
+        void recordCallback(std::uint64_t elapsedNanos,
+                            std::uint64_t bufferNanos, bool xrun);
+
+        /// Records the number of units in the master mixer.
+        void setActiveUnits(size_t count);
+
+        /// Adds voices to the tally for the block being rendered. Safe to
+        /// call from render workers.
+        void countVoices(size_t count);
+
+        /// Publishes the voice tally of the block just rendered and starts a
+        /// new one. Audio thread only.
+        void publishVoices();
+
+        /// Copies the counters. Safe to call from any thread; the fields may
+        /// come from neighbouring callbacks.
+        PerformanceSnapshot snapshot() const;
+
+        /// Zeroes every counter.
+        void reset();
+
+      private:
+        // Loads are kept in thousandths so they fit plain integer atomics.
+        static constexpr std::uint64_t kLoadScale = 1000;
+
+        std::atomic<std::uint64_t> m_callbacks{0};
+        std::atomic<std::uint64_t> m_xruns{0};
+        std::atomic<std::uint64_t> m_overloads{0};
+        std::atomic<std::uint64_t> m_lastNanos{0};
+        std::atomic<std::uint64_t> m_lastLoad{0};
+        std::atomic<std::uint64_t> m_peakLoad{0};
+        std::atomic<std::uint64_t> m_loadSum{0};
+
+        std::atomic<size_t> m_activeUnits{0};
+        std::atomic<size_t> m_activeVoices{0};
+        std::atomic<size_t> m_voiceTally{0};
+
+        std::array<std::atomic<std::uint64_t>, PerformanceSnapshot::kLoadBins>
+            m_histogram{};
+    };
+} // namespace dtracker::audio
@@ -1,5 +1,6 @@
 #pragma once
 #include <dtracker/audio/types.hpp> // For PCMData
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -23,6 +24,11 @@ namespace dtracker::audio::playback
         /// Acquires an audio buffer from the pool.
         PooledBufferPtr acquire();
 
+        /// Calls 'visit' with each block of memory the pool owns, so it can
+        /// be locked into RAM. The blocks never move.
+        void forEachRegion(
+            const std::function<void(const void *, size_t)> &visit) const;
+
       private:
         friend struct BufferDeleter;
         void release(types::PCMData *buffer);
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/types.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// A node of a compiled graph. Sources wrap a unit that produces audio;
+    /// buses (no unit) sum their inputs. Either way the node's volume and pan
+    /// are applied where its output is mixed into the next node.
+    struct GraphNode
+    {
+        std::shared_ptr<PlaybackUnit> unit; // Null for a bus
+        float volume{1.0f};
+        float pan{0.0f};
+    };
+
+    /// One instruction of a compiled graph's process list.
+    struct GraphStep
+    {
+        enum class Op
+        {
+            Clear,         // Silence slot 'dst'
+            RenderSources, // Add sources [src, src + count) into slot 'dst'
+            MixBus         // Add slot 'src' into 'dst' with node's gains
+        };
+
+        /// The destination slot that stands for the caller's buffer.
+        static constexpr std::uint32_t kOutputSlot = 0xFFFFFFFF;
+
+        Op op{Op::Clear};
+        std::uint32_t dst{0};
+        std::uint32_t src{0};
+        std::uint32_t count{0};
+        std::uint32_t node{0};
+    };
+
+    /// A playback graph flattened by GraphBuilder::compile() into a linear
+    /// process list over a fixed set of buffer slots.
+    ///
+    /// Rendering runs the steps in order; there is no tree to walk and no
+    /// buffer to find, since every step names the slots it reads and writes.
+    /// The sources feeding one bus are independent of each other, so when
+    /// the context carries a RenderWorkerPool they are rendered in parallel.
+    class CompiledGraph : public PlaybackUnit
+    {
+      public:
+        /// Takes the compiler's output. Prefer GraphBuilder::compile().
+        /// @param nodes Every node of the graph, indexed by node ID.
+        /// @param sources Source node IDs, grouped by the bus they feed.
+        /// @param steps The process list, in execution order.
+        /// @param slotCount The number of buffer slots the steps use.
+        /// @param outputNode The node whose output the graph produces.
+        /// @param slotSamples The size of each slot, in samples.
+        CompiledGraph(std::vector<GraphNode> nodes,
+                      std::vector<std::uint32_t> sources,
+                      std::vector<GraphStep> steps, size_t slotCount,
+                      size_t outputNode, size_t slotSamples);
+
+        /// Overwrites the buffer with one block of the graph.
+        void render(float *buffer, unsigned int nFrames, unsigned int channels,
+                    const types::RenderContext &context) override;
+
+        /// Runs the process list and adds the output into the buffer.
+        void renderAdd(float *buffer, unsigned int nFrames,
+                       unsigned int channels,
+                       const types::RenderContext &context,
+                       float gainLeft = 1.0f,
+                       float gainRight = 1.0f) override;
+
+        /// Resets every source.
+        void reset() override;
+
+        /// Changes the volume or pan of the output node.
+        void setParameter(UnitParam param, float value) override;
+
+        /// Returns true once every source has finished.
+        bool isFinished() const override;
+
+        /// Gets the process list.
+        const std::vector<GraphStep> &steps() const;
+
+        /// Gets the number of buffer slots the process list needs.
+        size_t slotCount() const;
+
+      private:
+        // Runs the process list for a block that fits in a slot.
+        void process(float *output, unsigned int nFrames,
+                     unsigned int channels,
+                     const types::RenderContext &context, float gainLeft,
+                     float gainRight);
+
+        // Adds sources [first, first + count) into 'output'.
+        void renderSources(float *output, size_t first, size_t count,
+                           unsigned int nFrames, unsigned int channels,
+                           const types::RenderContext &context);
+
+        // RenderWorkerPool task that renders one source of the current
+        // batch into its own buffer.
+        static void renderSourceTask(void *userData, size_t index,
+                                     float *output, unsigned int nFrames,
+                                     unsigned int channels,
+                                     const types::RenderContext &context);
+
+        // Gets the node's left/right gains for the given channel layout.
+        static void nodeGains(const GraphNode &node, unsigned int channels,
+                              float &gainLeft, float &gainRight);
+
+        float *slotData(std::uint32_t slot);
+
+        std::vector<GraphNode> m_nodes;
+        std::vector<std::uint32_t> m_sources;
+        std::vector<GraphStep> m_steps;
+        size_t m_slotCount{0};
+        size_t m_outputNode{0};
+
+        // Every slot, back to back, allocated when the graph is compiled.
+        std::vector<float> m_slots;
+        size_t m_slotSamples{0};
+
+        // The first source of the batch being rendered by the worker pool.
+        size_t m_batchFirst{0};
+    };
+} // namespace dtracker::audio::playback
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <dtracker/audio/playback/compiled_graph.hpp>
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <memory>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// Describes a playback graph as sources and buses, then compiles it into
+    /// a CompiledGraph the audio thread can run without walking a tree.
+    ///
+    /// Compiling orders the nodes topologically and assigns each bus a
+    /// buffer slot for as long as its output is live, reusing slots the way
+    /// a register allocator reuses registers. Sources render straight into
+    /// the slot of the bus they feed, so they never need a slot of their own.
+    class GraphBuilder
+    {
+      public:
+        using NodeId = size_t;
+
+        /// Adds a node that renders the given unit.
+        NodeId addSource(std::shared_ptr<PlaybackUnit> unit,
+                         float volume = 1.0f, float pan = 0.0f);
+
+        /// Adds a node that sums the outputs connected to it.
+        NodeId addBus(float volume = 1.0f, float pan = 0.0f);
+
+        /// Feeds the output of 'from' into the bus 'to'. A source is rendered
+        /// once per block, so it can only feed one bus; buses may feed
+        /// several. Returns false if the connection is not allowed.
+        bool connect(NodeId from, NodeId to);
+
+        /// Gets the number of nodes added so far.
+        size_t nodeCount() const;
+
+        /// Compiles everything that feeds 'output' into a process list.
+        /// Returns nullptr if 'output' is not a bus or the graph has a cycle.
+        /// @param maxFrames The largest block the graph renders in one pass.
+        /// @param channels The channel count the slots are sized for.
+        std::unique_ptr<CompiledGraph> compile(NodeId output,
+                                               unsigned int maxFrames,
+                                               unsigned int channels) const;
+
+      private:
+        struct Node
+        {
+            GraphNode data;
+            bool isBus{false};
+            std::vector<NodeId> inputs; // In connection order
+            size_t consumers{0};
+        };
+
+        bool isBus(NodeId id) const;
+
+        std::vector<Node> m_nodes;
+    };
+} // namespace dtracker::audio::playback
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <memory>
+
+namespace dtracker::audio::playback
+{
+    /// A single change to the playback graph, sent from a control thread to
+    /// the audio thread. Commands are applied at the start of the next block,
+    /// so the audio thread never sees a half-applied change.
+    struct GraphCommand
+    {
+        enum class Type
+        {
+            AddUnit,    // Start mixing 'unit'.
+            RemoveUnit, // Stop mixing 'unit'.
+            Clear,      // Stop mixing everything.
+            SetParam    // Call unit->setParameter(param, value).
+        };
+
+        Type type{Type::Clear};
+        std::shared_ptr<PlaybackUnit> unit;
+        UnitParam param{UnitParam::Volume};
+        float value{0.0f};
+    };
+} // namespace dtracker::audio::playback
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace dtracker::audio::playback
+{
+    /// A copy of a meter's levels at one moment. Levels are linear amplitudes
+    /// per channel, left then right; a mono meter reports the same value on
+    /// both.
+    struct LevelReading
+    {
+        /// The highest sample seen recently, falling back at
+        /// LevelMeter::kPeakFallDbPerSecond once the signal drops.
+        std::array<float, 2> peak{};
+
+        /// The signal's power averaged over LevelMeter::kRmsWindowSeconds.
+        std::array<float, 2> rms{};
+
+        /// Like peak, but also catching the overs that fall between samples,
+        /// estimated at four times the sample rate.
+        std::array<float, 2> truePeak{};
+
+        /// The transport frame just past the last block measured.
+        std::uint64_t frame{0};
+
+        /// Blocks measured since the meter was created.
+        std::uint64_t blocks{0};
+    };
+
+    /// Meters one signal on the audio thread and publishes its levels for
+    /// the GUI, so the GUI never has to read audio to draw a meter.
+    ///
+    /// Each block costs one vectorized pass for peak and RMS, plus a short
+    /// interpolation filter for the true peak, run over the block with the
+    /// same vector kernels. The levels are published
+    /// under a sequence number in the style of a seqlock. A reader retries
+    /// until it gets a consistent copy and never blocks the audio thread.
+    /// Peaks fall back slowly and RMS is a moving average, so a GUI that
+    /// reads at 30 Hz still sees every peak.
+    class LevelMeter
+    {
+      public:
+        /// How fast a held peak falls once the signal drops.
+        static constexpr float kPeakFallDbPerSecond = 12.0f;
+
+        /// The time constant of the RMS average.
+        static constexpr float kRmsWindowSeconds = 0.3f;
+
+        /// Taps per phase of the true-peak interpolation filter.
+        static constexpr size_t kTruePeakTaps = 8;
+
+        /// @param sampleRate The rate of the audio measured, which sets how
+        /// fast peaks fall and how long RMS averages over.
+        explicit LevelMeter(unsigned int sampleRate = 44100);
+
+        LevelMeter(const LevelMeter &) = delete;
+        LevelMeter &operator=(const LevelMeter &) = delete;
+
+        /// Measures one block and publishes the new levels. Only one thread
+        /// may call it. Blocks with more than two channels are ignored.
+        /// @param frame The transport frame the block starts on.
+        void process(const float *samples, unsigned int frames,
+                     unsigned int channels, std::uint64_t frame);
+
+        /// Turns the true-peak estimate on or off. Off, truePeak reads the
+        /// same as peak and the meter costs a single pass per block.
+        void setTruePeakEnabled(bool enabled);
+        bool truePeakEnabled() const;
+
+        /// Copies the latest levels. Safe to call from any thread at any
+        /// rate.
+        LevelReading read() const;
+
+      private:
+        // Frames filtered per pass of the true-peak filter.
+        static constexpr unsigned int kTruePeakChunkFrames = 256;
+
+        // Raises peaks[ch] to the highest magnitude between the samples of
+        // each channel, estimated by interpolating at a quarter, half and
+        // three quarters of the way.
+        void interpolatedPeaks(const float *samples, unsigned int frames,
+                               unsigned int channels, float *peaks);
+
+        // Sets the published levels under the sequence number.
+        void publish(std::uint64_t frame);
+
+        unsigned int m_sampleRate;
+        std::atomic<bool> m_truePeakEnabled{true};
+
+        // Audio thread state: the levels as of the last block.
+        std::array<float, 2> m_peak{};
+        std::array<float, 2> m_meanSquare{};
+        std::array<float, 2> m_truePeak{};
+        std::uint64_t m_blocks{0};
+
+        // The interpolation filter's input: the last kTruePeakTaps - 1
+        // frames of the previous block, then a chunk of the current one,
+        // interleaved for m_lineChannels. One phase of output is built in
+        // m_phase at a time.
+        std::array<float, (kTruePeakChunkFrames + kTruePeakTaps - 1) * 2>
+            m_line{};
+        std::array<float, kTruePeakChunkFrames * 2> m_phase{};
+        unsigned int m_lineChannels{0};
+
+        // The published copy. Odd while it is being written.
+        std::atomic<std::uint64_t> m_sequence{0};
+        std::array<std::atomic<float>, 2> m_publishedPeak{};
+        std::array<std::atomic<float>, 2> m_publishedRms{};
+        std::array<std::atomic<float>, 2> m_publishedTruePeak{};
+        std::atomic<std::uint64_t> m_publishedFrame{0};
+        std::atomic<std::uint64_t> m_publishedBlocks{0};
+    };
+} // namespace dtracker::audio::playback
@@ -2,52 +2,114 @@
 
 #include <rigtorp/SPSCQueue.h> // Include SPSCQueue
 
-#include <dtracker/audio/playback/buffer_pool.hpp> // Include BufferPool
+#include <atomic>
+#include <cstdint>
+#include <dtracker/audio/playback/graph_command.hpp>
+#include <dtracker/audio/playback/level_meter.hpp>
 #include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
 #include <dtracker/audio/types.hpp>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace dtracker::audio::playback
 {
     // MixerPlaybackUnit allows multiple PlaybackUnits to play simultaneously.
     // It mixes their outputs together and automatically removes finished units.
+    //
+    // The unit list is owned by the audio thread. Control threads never touch
+    // it directly; addUnit(), removeUnit(), clear() and setUnitParameter()
+    // post a GraphCommand to a preallocated ring that render() drains at the
+    // start of each block.
     class MixerPlaybackUnit : public PlaybackUnit
     {
       public:
-        MixerPlaybackUnit() = default;
+        /// The number of commands that can be pending between two blocks.
+        static constexpr size_t kCommandCapacity = 1024;
 
-        // Adds a new playback unit to be mixed with others
+        /// The number of units that can be mixed at once.
+        static constexpr size_t kMaxUnits = 256;
+
+        MixerPlaybackUnit();
+
+        // Queues a new playback unit to be mixed with others
         virtual void addUnit(std::shared_ptr<PlaybackUnit> unit);
 
+        // Queues the removal of a unit from the mix
+        virtual void removeUnit(std::shared_ptr<PlaybackUnit> unit);
+
+        // Queues a parameter change for a unit in the mix
+        void setUnitParameter(std::shared_ptr<PlaybackUnit> unit,
+                              UnitParam param, float value);
+
         // Renders audio by mixing all active units into the output buffer
         void render(float *buffer, unsigned int nFrames, unsigned int channels,
                     const types::RenderContext &context) override;
 
         void reset() override;
 
-        // Clears the playback units from the mix
+        // Queues the removal of all playback units from the mix
         virtual void clear();
 
-        // Returns true if no active units remain (i.e. playback is silent)
+        // Returns true if no active units remain (i.e. playback is silent),
+        // taking commands that have not been applied yet into account.
         bool isFinished() const override;
 
-        /// Sets the buffer pool to use for acquiring transport buffers.
-        void setBufferPool(BufferPool *pool);
+        /// Returns the number of units in the mix as of the last block.
+        size_t unitCount() const;
+
+        /// Sets the tap the master output is copied into for visualization.
+        /// Null turns the tap off. Returns once the audio thread is done
+        /// with the previous tap, so the caller may then destroy it.
+        void setWaveformTap(WaveformTap *tap);
 
-        /// Sets the queue to push waveform data to for visualization.
-        void setWaveformQueue(
-            rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *queue);
+        /// Sets the meter that measures the master output. Null turns
+        /// metering off. Returns once the audio thread is done with the
+        /// previous meter, so the caller may then destroy it.
+        void setLevelMeter(LevelMeter *meter);
 
       private:
-        // Holds all active playback units being mixed
+        // Spins until the block that was between loading the tap and meter
+        // pointers and finishing with them, if any, is done.
+        void waitForOutputPass() const;
+
+        // Posts a command to the audio thread. Returns false if the ring is
+        // full.
+        bool submit(GraphCommand command);
+
+        // Applies every pending command. Runs on the audio thread; units that
+        // leave the mix are retired through the context.
+        void applyCommands(const types::RenderContext &context);
+
+        // RenderWorkerPool task that renders child 'index' into 'output'.
+        static void renderUnitTask(void *userData, size_t index, float *output,
+                                   unsigned int nFrames, unsigned int channels,
+                                   const types::RenderContext &context);
+
+        // Holds all active playback units being mixed. Audio thread only.
         std::vector<std::shared_ptr<PlaybackUnit>> m_units;
 
-        /// A non-owning pointer to the pool of recycled audio buffers.
-        BufferPool *m_bufferPool{nullptr};
+        /// Single-consumer ring of pending graph changes. The audio thread
+        /// pops without locking; producers serialize on m_submitMutex.
+        rigtorp::SPSCQueue<GraphCommand> m_commands{kCommandCapacity};
+        std::mutex m_submitMutex;
+
+        // Bookkeeping that lets isFinished() answer from any thread.
+        std::atomic<size_t> m_liveUnits{0};    // Size of m_units
+        std::atomic<size_t> m_pendingAdds{0};  // Queued AddUnit commands
+        std::atomic<size_t> m_pendingClears{0}; // Queued Clear commands
+        std::atomic<size_t> m_addsSinceClear{0}; // Adds after the last Clear
+
+        /// A non-owning pointer to the tap for the master output.
+        std::atomic<WaveformTap *> m_waveformTap{nullptr};
+
+        /// A non-owning pointer to the meter for the master output.
+        std::atomic<LevelMeter *> m_levelMeter{nullptr};
 
-        /// A non-owning pointer to the thread-safe queue for the master output.
-        rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *m_waveformQueue{
-            nullptr};
+        /// Bumped as the audio thread starts and finishes each tap and meter
+        /// pass, so it is odd while one is in flight. Only one thread renders
+        /// a mixer at a time.
+        std::atomic<uint64_t> m_outputPass{0};
     };
 } // namespace dtracker::audio::playback
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace dtracker::audio::playback
+{
+    /// A bounded, preallocated, lock-free multi-producer single-consumer
+    /// queue. Producers never block and never allocate, so any number of
+    /// real-time threads can push into it. Based on Dmitry Vyukov's bounded
+    /// MPMC ring, restricted to a single consumer.
+    template <typename T> class MpscQueue
+    {
+      public:
+        /// Creates a queue that can hold at least 'capacity' items. The
+        /// capacity is rounded up to the next power of two.
+        explicit MpscQueue(size_t capacity)
+        {
+            if (capacity == 0)
+                throw std::invalid_argument("Queue capacity cannot be zero.");
+
+            size_t size = 1;
+            while (size < capacity)
+                size <<= 1;
+
+            m_mask = size - 1;
+            m_cells = std::make_unique<Cell[]>(size);
+            for (size_t i = 0; i < size; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /// Pushes an item. Safe to call from any number of threads.
+        /// @return False if the queue is full; 'value' is left untouched.
+        bool tryPush(T &value)
+        {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = m_cells[pos & m_mask];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) -
+                                  static_cast<std::intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    // The cell is free for this position; try to claim it.
+                    if (m_enqueuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1,
+                                            std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // The consumer has not freed this cell yet: full.
+                    return false;
+                }
+                else
+                {
+                    // Another producer claimed this position; catch up.
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// Convenience overload for temporaries. The item is lost if the
+        /// queue is full.
+        bool tryPush(T &&value)
+        {
+            return tryPush(value);
+        }
+
+        /// Pops the oldest item. Must only be called from one thread.
+        /// @return False if the queue is empty.
+        bool tryPop(T &out)
+        {
+            Cell &cell = m_cells[m_dequeuePos & m_mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != m_dequeuePos + 1)
+                return false;
+
+            out = std::move(cell.value);
+            cell.value = T{};
+            cell.sequence.store(m_dequeuePos + m_mask + 1,
+                                std::memory_order_release);
+            ++m_dequeuePos;
+            return true;
+        }
+
+        /// Returns the number of items the queue can hold.
+        size_t capacity() const
+        {
+            return m_mask + 1;
+        }
+
+      private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence{0};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask{0};
+
+        // Kept on separate cache lines so producers and the consumer do not
+        // false-share.
+        alignas(64) std::atomic<size_t> m_enqueuePos{0};
+        alignas(64) size_t m_dequeuePos{0};
+    };
+} // namespace dtracker::audio::playback
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <dtracker/audio/playback/transport.hpp>
 #include <dtracker/audio/playback/unit_pool.hpp>
 #include <dtracker/sample/types.hpp>
 #include <dtracker/tracker/types.hpp>
@@ -34,20 +36,59 @@ namespace dtracker::audio::playback
             unsigned int sampleRate);
 
         /// Performs one block of processing, scheduling new notes and mixing
-        /// active ones.
+        /// active ones. Overwrites the buffer.
         void render(float *buffer, unsigned int nFrames, unsigned int channels,
                     const types::RenderContext &context) override;
 
+        /// Performs one block of processing, adding the active notes into
+        /// the buffer scaled by the given gains. Each step triggers its note
+        /// at the exact frame it falls on within the block.
+        void renderAdd(float *buffer, unsigned int nFrames,
+                       unsigned int channels,
+                       const types::RenderContext &context,
+                       float gainLeft = 1.0f,
+                       float gainRight = 1.0f) override;
+
         /// Returns true once the pattern has played through one full cycle
         /// AND all of its triggered notes have finished their playback.
         bool isFinished() const override;
 
+        /// Returns true once every step has been triggered and the last
+        /// step's duration has elapsed.
         virtual bool hasFinishedLoop() const;
 
+        /// Gets the transport time at which the current loop ends at the
+        /// given tempo, or kNever for a pattern without steps. A pattern
+        /// that has not started yet starts at the context's frame.
+        virtual Transport::Time
+        loopEndTime(const types::RenderContext &context) const;
+
+        /// Resets the pattern and schedules its first step at exactly the
+        /// given transport time, so a following loop keeps the fractional
+        /// frame where the previous one ended.
+        void startAt(Transport::Time time);
+
+        /// Returned by loopEndTime() when the loop never ends.
+        static constexpr Transport::Time kNever = ~Transport::Time{0};
+
         /// Resets the pattern to its initial state, ready to be played again.
         void reset() override;
 
+        /// Acquires voices through 'polyphony' as track 'trackId', so a full
+        /// pool steals a voice instead of dropping the note. Null acquires
+        /// straight from the pool.
+        void setPolyphony(PolyphonyManager *polyphony, int trackId);
+
+        /// Returns the number of notes still sounding.
+        size_t activeNoteCount() const;
+
       private:
+        /// Gets the length of one step at the context's tempo.
+        Transport::Time stepLength(const types::RenderContext &context) const;
+
+        /// Starts the note for 'sampleId' 'offset' frames into the block.
+        void triggerNote(int sampleId, unsigned int offset);
+
         /// The 'sheet music' for this pattern, including steps and timing
         /// state.
         dtracker::tracker::types::ActivePattern m_pattern;
@@ -60,6 +101,10 @@ namespace dtracker::audio::playback
         /// player objects.
         UnitPool *m_sampleUnitPool;
 
+        /// Steals voices for this pattern when the pool is full. Optional.
+        PolyphonyManager *m_polyphony{nullptr};
+        int m_trackId{0};
+
         /// The audio engine's sample rate, used for accurate time calculations.
         unsigned int m_sampleRate;
 
@@ -67,6 +112,15 @@ namespace dtracker::audio::playback
         /// steps once.
         bool m_hasFinishedOneLoop{false};
 
+        /// The transport time of the next step. Steps are found by adding
+        /// whole step lengths in fixed point, never by accumulating block
+        /// durations, so rounding cannot build up.
+        Transport::Time m_nextStepTime{0};
+
+        /// False until the first render (or startAt) anchors the pattern to
+        /// the transport.
+        bool m_started{false};
+
         /// This pattern's internal mixer; holds all notes that were triggered
         /// and are currently playing.
         std::vector<UnitPool::PooledUnitPtr> m_activeNotes;
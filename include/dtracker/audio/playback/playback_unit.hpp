@@ -3,6 +3,13 @@
 
 namespace dtracker::audio::playback
 {
+    /// Identifies a parameter that can be changed while a unit is playing.
+    enum class UnitParam
+    {
+        Volume, // Linear gain [0.0 - 1.0]
+        Pan     // Stereo position [-1.0 (L) to 1.0 (R)]
+    };
+
     /**
      * Abstract interface for audio-producing units that can render sound
      * into a shared output buffer.
@@ -32,8 +39,33 @@ namespace dtracker::audio::playback
                             unsigned int channels,
                             const types::RenderContext &context) = 0;
 
+        /**
+         * Renders audio and adds it into the output buffer, scaled by a
+         * per-channel gain, instead of overwriting it.
+         *
+         * gainLeft -  Gain for the left channel, or for every channel when
+         *             the buffer is not stereo.
+         * gainRight - Gain for the right channel of a stereo buffer.
+         *
+         * Parents use this to mix children straight into their own buffer in
+         * a single pass. The default renders into a buffer borrowed from
+         * the context's scratch arena and sums it; without one, it renders
+         * in pieces through a small buffer on the stack. Units that can
+         * produce their output directly should override.
+         */
+        virtual void renderAdd(float *output, unsigned int nFrames,
+                               unsigned int channels,
+                               const types::RenderContext &context,
+                               float gainLeft = 1.0f, float gainRight = 1.0f);
+
         virtual void reset() = 0;
 
+        /**
+         * Changes a playback parameter. Called on the audio thread between
+         * blocks. Units ignore parameters they do not support.
+         */
+        virtual void setParameter(UnitParam /*param*/, float /*value*/) {}
+
         /**
          * Indicates whether playback has finished.
          *
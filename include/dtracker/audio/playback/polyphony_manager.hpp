@@ -0,0 +1,126 @@
+#pragma once
+
+#include <dtracker/audio/playback/sample_playback_unit.hpp>
+#include <dtracker/audio/playback/unit_pool.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// Which voice gives way when a new note needs one.
+    enum class StealPolicy
+    {
+        Oldest,  ///< The voice that started first.
+        Quietest ///< The voice with the lowest level in its last block.
+    };
+
+    /// Hands out voices from a UnitPool under a polyphony limit, stealing a
+    /// playing voice instead of dropping the note once the limit is hit.
+    ///
+    /// A stolen voice is not cut off: it fades out over a few frames on the
+    /// audio thread and then returns to the pool as usual. To cover those
+    /// tails, the manager keeps part of the pool back, so the voice limit is
+    /// lower than the pool's size and the new note always finds a unit.
+    /// Only when more voices are fading than the pool has spare is a note
+    /// dropped.
+    ///
+    /// Meant for the threads that schedule notes; acquire() takes a mutex.
+    /// Every voice taken from the pool must come through acquire(), or it
+    /// escapes the limits and a steal may fade out its next note.
+    class PolyphonyManager
+    {
+      public:
+        /// The default length of a steal fade, about 1.5 ms at 44.1 kHz.
+        static constexpr unsigned int kDefaultFadeFrames = 64;
+
+        /// @param pool The pool voices are acquired from.
+        /// @param maxVoices Voices that may sound at once. 0 keeps an eighth
+        /// of the pool back for fading voices.
+        /// @param policy Which voice to steal.
+        explicit PolyphonyManager(UnitPool *pool, size_t maxVoices = 0,
+                                  StealPolicy policy = StealPolicy::Oldest);
+
+        /// Acquires a voice for a note on 'trackId', stealing one first if
+        /// the track or the whole pool is at its limit.
+        /// @return The voice, or nullptr if the note had to be dropped.
+        UnitPool::PooledUnitPtr acquire(int trackId);
+
+        void setPolicy(StealPolicy policy);
+        StealPolicy policy() const;
+
+        /// Sets how many frames a stolen voice takes to fade out.
+        void setFadeFrames(unsigned int frames);
+        unsigned int fadeFrames() const;
+
+        /// Sets how many voices a track may sound at once. A new note over
+        /// the limit steals from the same track. 0 removes the limit.
+        void setTrackLimit(int trackId, size_t limit);
+        size_t trackLimit(int trackId) const;
+
+        /// Gets the number of voices that may sound at once.
+        size_t maxVoices() const;
+
+        /// Gets the number of voices handed out that are still sounding and
+        /// not being stolen.
+        size_t activeVoices() const;
+
+        /// Gets how many voices have been stolen, in total or from one
+        /// track.
+        std::uint64_t stealCount() const;
+        std::uint64_t trackStealCount(int trackId) const;
+
+        /// Gets how many notes were dropped because no voice was free.
+        std::uint64_t dropCount() const;
+
+        /// Zeroes the steal and drop counts.
+        void resetCounters();
+
+      private:
+        // A voice handed out by acquire(). The manager does not own it; the
+        // pool's generation tells whether it has been released since.
+        struct Voice
+        {
+            SamplePlaybackUnit *unit{nullptr};
+            std::uint32_t generation{0};
+            int trackId{0};
+            std::uint64_t serial{0}; // Order of acquisition
+        };
+
+        struct TrackState
+        {
+            size_t limit{0};
+            size_t active{0};
+            std::uint64_t steals{0};
+        };
+
+        // True while the voice has not gone back to the pool.
+        bool isLive(const Voice &voice) const;
+
+        // Forgets voices that have gone back to the pool and recounts the
+        // ones still sounding. Caller holds m_mutex.
+        void refresh();
+
+        // Fades out the voice the policy picks, from one track or from all
+        // of them if 'trackId' is null. Caller holds m_mutex.
+        // @return False if there was nothing to steal.
+        bool steal(const int *trackId);
+
+        UnitPool *m_pool;
+        size_t m_maxVoices;
+        StealPolicy m_policy;
+        unsigned int m_fadeFrames{kDefaultFadeFrames};
+
+        mutable std::mutex m_mutex;
+        std::vector<Voice> m_voices; // Reserved to the pool's capacity
+        std::unordered_map<int, TrackState> m_tracks;
+        std::uint64_t m_nextSerial{0};
+        size_t m_active{0};
+
+        std::atomic<std::uint64_t> m_steals{0};
+        std::atomic<std::uint64_t> m_drops{0};
+    };
+} // namespace dtracker::audio::playback
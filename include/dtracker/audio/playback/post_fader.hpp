@@ -0,0 +1,61 @@
+#pragma once
+
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/playback/level_meter.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+#include <dtracker/audio/types.hpp>
+
+namespace dtracker::audio::playback
+{
+    /// Adds a unit's output into 'buffer', feeding it to a waveform tap, a
+    /// spectrum tap and a level meter after the unit's own gains but before
+    /// the parent's. 'mix' adds the unit into the buffer it is given with
+    /// the gains it is given. Any observer may be null. The spectrum tap is
+    /// a second tap kept at full rate, because the waveform tap's peak
+    /// decimation would fold high frequencies into the spectrum.
+    ///
+    /// Without observers the unit mixes straight into 'buffer'. With one,
+    /// it mixes into scratch memory that is observed and then summed with
+    /// the parent's gains. If the scratch arena is exhausted, the unit
+    /// mixes straight into 'buffer', the taps drop the block and the meter
+    /// skips it.
+    template <typename Mix>
+    void mixPostFader(WaveformTap *tap, WaveformTap *spectrumTap,
+                      LevelMeter *meter, float *buffer, unsigned int nFrames,
+                      unsigned int channels,
+                      const types::RenderContext &context, float unitLeft,
+                      float unitRight, float gainLeft, float gainRight,
+                      Mix &&mix)
+    {
+        if (tap || spectrumTap || meter)
+        {
+            const size_t samples = static_cast<size_t>(nFrames) * channels;
+            ScratchArena::Frame scratch(context.scratch);
+            if (float *temp = scratch.allocate(samples))
+            {
+                dsp::clear(temp, samples);
+                mix(temp, unitLeft, unitRight);
+                if (tap)
+                    tap->write(temp, nFrames, channels);
+                if (spectrumTap)
+                    spectrumTap->write(temp, nFrames, channels);
+                if (meter)
+                    meter->process(temp, nFrames, channels, context.frame);
+
+                if (channels == 2)
+                    dsp::accumulateStereo(buffer, temp, gainLeft, gainRight,
+                                          nFrames);
+                else
+                    dsp::accumulateScaled(buffer, temp, gainLeft, samples);
+                return;
+            }
+            if (tap)
+                tap->discard();
+            if (spectrumTap)
+                spectrumTap->discard();
+        }
+
+        mix(buffer, unitLeft * gainLeft, unitRight * gainRight);
+    }
+} // namespace dtracker::audio::playback
@@ -23,8 +23,13 @@ namespace dtracker::audio::playback
         void setBpm(float bpm);
         float bpm() const;
 
+        void setResampleQuality(dsp::ResampleQuality quality);
+        dsp::ResampleQuality resampleQuality() const;
+
       private:
         std::atomic<float> m_bpm{120.0f};
+        std::atomic<dsp::ResampleQuality> m_resampleQuality{
+            dsp::ResampleQuality::Cubic};
         std::atomic<bool> m_isLooping{false};
         std::atomic<PlaybackUnit *> m_delegate{nullptr}; // Not owning
     };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <dtracker/audio/playback/mpsc_queue.hpp>
+#include <dtracker/audio/types.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dtracker::audio::playback
+{
+    /// Defers the destruction of objects retired by the audio thread.
+    ///
+    /// Dropping the last reference to a track, a pattern with its blueprint,
+    /// a pooled voice or a PCM buffer runs destructors and free() on whatever
+    /// thread lets go. The audio thread instead hands those references to
+    /// retire(), which only moves a pointer into a preallocated ring. A
+    /// background collector thread later drops them, so the actual
+    /// destruction happens off the real-time path.
+    class ReclaimQueue
+    {
+      public:
+        /// A type-erased reference to anything that must outlive the block.
+        /// Any shared_ptr converts to this without allocating.
+        using Retired = std::shared_ptr<const void>;
+
+        /// The default number of objects that can be waiting for collection.
+        static constexpr size_t kDefaultCapacity = 4096;
+
+        /// Creates the queue. The collector is not started.
+        explicit ReclaimQueue(size_t capacity = kDefaultCapacity);
+
+        /// Stops the collector and destroys everything still queued.
+        ~ReclaimQueue();
+
+        ReclaimQueue(const ReclaimQueue &) = delete;
+        ReclaimQueue &operator=(const ReclaimQueue &) = delete;
+
+        /// Hands an object over for deferred destruction. Lock-free and
+        /// allocation-free; safe to call from any number of audio threads.
+        /// @return False if the queue was full. The object is then released
+        /// in place, as if it had never been retired.
+        bool retire(Retired object);
+
+        /// Destroys everything retired so far on the calling thread.
+        /// Must not be called concurrently with the collector.
+        /// @return The number of objects released.
+        size_t collect();
+
+        /// Starts a background thread that calls collect() periodically.
+        void startCollector(std::chrono::milliseconds interval =
+                                std::chrono::milliseconds(5));
+
+        /// Stops the background thread after a final collect().
+        void stopCollector();
+
+        /// Returns the total number of objects released by collect().
+        size_t reclaimedCount() const;
+
+        /// Returns how many retire() calls found the queue full.
+        size_t overflowCount() const;
+
+      private:
+        // The collector thread loop.
+        void run(std::chrono::milliseconds interval);
+
+        MpscQueue<Retired> m_queue;
+
+        std::thread m_collector;
+        std::mutex m_collectorMutex; // Guards m_stopRequested for the wait
+        std::condition_variable m_collectorWake;
+        bool m_stopRequested{false};
+
+        std::atomic<size_t> m_reclaimed{0};
+        std::atomic<size_t> m_overflows{0};
+    };
+
+    /// Retires an object through the context's queue, or releases it in place
+    /// when the graph is rendered without one (offline renders, tests).
+    inline void retire(const types::RenderContext &context,
+                       ReclaimQueue::Retired object)
+    {
+        if (context.reclaim)
+            context.reclaim->retire(std::move(object));
+    }
+} // namespace dtracker::audio::playback
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <dtracker/audio/types.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// A fixed set of pre-spawned threads that render independent parts of
+    /// the graph in parallel with the audio thread.
+    ///
+    /// The audio thread posts a batch of tasks with run() and then works on
+    /// the batch itself. Workers are woken through a counting semaphore and
+    /// claim tasks from a shared atomic counter, so whichever thread is free
+    /// takes the next task and no thread ever waits on a lock. Every task
+    /// renders into its own preallocated output slot; the caller sums the
+    /// slots afterwards in index order, so the mix does not depend on which
+    /// thread rendered what.
+    class RenderWorkerPool
+    {
+      public:
+        /// Renders task 'index' by adding into 'output', which the pool has
+        /// already cleared. 'context' is the caller's context with the
+        /// running thread's own scratch arena and no worker pool.
+        using Task = void (*)(void *userData, size_t index, float *output,
+                              unsigned int nFrames, unsigned int channels,
+                              const types::RenderContext &context);
+
+        /// The largest number of tasks a single batch may contain.
+        static constexpr size_t kMaxBatch = 0xFFFF;
+
+        /// Spawns the workers and preallocates every buffer they need.
+        /// @param workerCount Threads to spawn in addition to the caller.
+        /// @param maxTasks The largest batch run() will be asked to render.
+        /// @param blockFrames The largest block, in frames.
+        /// @param channels The channel count of every block.
+        /// @param flushDenormals True to flush denormals to zero on the
+        /// workers, as on the audio thread.
+        /// @param requireRealtime True if the caller runs at realtime
+        /// priority. Workers the OS refuses realtime priority then take no
+        /// tasks, so the caller never spins on a thread that can be
+        /// preempted; their share is rendered on the caller instead.
+        RenderWorkerPool(size_t workerCount, size_t maxTasks,
+                         unsigned int blockFrames, unsigned int channels,
+                         bool flushDenormals = false,
+                         bool requireRealtime = false);
+
+        /// Stops and joins the workers.
+        ~RenderWorkerPool();
+
+        RenderWorkerPool(const RenderWorkerPool &) = delete;
+        RenderWorkerPool &operator=(const RenderWorkerPool &) = delete;
+
+        /// Returns true if a batch of this shape fits the preallocated slots
+        /// and there is a worker to share it with.
+        bool canRun(size_t taskCount, unsigned int nFrames,
+                    unsigned int channels) const;
+
+        /// Renders 'taskCount' tasks across the workers and the calling
+        /// thread, returning once every task has finished. Real-time safe:
+        /// it neither allocates nor blocks on a lock. Only one thread may
+        /// call run() at a time.
+        void run(size_t taskCount, Task task, void *userData,
+                 const types::RenderContext &context, unsigned int nFrames,
+                 unsigned int channels);
+
+        /// Gets the output of task 'index' from the last run().
+        const float *slot(size_t index) const;
+
+        /// Returns the number of spawned worker threads.
+        size_t workerCount() const;
+
+        /// Returns the number of workers that take tasks: all of them,
+        /// unless realtime priority is required and was refused to some.
+        size_t activeWorkerCount() const;
+
+        /// Returns how many scratch allocations found a worker's arena
+        /// exhausted, over all workers.
+        std::uint64_t scratchOverflowCount() const;
+
+      private:
+        class Semaphore;
+
+        // Everything a worker needs; only read after claiming a task.
+        struct Batch
+        {
+            Task task{nullptr};
+            void *userData{nullptr};
+            types::RenderContext context;
+            unsigned int nFrames{0};
+            unsigned int channels{0};
+        };
+
+        // Claims and renders tasks until the batch is exhausted.
+        void drain(ScratchArena &scratch);
+
+        // Claims the next task of the current batch, if any is left.
+        bool claim(size_t &index);
+
+        // The body of each worker thread.
+        void workerLoop(size_t workerIndex);
+
+        float *slotData(size_t index);
+
+        std::vector<std::thread> m_workers;
+        std::unique_ptr<Semaphore> m_wake;
+        std::atomic<bool> m_stop{false};
+
+        // Set by each worker as it starts, before the constructor returns.
+        std::atomic<size_t> m_startedWorkers{0};
+        std::atomic<size_t> m_activeWorkers{0};
+
+        // Batch generation, task count and next task index packed together
+        // as [generation:32][count:16][next:16]. Claiming with a single CAS
+        // means a worker that wakes late can never take a task from a
+        // newer batch with stale job data.
+        std::atomic<std::uint64_t> m_cursor{0};
+        std::atomic<size_t> m_remaining{0};
+        Batch m_batch;
+
+        // One output slot per task, each aligned to a cache line.
+        std::vector<float> m_slotStorage;
+        float *m_slotBase{nullptr};
+        size_t m_slotStride{0};
+        size_t m_maxTasks{0};
+        unsigned int m_blockFrames{0};
+        unsigned int m_channels{0};
+        bool m_flushDenormals{false};
+        bool m_requireRealtime{false};
+
+        // Scratch memory for units rendered on each worker.
+        std::vector<std::unique_ptr<ScratchArena>> m_arenas;
+    };
+} // namespace dtracker::audio::playback
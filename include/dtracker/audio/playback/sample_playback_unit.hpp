@@ -2,6 +2,7 @@
 
 #include <dtracker/audio/playback/playback_unit.hpp>
 #include <dtracker/sample/types.hpp>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -9,7 +10,8 @@ namespace dtracker::audio::playback
 {
     /// A playback unit that plays a single, non-looping audio sample from a
     /// buffer. It keeps track of its own playback position and reports when
-    /// it's finished.
+    /// it's finished. A sample recorded at another rate than the context's
+    /// is resampled as it plays, with the context's interpolation quality.
     class SamplePlaybackUnit : public PlaybackUnit
     {
       public:
@@ -24,17 +26,49 @@ namespace dtracker::audio::playback
         void render(float *buffer, unsigned int frames, unsigned int channels,
                     const types::RenderContext &context) override;
 
+        /// Mixes the next chunk of the sample straight into the buffer,
+        /// scaled by the given gains.
+        void renderAdd(float *buffer, unsigned int frames,
+                       unsigned int channels,
+                       const types::RenderContext &context,
+                       float gainLeft = 1.0f,
+                       float gainRight = 1.0f) override;
+
         /// Returns true if the playback position has reached the end of the
         /// sample.
         bool isFinished() const override;
 
-        /// Resets the playback position to the beginning of the sample.
+        /// Resets the playback position to the beginning of the sample and
+        /// clears any start offset.
         void reset() override;
 
+        /// Delays the start of the sample by the given number of frames into
+        /// the next block, so a note can begin mid-block. Leading frames are
+        /// left silent.
+        void setStartOffset(unsigned int frames);
+
+        /// Fades the voice out over the given number of frames, starting with
+        /// its next block, and then finishes it. Used to steal a voice
+        /// without a click. Safe to call from any thread.
+        void fadeOut(unsigned int frames);
+
+        /// Returns true once fadeOut() has been called. Safe to call from
+        /// any thread.
+        bool isFadingOut() const;
+
+        /// Gets the peak level the voice added to the mix in its last block,
+        /// or a negative value if it has not sounded yet. Safe to call from
+        /// any thread.
+        float level() const;
+
         /// Re-initializes a recycled unit with a new sample for playback.
         void reinitialize(
             const dtracker::sample::types::SampleDescriptor &descriptor);
 
+        /// Drops the unit's sample and hands back its PCM data, so the
+        /// caller decides which thread frees it.
+        std::shared_ptr<const types::PCMData> releaseSample();
+
         /// Gets a const reference to the underlying PCM audio data.
         const std::vector<float> &data() const;
 
@@ -50,6 +84,40 @@ namespace dtracker::audio::playback
         /// The current read position in the sample, measured in total samples
         /// (not frames).
         size_t m_position = 0;
+        /// How far past m_position the read position is, in frames, when
+        /// the sample is resampled.
+        double m_fraction = 0.0;
+        /// Frames of silence still to pass before the sample starts.
+        unsigned int m_startOffset = 0;
+
+        /// Starts a requested fade on the audio thread.
+        /// @return True if the voice is fading out.
+        bool beginFade();
+
+        /// Mixes up to 'frames' frames of the fade into the buffer.
+        void renderFade(float *buffer, const float *source, size_t frames,
+                        float gainLeft, float gainRight);
+
+        /// Source frames played per output frame, or 1 if the sample plays
+        /// at its own rate.
+        double playbackStep(const types::RenderContext &context) const;
+
+        /// Mixes the next 'frames' frames of a sample played at another
+        /// rate into the buffer, fade included.
+        void renderResampled(float *buffer, unsigned int frames,
+                             const types::PCMData &samples,
+                             const types::RenderContext &context,
+                             float gainLeft, float gainRight);
+
+        /// The fade length requested by fadeOut(), or 0.
+        std::atomic<unsigned int> m_fadeRequest{0};
+
+        /// The fade being played: its length and the frames left of it.
+        unsigned int m_fadeLength = 0;
+        unsigned int m_fadeLeft = 0;
+
+        /// The peak of the last block, published for voice stealing.
+        std::atomic<float> m_level{-1.0f};
     };
 
     /// A factory function for easily creating a unique_ptr to a
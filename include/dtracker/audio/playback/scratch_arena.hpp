@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// A preallocated stack of float memory that units borrow temporary
+    /// buffers from while rendering. Allocation is a pointer bump and freeing
+    /// is resetting the top, so nothing touches the heap on the audio thread.
+    ///
+    /// The arena is sized once, off the audio thread, for a number of
+    /// block-sized buffers. Units take buffers through a Frame, which gives
+    /// back everything it took when it goes out of scope.
+    class ScratchArena
+    {
+      public:
+        /// Every buffer handed out starts on a cache line boundary.
+        static constexpr size_t kAlignment = 64;
+
+        /// The default number of block-sized buffers the arena holds. Each
+        /// nesting level of the graph that mixes children borrows one.
+        static constexpr size_t kDefaultDepth = 8;
+
+        /// Borrows buffers from an arena for the lifetime of the frame.
+        class Frame
+        {
+          public:
+            /// @param arena The arena to borrow from. May be null, in which
+            /// case allocate() always fails.
+            explicit Frame(ScratchArena *arena);
+            ~Frame();
+
+            Frame(const Frame &) = delete;
+            Frame &operator=(const Frame &) = delete;
+
+            /// Borrows an uninitialized buffer of 'samples' floats.
+            /// @return Null if there is no arena or it is exhausted. The
+            /// arena counts the latter as an overflow.
+            float *allocate(size_t samples);
+
+          private:
+            ScratchArena *m_arena;
+            size_t m_mark{0};
+        };
+
+        ScratchArena() = default;
+
+        /// Creates an arena holding 'capacity' floats.
+        explicit ScratchArena(size_t capacity);
+
+        /// Sizes the arena for 'depth' buffers of frames * channels floats.
+        /// Not real-time safe; call it before the stream starts.
+        void configure(unsigned int frames, unsigned int channels,
+                       size_t depth = kDefaultDepth);
+
+        /// Returns the number of floats the arena can hand out in total.
+        size_t capacity() const;
+
+        /// Returns the number of floats currently borrowed.
+        size_t used() const;
+
+        /// Returns how many allocations found the arena exhausted. Each one
+        /// made a unit fall back to a slower or partial render. Safe to call
+        /// from any thread.
+        std::uint64_t overflowCount() const;
+
+        /// Returns the largest block, in frames, that configure() sized the
+        /// arena for. Zero if it was sized directly.
+        unsigned int blockFrames() const;
+
+      private:
+        // Reallocates the backing storage. Any borrowed memory is lost.
+        void allocateStorage(size_t capacity);
+
+        std::vector<float> m_storage; // Backing memory, over-allocated to align
+        float *m_base{nullptr};       // First aligned float in m_storage
+        size_t m_capacity{0};         // Usable floats from m_base
+        size_t m_top{0};              // Floats currently borrowed
+        unsigned int m_blockFrames{0};
+
+        /// Counts failed allocations. Only the owning thread writes it.
+        std::atomic<std::uint64_t> m_overflows{0};
+    };
+} // namespace dtracker::audio::playback
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <dtracker/audio/playback/level_meter.hpp>
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/track_sequencer.hpp>
+#include <dtracker/audio/playback/unit_pool.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+#include <memory>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// The realtime half of a track scheduled by a TrackSequencer. Each block
+    /// it starts the notes that fall inside it, at their exact frame, and
+    /// mixes the voices that are playing. It never looks up a sample or
+    /// touches the pool; that work was done ahead of time.
+    ///
+    /// Offline renders have no lookahead thread and no deadline, so there
+    /// the unit can drive the sequencer itself, scheduling each block just
+    /// before playing it. Live and offline playback then share one step
+    /// scheduler.
+    class SequencedTrackPlaybackUnit : public PlaybackUnit
+    {
+      public:
+        /// @param sequencer The schedule this unit plays. It is shared with
+        /// the thread that fills it.
+        explicit SequencedTrackPlaybackUnit(
+            std::shared_ptr<TrackSequencer> sequencer);
+
+        /// Sets the track's master volume [0.0 - 1.0].
+        void setVolume(float v);
+
+        /// Sets the track's stereo pan [-1.0 (L) to 1.0 (R)].
+        void setPan(float p);
+
+        /// Sets the tap that receives the track's output after its volume
+        /// and pan. Call it before the unit joins the graph.
+        void setWaveformTap(std::shared_ptr<WaveformTap> tap);
+
+        /// Sets a full-rate tap, fed at the same point as the waveform tap,
+        /// for spectrum analysis. Call it before the unit joins the graph.
+        void setSpectrumTap(std::shared_ptr<WaveformTap> tap);
+
+        /// Sets the meter that measures the track after its volume and pan.
+        /// Call it before the unit joins the graph.
+        void setLevelMeter(std::shared_ptr<LevelMeter> meter);
+
+        /// Makes the unit schedule each block's notes itself before playing
+        /// it, for renders that are not on the audio thread and have no
+        /// lookahead thread. Call it before the unit joins the graph.
+        void setSelfScheduling(bool enabled);
+
+        void render(float *buffer, unsigned int nFrames, unsigned int channels,
+                    const types::RenderContext &context) override;
+
+        /// Starts the notes due in this block and adds every playing voice
+        /// into the buffer with the track's volume and pan, further scaled
+        /// by the given gains.
+        void renderAdd(float *buffer, unsigned int nFrames,
+                       unsigned int channels,
+                       const types::RenderContext &context,
+                       float gainLeft = 1.0f,
+                       float gainRight = 1.0f) override;
+
+        /// Does nothing: the schedule belongs to the sequencer thread and
+        /// cannot be rewound from the audio thread.
+        void reset() override;
+
+        void setParameter(UnitParam param, float value) override;
+
+        /// Returns true once the sequence has ended, every scheduled note
+        /// has started and every voice has played out.
+        bool isFinished() const override;
+
+        /// Gets the schedule this unit plays.
+        const std::shared_ptr<TrackSequencer> &sequencer() const;
+
+      private:
+        // Moves the notes due before 'blockEnd' from the ring to the playing
+        // voices, each offset to the frame it falls on. Returns how many
+        // were taken.
+        size_t startDueNotes(std::uint64_t blockStart, std::uint64_t blockEnd);
+
+        // Schedules and starts every note up to 'blockEnd', refilling the
+        // ring as often as it takes.
+        void scheduleBlock(std::uint64_t blockStart, std::uint64_t blockEnd,
+                           const types::RenderContext &context);
+
+        // Adds every playing voice into the buffer with the given gains and
+        // returns finished voices to the pool.
+        void mixVoices(float *buffer, unsigned int nFrames,
+                       unsigned int channels,
+                       const types::RenderContext &context, float leftGain,
+                       float rightGain);
+
+        std::shared_ptr<TrackSequencer> m_sequencer;
+        std::shared_ptr<WaveformTap> m_waveformTap;
+        std::shared_ptr<WaveformTap> m_spectrumTap;
+        std::shared_ptr<LevelMeter> m_levelMeter;
+
+        float m_volume = 1.0f;
+        float m_pan = 0.0f;
+
+        // The track frame just past the last rendered block.
+        std::uint64_t m_position{0};
+        bool m_started{false};
+        bool m_selfScheduling{false};
+
+        // The notes that have started and are still playing.
+        std::vector<UnitPool::PooledUnitPtr> m_voices;
+    };
+} // namespace dtracker::audio::playback
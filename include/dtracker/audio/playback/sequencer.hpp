@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <dtracker/audio/playback/track_sequencer.hpp>
+#include <dtracker/audio/playback/transport.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// The lookahead thread that keeps every playing track's note ring
+    /// filled. It wakes several times per lookahead window, reads the
+    /// transport and schedules each track up to the window's end, so the
+    /// audio thread always finds its notes waiting.
+    ///
+    /// Tempo and looping changes are picked up on the next pass and apply to
+    /// the notes scheduled after it; notes already in a ring keep their
+    /// time.
+    class Sequencer
+    {
+      public:
+        /// @param transport The engine's clock. It must outlive the
+        /// sequencer.
+        explicit Sequencer(const Transport &transport);
+
+        /// Stops the thread.
+        ~Sequencer();
+
+        Sequencer(const Sequencer &) = delete;
+        Sequencer &operator=(const Sequencer &) = delete;
+
+        /// Sets how far ahead of the transport tracks are scheduled, and
+        /// derives how often the thread wakes from it.
+        /// @param frames The lookahead window in frames.
+        /// @param sampleRate The stream's sample rate.
+        void setLookahead(unsigned int frames, unsigned int sampleRate);
+
+        /// Gets the lookahead window in frames.
+        unsigned int lookahead() const;
+
+        /// Sets the tempo used for scheduling.
+        void setBpm(float bpm);
+
+        /// Sets whether tracks repeat their first pattern.
+        void setLooping(bool isLooping);
+
+        /// Fills the track's first window on the calling thread, so its
+        /// opening notes are ready before it is rendered, then hands it to
+        /// the lookahead thread. Starts the thread on first use.
+        void addTrack(std::shared_ptr<TrackSequencer> track);
+
+        /// Stops scheduling every track.
+        void clear();
+
+        /// Starts the lookahead thread if it is not running.
+        void start();
+
+        /// Stops and joins the lookahead thread.
+        void stop();
+
+        /// Schedules every track once, up to the end of the window.
+        void schedule();
+
+      private:
+        // The lookahead thread loop.
+        void run();
+
+        const Transport &m_transport;
+
+        std::atomic<unsigned int> m_lookahead{2048};
+        std::atomic<float> m_bpm{120.0f};
+        std::atomic<bool> m_isLooping{false};
+
+        std::vector<std::shared_ptr<TrackSequencer>> m_tracks;
+        std::mutex m_tracksMutex; // Guards m_tracks and the scheduling state
+
+        std::thread m_thread;
+        std::mutex m_threadMutex; // Guards m_stopRequested and m_interval
+        std::condition_variable m_wake;
+        bool m_stopRequested{false};
+        std::chrono::microseconds m_interval{10000};
+    };
+} // namespace dtracker::audio::playback
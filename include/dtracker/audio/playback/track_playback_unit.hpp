@@ -1,10 +1,9 @@
 #pragma once
 
-#include <rigtorp/SPSCQueue.h>
-
-#include <dtracker/audio/playback/buffer_pool.hpp>
+#include <dtracker/audio/playback/level_meter.hpp>
 #include <dtracker/audio/playback/pattern_playback_unit.hpp>
 #include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
 #include <memory>
 #include <vector>
 
@@ -16,9 +15,10 @@ namespace dtracker::audio::playback
     {
       public:
         TrackPlaybackUnit() = default;
-        TrackPlaybackUnit(
-            BufferPool *bufferPool,
-            rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *waveformQueue);
+
+        /// @param waveformTap Receives the track's output after its volume
+        /// and pan. May be null.
+        explicit TrackPlaybackUnit(std::shared_ptr<WaveformTap> waveformTap);
 
         /// Adds a new unit (e.g., a pattern) to the end of the playback
         /// sequence.
@@ -30,13 +30,34 @@ namespace dtracker::audio::playback
         /// Sets the track's stereo pan [-1.0 (L) to 1.0 (R)].
         void setPan(float p);
 
+        /// Sets the meter that measures the track after its volume and pan.
+        /// Call it before the unit joins the graph.
+        void setLevelMeter(std::shared_ptr<LevelMeter> meter);
+
         // --- Overridden virtual functions ---
         void render(float *buffer, unsigned int nFrames, unsigned int channels,
                     const types::RenderContext &context) override;
+
+        /// Adds the current pattern into the buffer with the track's volume
+        /// and pan, further scaled by the given gains.
+        void renderAdd(float *buffer, unsigned int nFrames,
+                       unsigned int channels,
+                       const types::RenderContext &context,
+                       float gainLeft = 1.0f,
+                       float gainRight = 1.0f) override;
+
         void reset() override;
+        void setParameter(UnitParam param, float value) override;
         bool isFinished() const override;
 
       private:
+        // Plays the sequence into the buffer with the given gains, switching
+        // patterns wherever a loop ends inside the block.
+        void renderPatterns(float *buffer, unsigned int nFrames,
+                            unsigned int channels,
+                            const types::RenderContext &context,
+                            float leftGain, float rightGain);
+
         float m_volume = 1.0f;
         float m_pan = 0.0f;
 
@@ -47,12 +68,10 @@ namespace dtracker::audio::playback
         // playing.
         size_t m_currentUnitIndex{0};
 
-        /// A non-owning pointer to the pool of recycled audio buffers.
-        BufferPool *m_bufferPool{nullptr};
+        /// The waveform tap for this specific track, shared with the GUI.
+        std::shared_ptr<WaveformTap> m_waveformTap;
 
-        /// A non-owning pointer to the thread-safe queue for this specific
-        /// track.
-        rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *m_waveformQueue{
-            nullptr};
+        /// The level meter for this specific track, shared with the GUI.
+        std::shared_ptr<LevelMeter> m_levelMeter;
     };
 } // namespace dtracker::audio::playback
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <rigtorp/SPSCQueue.h>
+
+#include <atomic>
+#include <cstdint>
+#include <dtracker/audio/playback/pattern_playback_unit.hpp>
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <dtracker/audio/playback/transport.hpp>
+#include <dtracker/audio/playback/unit_pool.hpp>
+#include <dtracker/tracker/types.hpp>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// A note scheduled ahead of time: a voice that is already configured
+    /// with its sample, and the frame it must start on.
+    struct NoteEvent
+    {
+        /// The start frame, counted from the first frame the track played.
+        std::uint64_t frame{0};
+
+        UnitPool::PooledUnitPtr voice;
+    };
+
+    /// The scheduling half of a track. It walks the track's patterns ahead
+    /// of playback on a non-realtime thread, doing the blueprint lookups and
+    /// pool acquisitions there, and pushes the resulting notes into a
+    /// lock-free ring. The audio thread only pops the notes that are due.
+    ///
+    /// Event frames are relative to the track's origin, the transport frame
+    /// of its first rendered block, so scheduling can begin before the audio
+    /// thread has seen the track.
+    class TrackSequencer
+    {
+      public:
+        /// The default number of notes that can be waiting in the ring.
+        static constexpr size_t kDefaultCapacity = 256;
+
+        /// Returned by origin() until the track has been rendered.
+        static constexpr std::uint64_t kNoOrigin = ~std::uint64_t{0};
+
+        /// @param patterns The track's pattern sequence, in playing order.
+        /// @param blueprint The sample data for every step in the patterns.
+        /// @param sampleUnitPool The pool the voices are acquired from.
+        /// @param sampleRate The project's sample rate.
+        /// @param capacity The number of notes the ring can hold.
+        TrackSequencer(
+            std::vector<dtracker::tracker::types::ActivePattern> patterns,
+            SampleBlueprint blueprint, UnitPool *sampleUnitPool,
+            unsigned int sampleRate, size_t capacity = kDefaultCapacity);
+
+        /// Acquires voices through 'polyphony' as track 'trackId', so a full
+        /// pool steals a voice instead of dropping the note. Null acquires
+        /// straight from the pool. Set before the first scheduleUntil().
+        void setPolyphony(PolyphonyManager *polyphony, int trackId);
+
+        /// Schedules every step that starts before 'untilFrame'. Stops early,
+        /// without losing its place, if the ring is full. Must only be
+        /// called by one thread at a time.
+        /// @param untilFrame The end of the lookahead window, in track frames.
+        /// @param bpm The tempo to schedule at.
+        /// @param isLooping True to repeat the first pattern instead of
+        /// moving through the sequence.
+        void scheduleUntil(std::uint64_t untilFrame, float bpm,
+                           bool isLooping);
+
+        /// Converts a transport frame to track frames. Before the track has
+        /// been rendered, its playback has not started and this returns 0.
+        std::uint64_t trackFrame(std::uint64_t transportFrame) const;
+
+        /// Gets the ring the audio thread consumes notes from.
+        rigtorp::SPSCQueue<NoteEvent> &events();
+
+        /// Gets the sample data the track's steps play.
+        const SampleBlueprint &blueprint() const;
+
+        /// Gets the most voices the track can have playing at once: every
+        /// voice in the pool it acquires from.
+        size_t voiceCapacity() const;
+
+        /// Records the transport frame at which the track started playing.
+        /// Called once by the audio thread.
+        void setOrigin(std::uint64_t transportFrame);
+
+        /// Gets the track's origin, or kNoOrigin before it has played.
+        std::uint64_t origin() const;
+
+        /// Returns true once the last step of a non-looping sequence has
+        /// been scheduled.
+        bool hasFinished() const;
+
+        /// Gets the track frame at which the sequence ends. Only meaningful
+        /// once hasFinished() is true.
+        std::uint64_t endFrame() const;
+
+      private:
+        /// Pushes a note for 'sampleId' starting at 'frame'.
+        /// @return False if the ring is full and the step must be retried.
+        bool pushNote(int sampleId, std::uint64_t frame);
+
+        /// Moves to the pattern that follows the current one.
+        /// @return False if the sequence has ended.
+        bool nextPattern(bool isLooping);
+
+        std::vector<dtracker::tracker::types::ActivePattern> m_patterns;
+        SampleBlueprint m_blueprint;
+        UnitPool *m_sampleUnitPool;
+        unsigned int m_sampleRate;
+        PolyphonyManager *m_polyphony{nullptr};
+        int m_trackId{0};
+
+        // Scheduling state, owned by the scheduling thread.
+        size_t m_patternIndex{0};
+        size_t m_step{0};
+        Transport::Time m_nextStepTime{0};
+
+        rigtorp::SPSCQueue<NoteEvent> m_events;
+
+        std::atomic<std::uint64_t> m_origin{kNoOrigin};
+        std::atomic<std::uint64_t> m_endFrame{0};
+        std::atomic<bool> m_finished{false};
+    };
+} // namespace dtracker::audio::playback
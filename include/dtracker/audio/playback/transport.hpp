@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace dtracker::audio::playback
+{
+    /// The engine's sample clock: a 64-bit count of frames rendered since
+    /// playback started, shared by every unit through the RenderContext.
+    ///
+    /// Musical positions are expressed as Time, a 32.32 fixed-point frame
+    /// count. A step length is rounded to the nearest 2^-32 frame once, and
+    /// step boundaries are then found by exact integer addition, so the
+    /// fractional part of every step carries into the next one and patterns
+    /// that share a tempo never drift apart, however long they play.
+    class Transport
+    {
+      public:
+        /// A position in frames with 32 fractional bits.
+        using Time = std::uint64_t;
+
+        static constexpr int kFractionBits = 32;
+
+        /// Converts a whole frame number to a Time.
+        static constexpr Time toTime(std::uint64_t frame)
+        {
+            return frame << kFractionBits;
+        }
+
+        /// Gets the first whole frame at or after the given Time.
+        static constexpr std::uint64_t frameAtOrAfter(Time time)
+        {
+            return (time + ((Time{1} << kFractionBits) - 1)) >> kFractionBits;
+        }
+
+        /// Gets the length of one step as a Time. Returns 0 if any argument
+        /// is not positive.
+        static Time stepLength(unsigned int sampleRate, float bpm,
+                               float stepsPerBeat);
+
+        /// Gets the frame at the start of the next block. Safe to call from
+        /// any thread.
+        std::uint64_t frame() const;
+
+        /// Moves the clock past a rendered block. Audio thread only.
+        void advance(unsigned int nFrames);
+
+        /// Rewinds the clock to frame 0.
+        void reset();
+
+      private:
+        std::atomic<std::uint64_t> m_frame{0};
+    };
+} // namespace dtracker::audio::playback
@@ -1,45 +1,151 @@
 #pragma once
 
 #include "sample_playback_unit.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
-#include <mutex>
-#include <vector>
 
 namespace dtracker::audio::playback
 {
-    /// A thread-safe object pool for recycling SamplePlaybackUnits.
+    class ReclaimQueue;
+
+    /// A lock-free object pool for recycling SamplePlaybackUnits.
     /// This avoids memory allocation on the real-time audio thread.
+    ///
+    /// Free units are kept on a Treiber stack of indices into a fixed array.
+    /// The head carries a tag that changes on every update, so a unit that
+    /// is popped and pushed back between another thread's read and its
+    /// compare-and-swap cannot corrupt the list (the ABA problem). Acquiring
+    /// and releasing never lock, allocate or make a system call.
     class UnitPool
     {
       public:
-        /// A shared_ptr that automatically returns its object to the pool
-        /// when its scope ends, thanks to a custom deleter.
-        using PooledUnitPtr = std::shared_ptr<SamplePlaybackUnit>;
+        /// Owns one unit checked out of the pool and returns it when it is
+        /// destroyed or reset. Move-only, and just two pointers: there is no
+        /// control block to allocate.
+        class Handle
+        {
+          public:
+            Handle() = default;
+            Handle(std::nullptr_t) {}
+
+            Handle(Handle &&other) noexcept;
+            Handle &operator=(Handle &&other) noexcept;
+            Handle(const Handle &) = delete;
+            Handle &operator=(const Handle &) = delete;
+
+            ~Handle();
+
+            /// Returns the unit to its pool now. Lock-free.
+            void reset();
+
+            SamplePlaybackUnit *get() const
+            {
+                return m_unit;
+            }
+
+            SamplePlaybackUnit *operator->() const
+            {
+                return m_unit;
+            }
+
+            SamplePlaybackUnit &operator*() const
+            {
+                return *m_unit;
+            }
+
+            explicit operator bool() const
+            {
+                return m_unit != nullptr;
+            }
+
+            friend bool operator==(const Handle &handle, std::nullptr_t)
+            {
+                return !handle;
+            }
+
+            friend bool operator!=(const Handle &handle, std::nullptr_t)
+            {
+                return static_cast<bool>(handle);
+            }
+
+          private:
+            friend class UnitPool;
+            Handle(UnitPool *pool, SamplePlaybackUnit *unit)
+                : m_pool(pool), m_unit(unit)
+            {
+            }
+
+            UnitPool *m_pool{nullptr};
+            SamplePlaybackUnit *m_unit{nullptr};
+        };
+
+        /// The handle voices are passed around in.
+        using PooledUnitPtr = Handle;
 
         /// Creates a pool with a fixed number of pre-allocated units.
         /// @param size The number of SamplePlaybackUnits to create up front.
         explicit UnitPool(size_t size);
 
-        /// Acquires a playback unit from the pool.
-        /// @return A smart pointer to a recycled unit, or nullptr if the pool
-        /// is exhausted.
+        virtual ~UnitPool() = default;
+
+        UnitPool(const UnitPool &) = delete;
+        UnitPool &operator=(const UnitPool &) = delete;
+
+        /// Acquires a playback unit from the pool. Lock-free.
+        /// @return A handle to a recycled unit, or an empty handle if the
+        /// pool is exhausted.
         virtual PooledUnitPtr acquire();
 
+        /// Gets the number of units the pool was created with.
+        size_t capacity() const;
+
+        /// Gets a counter that changes every time 'unit' goes back to the
+        /// pool, so a holder of a plain pointer can tell whether the unit
+        /// has been recycled since.
+        std::uint32_t generation(const SamplePlaybackUnit *unit) const;
+
+        /// Sets the queue that takes the samples of released units, so the
+        /// last reference to a PCM buffer is never dropped on the audio
+        /// thread. Without one, released units drop their samples in place.
+        /// Call before the pool is used.
+        void setReclaimQueue(ReclaimQueue *reclaim);
+
+        /// Calls 'visit' with each block of memory the pool owns, so it can
+        /// be locked into RAM. The blocks never move.
+        void forEachRegion(
+            const std::function<void(const void *, size_t)> &visit) const;
+
       private:
-        /// Returns a unit to the pool's free list.
-        /// This is called automatically by the PooledUnitPtr's custom deleter.
+        /// Marks the end of the free list.
+        static constexpr std::uint32_t kNil = ~std::uint32_t{0};
+
+        /// Returns a unit to the free list. Called by Handle.
         void release(SamplePlaybackUnit *unit);
 
-        /// A mutex to protect access to the free list from multiple threads.
-        std::mutex m_mutex;
+        /// Packs a free-list index with the tag that guards it against ABA.
+        static std::uint64_t pack(std::uint32_t tag, std::uint32_t index)
+        {
+            return (static_cast<std::uint64_t>(tag) << 32) | index;
+        }
 
         /// Holds the actual, pre-allocated object memory. These objects live
         /// for the entire lifetime of the pool.
-        std::vector<SamplePlaybackUnit> m_pool;
+        std::unique_ptr<SamplePlaybackUnit[]> m_pool;
+        size_t m_size{0};
+
+        /// For each unit, the index of the free unit below it on the stack.
+        std::unique_ptr<std::atomic<std::uint32_t>[]> m_next;
+
+        /// For each unit, how many times it has been released.
+        std::unique_ptr<std::atomic<std::uint32_t>[]> m_generations;
+
+        /// Where released units send their samples. Not owned.
+        ReclaimQueue *m_reclaim{nullptr};
 
-        /// A list of raw pointers to the objects in m_pool that are currently
-        /// available to be used.
-        std::vector<SamplePlaybackUnit *> m_freeList;
+        /// The tagged index of the unit on top of the free stack.
+        alignas(64) std::atomic<std::uint64_t> m_head{0};
     };
-} // namespace dtracker::audio::playback
\ No newline at end of file
+} // namespace dtracker::audio::playback
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dtracker::audio::playback
+{
+    /// Carries audio from the audio thread to any number of viewers without
+    /// locks, allocation or reference counts.
+    ///
+    /// The tap is a preallocated ring of fixed-size blocks. The audio thread
+    /// appends whatever it renders, a quantum at a time, and publishes each
+    /// block once it is full. Every block is guarded by a sequence number in
+    /// the style of a seqlock: odd while the block is being written, even
+    /// once it is complete. A Reader copies a block out and checks the
+    /// number afterwards, so it never blocks the writer and never sees a
+    /// torn block. The writer never waits either: a reader that falls more
+    /// than the ring behind skips to the oldest block still intact. Each
+    /// reader keeps its own place, so a scope, a meter and a recorder can
+    /// all follow one tap and each see every block.
+    ///
+    /// A tap can also decimate what it is given, keeping the loudest sample
+    /// of each channel out of every few frames. Scopes keep their peaks, and
+    /// a busy project sends far less data to the GUI.
+    class WaveformTap
+    {
+      public:
+        /// The default number of frames in one block.
+        static constexpr unsigned int kDefaultBlockFrames = 512;
+
+        /// The default number of blocks in the ring.
+        static constexpr size_t kDefaultBlocks = 32;
+
+        /// @param channels Interleaved channels per frame.
+        /// @param blockFrames Frames in one published block.
+        /// @param blocks Blocks the ring holds.
+        /// @param decimation Frames written per frame published. 1 keeps
+        /// every frame.
+        explicit WaveformTap(unsigned int channels = 2,
+                             unsigned int blockFrames = kDefaultBlockFrames,
+                             size_t blocks = kDefaultBlocks,
+                             unsigned int decimation = 1);
+
+        WaveformTap(const WaveformTap &) = delete;
+        WaveformTap &operator=(const WaveformTap &) = delete;
+
+        /// Appends rendered audio, publishing each block as it fills. Only
+        /// one thread may write. Audio with a different channel count than
+        /// the tap's is ignored.
+        void write(const float *samples, unsigned int frames,
+                   unsigned int channels);
+
+        /// Abandons the block being written, for a writer that could not
+        /// deliver some audio. The gap is counted once as a dropped block.
+        void discard();
+
+        /// One consumer of a tap, with its own place in the ring.
+        ///
+        /// Readers never write to the tap, so any number of them can follow
+        /// it without taking blocks from each other, and the audio thread
+        /// does the same work however many are attached. A reader that
+        /// falls behind skips ahead on its own. Each reader is used by one
+        /// thread at a time; a copy is a second reader at the same place.
+        class Reader
+        {
+          public:
+            /// A reader with no tap, which never has a block.
+            Reader() = default;
+
+            /// Starts at the next block the tap publishes. The reader keeps
+            /// the tap alive.
+            explicit Reader(std::shared_ptr<const WaveformTap> tap);
+
+            /// Copies the oldest block this reader has not seen into 'out',
+            /// resizing it to one block.
+            /// @return False if no complete block is waiting.
+            bool read(std::vector<float> &out);
+
+            /// Gets the number of blocks this reader missed by falling
+            /// behind.
+            std::uint64_t skippedBlocks() const;
+
+            /// Gets the tap being read, or nullptr.
+            const WaveformTap *tap() const;
+
+          private:
+            std::shared_ptr<const WaveformTap> m_tap;
+            std::uint64_t m_cursor{0};
+            std::uint64_t m_skipped{0};
+        };
+
+        unsigned int channels() const;
+        unsigned int blockFrames() const;
+        unsigned int decimation() const;
+
+        /// Gets the number of blocks in the ring.
+        size_t capacity() const;
+
+        /// Gets the number of blocks published so far.
+        std::uint64_t publishedBlocks() const;
+
+        /// Gets the number of blocks the writer abandoned.
+        std::uint64_t droppedBlocks() const;
+
+        /// Calls 'visit' with each block of memory the tap owns, so it can
+        /// be locked into RAM. The blocks never move.
+        void forEachRegion(
+            const std::function<void(const void *, size_t)> &visit) const;
+
+      private:
+        // Starts block 'block' in its slot, marking the slot as in progress.
+        void beginBlock(std::uint64_t block);
+
+        // Appends frames to the ring as they are, publishing full blocks.
+        void append(const float *samples, unsigned int frames);
+
+        // Copies block 'cursor' into 'out', or the next one still intact,
+        // and moves the cursor past it. Adds the blocks passed over to
+        // 'skipped'.
+        bool readFrom(std::uint64_t &cursor, std::vector<float> &out,
+                      std::uint64_t &skipped) const;
+
+        size_t blockSamples() const;
+
+        unsigned int m_channels;
+        unsigned int m_blockFrames;
+        size_t m_blocks;
+        unsigned int m_decimation;
+
+        // Every block's samples, back to back. Atomic so a reader can copy
+        // a block the writer is overwriting; the sequence check then throws
+        // the copy away.
+        std::unique_ptr<std::atomic<float>[]> m_samples;
+
+        // Per slot: 2n + 1 while block n is written, 2n + 2 once published.
+        std::unique_ptr<std::atomic<std::uint64_t>[]> m_sequences;
+
+        // Writer state, audio thread only.
+        std::uint64_t m_writeBlock{0};
+        unsigned int m_writeFrame{0};
+        bool m_discarding{false};
+
+        // The loudest sample per channel of the frames being decimated, and
+        // how many frames it covers so far.
+        std::unique_ptr<float[]> m_peaks;
+        unsigned int m_peakFrames{0};
+
+        alignas(64) std::atomic<std::uint64_t> m_published{0};
+        std::atomic<std::uint64_t> m_dropped{0};
+    };
+} // namespace dtracker::audio::playback
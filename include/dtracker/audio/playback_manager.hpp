@@ -1,12 +1,16 @@
 #pragma once
 
-#include <rigtorp/SPSCQueue.h>
-
 #include <dtracker/audio/i_engine.hpp>
 #include <dtracker/audio/i_playback_manager.hpp>
-#include <dtracker/audio/playback/buffer_pool.hpp>
+#include <dtracker/audio/playback/graph_builder.hpp>
+#include <dtracker/audio/playback/level_meter.hpp>
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <dtracker/audio/playback/sequenced_track_playback_unit.hpp>
+#include <dtracker/audio/playback/sequencer.hpp>
 #include <dtracker/audio/playback/track_playback_unit.hpp>
 #include <dtracker/audio/playback/unit_pool.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+#include <dtracker/audio/spectrum_analyzer.hpp>
 #include <dtracker/sample/i_manager.hpp>
 #include <dtracker/tracker/i_track_manager.hpp>
 #include <map>
@@ -23,6 +27,9 @@ namespace dtracker::audio
                                  sample::IManager *sampleManager,
                                  tracker::ITrackManager *trackManager);
 
+        /// Unregisters the memory it asked the engine to lock.
+        ~PlaybackManager() override;
+
         void
         playSample(std::unique_ptr<playback::SamplePlaybackUnit> unit) override;
 
@@ -32,7 +39,8 @@ namespace dtracker::audio
         /// Checks if any audio is currently being produced by the engine.
         bool isPlaying() const override;
 
-        /// Acquires a unit from the pool, reinitializes it, and plays it.
+        /// Acquires a voice under the polyphony limit, reinitializes it, and
+        /// plays it.
         void playSample(const sample::types::SampleDescriptor &descriptor);
 
         /// Builds and plays a single track by its ID, replacing any current
@@ -45,6 +53,12 @@ namespace dtracker::audio
         /// Builds and plays all registered tracks simultaneously.
         void playAllTracks() override;
 
+        /// Builds a private copy of every track's player and bounces it to the
+        /// sink using the offline renderer. Looping is ignored so the song
+        /// plays through exactly once.
+        bool renderAllTracks(render::IRenderSink &sink,
+                             size_t maxFrames) override;
+
         /// Returns the master looping state.
         bool loopPlayback() const;
 
@@ -54,40 +68,159 @@ namespace dtracker::audio
         /// Gets the master playback tempo.
         float bpm() const;
 
-        rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr> *
-        getWaveformQueueForTrack(int trackId);
+        /// Sets how live playback resamples samples recorded at another rate
+        /// than the engine's. Takes effect on the next audio block.
+        void setResampleQuality(dsp::ResampleQuality quality);
+        dsp::ResampleQuality resampleQuality() const;
+
+        /// Sets how renderAllTracks() resamples. Exports default to the sinc
+        /// filter, since nobody is waiting on each block.
+        void setExportResampleQuality(dsp::ResampleQuality quality);
+        dsp::ResampleQuality exportResampleQuality() const;
+
+        /// Changes the volume of a playing track on the next audio block.
+        /// Does nothing if the track is not currently playing.
+        void setTrackVolume(int trackId, float volume);
+
+        /// Changes the pan of a playing track on the next audio block.
+        /// Does nothing if the track is not currently playing.
+        void setTrackPan(int trackId, float pan);
+
+        /// Gets a new reader of a playing track's waveform tap, which sees
+        /// the track after its volume and pan. Every view takes its own
+        /// reader, and each sees every block from now on. The reader has no
+        /// tap if the track is not playing.
+        playback::WaveformTap::Reader getWaveformQueueForTrack(int trackId);
+
+        /// Gets the number of waveform blocks of a playing track the audio
+        /// thread had to drop. Blocks a view missed by falling behind are
+        /// counted by its reader.
+        std::uint64_t getWaveformDropCount(int trackId);
+
+        /// Sets how many frames of a track become one frame of its waveform
+        /// tap, keeping the peak of each. Applies from the next playback.
+        void setWaveformDecimation(unsigned int factor);
+
+        /// Gets the decimation applied to per-track waveform taps.
+        unsigned int waveformDecimation() const;
+
+        /// Gets a new reader of the tap fed with every block the mixer
+        /// renders.
+        playback::WaveformTap::Reader getMasterWaveformQueue();
 
-        rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr> *
-        getMasterWaveformQueue();
+        /// Gets the levels of a playing track after its volume and pan, as
+        /// of its last rendered block. Silent if the track is not playing.
+        /// Cheap enough to call for every visible track on every frame.
+        playback::LevelReading getTrackLevels(int trackId);
 
-        playback::BufferPool *getBufferPool() override;
+        /// Gets the levels of the master output.
+        playback::LevelReading getMasterLevels() const;
+
+        /// Gets the latest spectrum of a playing track, analyzed from its
+        /// waveform tap in the background. Empty if the track is not
+        /// playing.
+        SpectrumFrame getTrackSpectrum(int trackId) const;
+
+        /// Gets the latest spectrum of the master output.
+        SpectrumFrame getMasterSpectrum() const;
+
+        /// The track ID polyphony() counts previews from playSample() under.
+        static constexpr int kPreviewTrackId = -1;
+
+        /// Gets the manager that hands out voices to playing tracks and
+        /// previews. Set per-track voice limits and read steal counts
+        /// through it.
+        playback::PolyphonyManager &polyphony();
 
       private:
-        // Helper func to build track playback units
-        std::unique_ptr<playback::TrackPlaybackUnit> buildTrackPlayer(
-            int trackId, playback::BufferPool *bufferPool,
-            rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>
-                *waveformQueue);
+        // How many engine blocks ahead of the transport notes are scheduled.
+        static constexpr unsigned int kLookaheadBlocks = 4;
+
+        // Per-track taps keep one frame in four unless told otherwise.
+        static constexpr unsigned int kDefaultWaveformDecimation = 4;
+
+        // The spectrum analyzer's source ID for the master tap. Track IDs
+        // are never negative.
+        static constexpr int kMasterSpectrumId = -1;
+
+        // Create the waveform tap and level meter for a track about to
+        // play, and register them so the GUI can find them.
+        std::shared_ptr<playback::WaveformTap> createWaveformTap(int trackId);
+
+        // Create the full-rate tap the spectrum analyzer reads for a track
+        // about to play, and attach it.
+        std::shared_ptr<playback::WaveformTap> createSpectrumTap(int trackId);
+        std::shared_ptr<playback::LevelMeter> createLevelMeter(int trackId);
+
+        // Gathers the sample data for every step in a track's patterns.
+        playback::SampleBlueprint
+        buildBlueprint(const tracker::types::Track &track);
+
+        // Builds a player for a track whose notes come from a
+        // TrackSequencer acquiring voices through 'polyphony'. Nothing fills
+        // the sequencer yet.
+        std::unique_ptr<playback::SequencedTrackPlaybackUnit>
+        buildTrackPlayer(int trackId, playback::UnitPool *unitPool,
+                         playback::PolyphonyManager *polyphony);
+
+        // Builds a live track player whose notes are scheduled ahead of time
+        // by the lookahead sequencer.
+        std::unique_ptr<playback::SequencedTrackPlaybackUnit>
+        buildSequencedTrack(int trackId);
+
+        // Registers a built track player so parameters can reach it, and
+        // adds it to the graph as a source feeding 'bus'.
+        void addTrackPlayer(
+            playback::GraphBuilder &builder, playback::GraphBuilder::NodeId bus,
+            int trackId, std::shared_ptr<playback::PlaybackUnit> player);
+
+        // Compiles the graph for the engine's block size and hands it to
+        // the mixer.
+        void startGraph(const playback::GraphBuilder &builder,
+                        playback::GraphBuilder::NodeId output);
+
+        // Asks the engine to lock the sample data of a track about to play.
+        void lockSamples(const playback::SampleBlueprint &blueprint);
+
+        // Unlocks the sample data locked for the last playback.
+        void unlockSamples();
+
+        // Queues a parameter change for a playing track.
+        void setTrackParameter(int trackId, playback::UnitParam param,
+                               float value);
 
         // Playback statee
         std::atomic<float> m_bpm{120.0f}; // The master BPM value
         bool m_isLooping{true};           // The master looping state
+        std::atomic<dsp::ResampleQuality> m_exportResampleQuality{
+            dsp::ResampleQuality::Sinc};
 
-        /// A pool of reusable, fixed-size buffers for safely sending audio data
-        /// from the real-time thread to the GUI thread.
-        playback::BufferPool m_bufferPool;
-
-        /// A map that holds a thread-safe queue for each actively playing
-        /// track, keyed by the track's ID.
-        std::map<int, std::unique_ptr<rigtorp::SPSCQueue<
-                          playback::BufferPool::PooledBufferPtr>>>
-            m_waveformQueues;
+        /// A map that holds a waveform tap for each actively playing
+        /// track, keyed by the track's ID. Shared with the track players,
+        /// so a tap outlives a player still rendering after a stop.
+        std::map<int, std::shared_ptr<playback::WaveformTap>> m_waveformQueues;
         std::mutex m_waveformQueuesMutex;
+        std::atomic<unsigned int> m_waveformDecimation{
+            kDefaultWaveformDecimation};
+
+        /// The tap the mixer writes every rendered block into. Created once
+        /// and never replaced, so readers can hold on to it.
+        std::shared_ptr<playback::WaveformTap> m_masterWaveformTap;
 
-        std::unique_ptr<
-            rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>>
-            m_masterWaveFormQueue;
-        std::mutex m_masterWaveFormQueueMutex;
+        /// A level meter for each actively playing track, keyed by the
+        /// track's ID, and the meter on the master output.
+        std::map<int, std::shared_ptr<playback::LevelMeter>> m_levelMeters;
+        std::mutex m_levelMetersMutex;
+        std::unique_ptr<playback::LevelMeter> m_masterLevelMeter;
+
+        /// Analyzes the master tap and every track tap on its own thread.
+        /// Declared after the taps so it stops before they go.
+        SpectrumAnalyzer m_spectrumAnalyzer;
+
+        /// The track players in the playing graph, keyed by track ID. Weak,
+        /// so finished players can be dropped by the audio graph.
+        std::map<int, std::weak_ptr<playback::PlaybackUnit>> m_trackPlayers;
+        std::mutex m_trackPlayersMutex;
 
         // Dependencies
         IEngine *m_engine{nullptr};
@@ -97,5 +230,18 @@ namespace dtracker::audio
         // Unit pool lives here, passed to pattern playback units to recycle
         // sample playback units
         playback::UnitPool m_unitPool;
+
+        // Steals voices from m_unitPool when it runs out, rather than
+        // dropping notes.
+        playback::PolyphonyManager m_polyphony;
+
+        // The sample data locked for the current playback, held so it stays
+        // valid while registered with the engine.
+        std::vector<std::shared_ptr<const types::PCMData>> m_lockedSamples;
+        std::mutex m_lockedSamplesMutex;
+
+        // Keeps the playing tracks' note rings filled. Declared after the
+        // pool so it stops before the pool its voices come from is gone.
+        std::unique_ptr<playback::Sequencer> m_sequencer;
     };
 } // namespace dtracker::audio
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+
+namespace dtracker::audio::realtime
+{
+    /// How the engine prepares its audio thread and the memory it reads.
+    /// Every setting is best effort: a platform or a process without the
+    /// privilege for one simply leaves it off, and the report says so.
+    struct Options
+    {
+        /// Master switch. When false the engine leaves the audio thread
+        /// and memory exactly as the backend set them up.
+        bool enabled{false};
+
+        /// Flushes denormal floats to zero on the audio thread and the
+        /// render workers, so decaying tails do not fall onto the slow path.
+        bool flushDenormals{true};
+
+        /// The CPU core to pin the audio thread to, or -1 to leave it free.
+        int cpuCore{-1};
+
+        /// Raises the audio thread to the highest realtime priority.
+        bool raisePriority{true};
+
+        /// Locks the memory the audio thread reads (pools and sample data)
+        /// into RAM so it can never page-fault.
+        bool lockMemory{true};
+    };
+
+    /// Which settings actually took effect.
+    struct Report
+    {
+        /// True once the first callback has applied the thread settings.
+        bool applied{false};
+
+        bool denormalsFlushed{false};
+        bool pinned{false};
+        bool priorityRaised{false};
+
+        /// True if every registered memory region is locked.
+        bool memoryLocked{false};
+
+        /// The total size of the locked regions, in bytes.
+        size_t lockedBytes{0};
+
+        /// The render workers spawned for the stream, and how many of them
+        /// got realtime priority. Only those take part in rendering.
+        size_t renderWorkers{0};
+        size_t realtimeRenderWorkers{0};
+    };
+
+    /// Sets flush-to-zero and denormals-are-zero for the calling thread.
+    /// @return False if the CPU has no such mode.
+    bool flushDenormals();
+
+    /// Pins the calling thread to one CPU core.
+    /// @return False if the core is invalid or the OS refuses.
+    bool pinToCore(int core);
+
+    /// Raises the calling thread to realtime scheduling, one step below the
+    /// highest priority so the OS keeps room for its own audio threads.
+    /// @return False if the OS refuses, usually for lack of privileges.
+    bool raisePriority();
+
+    /// Locks a region of memory into RAM.
+    /// @return False if the OS refuses, usually because of a lock limit.
+    bool lockMemory(const void *data, size_t bytes);
+
+    /// Undoes lockMemory() for the same region.
+    void unlockMemory(const void *data, size_t bytes);
+} // namespace dtracker::audio::realtime
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
+#include <dtracker/audio/types.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace dtracker::audio::render
+{
+    /// Summarizes the outcome of an offline render.
+    struct OfflineRenderResult
+    {
+        size_t framesRendered{0};
+        // True if the graph reported finished before the frame limit.
+        bool finished{false};
+        // False if the sink failed to open, write or close.
+        bool ok{false};
+    };
+
+    /// Drives a PlaybackUnit graph without an audio device, pulling blocks as
+    /// fast as the CPU allows and handing them to a sink. The graph is
+    /// rendered exactly as the realtime callback would render it, so a bounce
+    /// matches what is heard during playback.
+    class OfflineRenderer
+    {
+      public:
+        /// @param settings The stream format to render in. bufferFrames is
+        /// used as the block size.
+        explicit OfflineRenderer(types::AudioSettings settings);
+
+        /// Renders the graph until it reports finished or maxFrames have been
+        /// produced, whichever comes first.
+        /// @param root The top of the graph, typically a MixerPlaybackUnit.
+        /// @param sink The destination for the rendered audio.
+        /// @param context Global playback state (BPM, looping) for the render.
+        /// If it carries no scratch arena, the renderer's own is used, and
+        /// without a sample rate, samples are resampled to the render's.
+        /// Its frame is the transport position the render starts from.
+        /// @param maxFrames Safety limit for graphs that never finish, such as
+        /// looping playback.
+        OfflineRenderResult render(playback::PlaybackUnit &root,
+                                   IRenderSink &sink,
+                                   const types::RenderContext &context,
+                                   size_t maxFrames);
+
+        const types::AudioSettings &settings() const;
+
+      private:
+        types::AudioSettings m_settings;
+
+        // The block buffer, allocated once per renderer.
+        std::vector<float> m_block;
+
+        // Scratch memory for the graph, sized for one block.
+        playback::ScratchArena m_scratch;
+    };
+} // namespace dtracker::audio::render
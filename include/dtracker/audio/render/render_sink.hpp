@@ -0,0 +1,54 @@
+#pragma once
+
+#include <dtracker/audio/types.hpp>
+#include <cstddef>
+
+namespace dtracker::audio::render
+{
+    /// Defines the destination for audio produced by an offline render.
+    /// A sink is opened once with the stream format, receives interleaved
+    /// blocks in order, and is closed when the render completes.
+    class IRenderSink
+    {
+      public:
+        virtual ~IRenderSink() = default;
+
+        /// Prepares the sink to receive audio in the given format.
+        /// @return True if the sink is ready to accept blocks.
+        virtual bool open(unsigned int sampleRate, unsigned int channels) = 0;
+
+        /// Appends a block of interleaved float samples.
+        /// @return False if the block could not be written.
+        virtual bool write(const float *buffer, unsigned int nFrames) = 0;
+
+        /// Finalizes the output. No further writes are accepted afterwards.
+        /// @return True if everything was flushed successfully.
+        virtual bool close() = 0;
+    };
+
+    /// A sink that collects the rendered audio into an in-memory buffer.
+    /// Useful for tests and for handing a bounce to further processing.
+    class MemoryRenderSink : public IRenderSink
+    {
+      public:
+        MemoryRenderSink() = default;
+
+        bool open(unsigned int sampleRate, unsigned int channels) override;
+        bool write(const float *buffer, unsigned int nFrames) override;
+        bool close() override;
+
+        /// Gets the interleaved samples written so far.
+        const types::PCMData &data() const;
+
+        /// Returns the number of frames written so far.
+        size_t frames() const;
+
+        unsigned int sampleRate() const;
+        unsigned int channels() const;
+
+      private:
+        types::PCMData m_data;
+        unsigned int m_sampleRate{0};
+        unsigned int m_channels{0};
+    };
+} // namespace dtracker::audio::render
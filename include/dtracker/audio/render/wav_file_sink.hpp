@@ -0,0 +1,59 @@
+#pragma once
+
+#include <dtracker/audio/render/render_sink.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dtracker::audio::render
+{
+    /// The on-disk sample encoding used by WavFileSink.
+    enum class WavSampleFormat
+    {
+        Float32, // IEEE float, lossless for the engine's internal format
+        Int16    // 16-bit PCM, clamped to [-1.0, 1.0] before conversion
+    };
+
+    /// A sink that streams rendered audio straight to a RIFF/WAVE file.
+    /// The header is written with placeholder sizes on open() and patched
+    /// on close(), so arbitrarily long renders never sit in memory. WAV sizes
+    /// are 32-bit, so write() fails once the data would pass 4 GiB.
+    class WavFileSink : public IRenderSink
+    {
+      public:
+        explicit WavFileSink(std::string path,
+                             WavSampleFormat format = WavSampleFormat::Float32);
+        ~WavFileSink() override;
+
+        bool open(unsigned int sampleRate, unsigned int channels) override;
+        bool write(const float *buffer, unsigned int nFrames) override;
+        bool close() override;
+
+        /// Returns the number of frames written so far.
+        size_t frames() const;
+
+      private:
+        // Writes the RIFF header using the current data size.
+        void writeHeader();
+
+        // The layout of the chosen format.
+        std::uint16_t bitsPerSample() const;
+        std::uint16_t blockAlign() const;
+        std::uint32_t headerSize() const;
+
+        std::string m_path;
+        WavSampleFormat m_format;
+        std::ofstream m_file;
+
+        unsigned int m_sampleRate{0};
+        unsigned int m_channels{0};
+        size_t m_framesWritten{0};
+
+        // Reused between writes to hold the encoded little-endian bytes.
+        std::vector<std::uint8_t> m_encodeBuffer;
+
+        // Reused between writes to hold the 16-bit samples before encoding.
+        std::vector<std::int16_t> m_int16Buffer;
+    };
+} // namespace dtracker::audio::render
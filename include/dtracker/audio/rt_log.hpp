@@ -0,0 +1,143 @@
+#pragma once
+
+#include <dtracker/audio/playback/mpsc_queue.hpp>
+#include <dtracker/audio/types.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace dtracker::audio
+{
+    enum class LogLevel : std::uint8_t
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    /// One log entry as the audio thread writes it. Nothing in it owns
+    /// memory: 'source' and 'message' must be string literals, and the
+    /// numbers are only turned into text when the record is flushed.
+    struct LogRecord
+    {
+        static constexpr size_t kMaxArgs = 2;
+
+        LogLevel level{LogLevel::Info};
+
+        /// The component that wrote the record, e.g. "MixerPlaybackUnit".
+        const char *source{nullptr};
+
+        /// The message. Each "{}" is replaced by the next argument.
+        const char *message{nullptr};
+
+        /// The transport frame the record was written at.
+        std::uint64_t frame{0};
+
+        std::array<std::int64_t, kMaxArgs> args{};
+        std::uint8_t argCount{0};
+    };
+
+    /// A log the audio thread can write to. write() copies a fixed-size
+    /// record into a preallocated lock-free ring without formatting,
+    /// allocating or taking a lock; a background flusher thread turns the
+    /// records into text and writes them out.
+    class RtLog
+    {
+      public:
+        /// The default number of records that can wait for the flusher.
+        static constexpr size_t kDefaultCapacity = 1024;
+
+        /// Creates the log. The flusher is not started.
+        explicit RtLog(size_t capacity = kDefaultCapacity);
+
+        /// Stops the flusher and writes out everything still queued.
+        ~RtLog();
+
+        RtLog(const RtLog &) = delete;
+        RtLog &operator=(const RtLog &) = delete;
+
+        /// Queues a record. Lock-free and allocation-free; safe to call
+        /// from any number of audio threads.
+        /// @return False if the record was filtered out or the ring was
+        /// full. Full rings count a drop.
+        template <typename... Args>
+        bool write(LogLevel level, const char *source, const char *message,
+                   std::uint64_t frame, Args... args)
+        {
+            static_assert(sizeof...(Args) <= LogRecord::kMaxArgs,
+                          "Too many log arguments");
+
+            LogRecord record;
+            record.level = level;
+            record.source = source;
+            record.message = message;
+            record.frame = frame;
+            record.args = {static_cast<std::int64_t>(args)...};
+            record.argCount = static_cast<std::uint8_t>(sizeof...(Args));
+            return push(record);
+        }
+
+        /// Drops records below 'level' at write(). Safe from any thread.
+        void setLevel(LogLevel level);
+        LogLevel level() const;
+
+        /// Formats and writes every queued record. Warnings and errors go
+        /// to 'errors', the rest to 'out'. Must not be called concurrently
+        /// with the flusher.
+        /// @return The number of records written.
+        size_t flush(std::ostream &out, std::ostream &errors);
+        size_t flush(std::ostream &out);
+
+        /// Starts a background thread that flushes to std::cout and
+        /// std::cerr periodically.
+        void startFlusher(std::chrono::milliseconds interval =
+                              std::chrono::milliseconds(20));
+
+        /// Stops the background thread after a final flush.
+        void stopFlusher();
+
+        /// Returns how many records were lost to a full ring.
+        size_t droppedCount() const;
+
+        /// Turns a record into a line of text, without the newline.
+        static std::string format(const LogRecord &record);
+
+      private:
+        // Copies the record into the ring or counts a drop.
+        bool push(LogRecord &record);
+
+        // The flusher thread loop.
+        void run(std::chrono::milliseconds interval);
+
+        playback::MpscQueue<LogRecord> m_queue;
+        std::atomic<LogLevel> m_level{LogLevel::Info};
+
+        std::atomic<size_t> m_dropped{0};
+        size_t m_reportedDrops{0}; // Drops already written out by flush()
+
+        std::thread m_flusher;
+        std::mutex m_flusherMutex; // Guards m_stopRequested for the wait
+        std::condition_variable m_flusherWake;
+        bool m_stopRequested{false};
+    };
+
+    /// Writes a record stamped with the block's frame through the context's
+    /// log. Does nothing when the graph is rendered without one.
+    template <typename... Args>
+    inline void rtLog(const types::RenderContext &context, LogLevel level,
+                      const char *source, const char *message, Args... args)
+    {
+        if (context.log)
+            context.log->write(level, source, message, context.frame,
+                               args...);
+    }
+} // namespace dtracker::audio
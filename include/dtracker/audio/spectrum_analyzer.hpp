@@ -0,0 +1,152 @@
+#pragma once
+
+#include <dtracker/audio/dsp/fft.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dtracker::audio
+{
+    /// A copy of one source's spectrum, ready to draw.
+    struct SpectrumFrame
+    {
+        /// Levels in dB, one per band from low to high. 0 dB is a full-scale
+        /// sine; nothing reads below SpectrumAnalyzer::kFloorDb. Empty until
+        /// the source has been analyzed once.
+        std::vector<float> bands;
+
+        /// The frequencies, in Hz, where the first band starts and the last
+        /// one ends. The bands split the range evenly on a log scale.
+        float minFrequency{0.0f};
+        float maxFrequency{0.0f};
+
+        /// Windows analyzed since the source was attached.
+        std::uint64_t frames{0};
+    };
+
+    /// Turns the audio of waveform taps into spectra on its own thread, so
+    /// every view shares one FFT per source instead of running its own on
+    /// the GUI thread.
+    ///
+    /// Each source follows its tap with its own reader, so the views reading
+    /// the same tap still see every block. The audio is mixed down to mono
+    /// and analyzed in Hann-windowed frames overlapping by three quarters.
+    /// The magnitudes are gathered into log-spaced bands, which jump up at
+    /// once and fall back at kFallDbPerSecond, and published per source
+    /// under a lock.
+    class SpectrumAnalyzer
+    {
+      public:
+        /// The default samples per analysis window.
+        static constexpr size_t kDefaultFftSize = 2048;
+
+        /// The default number of bands in a frame.
+        static constexpr size_t kDefaultBands = 64;
+
+        /// The lowest frequency shown, in Hz.
+        static constexpr float kMinFrequency = 20.0f;
+
+        /// The level reported for silence.
+        static constexpr float kFloorDb = -120.0f;
+
+        /// How fast a band falls once its level drops.
+        static constexpr float kFallDbPerSecond = 60.0f;
+
+        /// @param sampleRate The rate of the audio written to the taps.
+        /// @param fftSize Samples per window. Must be a power of two of at
+        /// least 4.
+        /// @param bands Bands per frame, at least 1.
+        /// @throws std::invalid_argument for a bad size or band count.
+        explicit SpectrumAnalyzer(unsigned int sampleRate = 44100,
+                                  size_t fftSize = kDefaultFftSize,
+                                  size_t bands = kDefaultBands);
+
+        /// Stops the worker thread.
+        ~SpectrumAnalyzer();
+
+        SpectrumAnalyzer(const SpectrumAnalyzer &) = delete;
+        SpectrumAnalyzer &operator=(const SpectrumAnalyzer &) = delete;
+
+        /// Starts analyzing a tap from the next block it publishes, replacing
+        /// any source with the same ID. Give it a full-rate tap: a decimating
+        /// tap keeps peaks rather than filtering, so everything above its
+        /// reduced Nyquist frequency folds into the lower bands.
+        void attach(int sourceId, std::shared_ptr<playback::WaveformTap> tap);
+
+        /// Stops analyzing a source and forgets its spectrum.
+        void detach(int sourceId);
+
+        /// Gets the latest spectrum of a source. Safe to call from any
+        /// thread; empty if the source is not attached.
+        SpectrumFrame spectrum(int sourceId) const;
+
+        /// Analyzes everything the attached taps have published since the
+        /// last call. Must not be called concurrently with the worker.
+        /// @return The number of windows analyzed.
+        size_t analyze();
+
+        /// Starts a background thread that calls analyze() periodically.
+        void start(std::chrono::milliseconds interval =
+                       std::chrono::milliseconds(15));
+
+        /// Stops the background thread.
+        void stop();
+
+      private:
+        // One attached tap and the analysis state that follows it.
+        struct Source
+        {
+            playback::WaveformTap::Reader reader;
+            std::uint64_t skipped{0}; // Skips already handled
+
+            // Mono samples waiting to fill a window.
+            std::vector<float> pending;
+
+            // The first and last FFT bin of each band, and the band levels
+            // as they fall.
+            std::vector<std::pair<size_t, size_t>> bandBins;
+            std::vector<float> levels;
+            float fallPerWindow{0.0f};
+
+            // The published copy.
+            mutable std::mutex frameMutex;
+            SpectrumFrame frame;
+        };
+
+        // Reads a source's new blocks and analyzes every full window.
+        size_t analyzeSource(Source &source);
+
+        // Works out where a source's bands start and end.
+        void layoutBands(Source &source) const;
+
+        // The worker thread loop.
+        void run(std::chrono::milliseconds interval);
+
+        unsigned int m_sampleRate;
+        size_t m_bandCount;
+        size_t m_hop;
+
+        // Analysis state, only touched by analyze().
+        dsp::RealFft m_fft;
+        std::vector<float> m_window;
+        std::vector<float> m_windowed;
+        std::vector<float> m_magnitudes;
+        std::vector<float> m_block;
+
+        std::map<int, std::shared_ptr<Source>> m_sources;
+        mutable std::mutex m_sourcesMutex;
+
+        std::thread m_worker;
+        std::mutex m_workerMutex; // Guards m_stopRequested for the wait
+        std::condition_variable m_workerWake;
+        bool m_stopRequested{false};
+    };
+} // namespace dtracker::audio
@@ -1,6 +1,21 @@
 #pragma once
+#include <cstdint>
+#include <dtracker/audio/dsp/resampler.hpp>
 #include <vector>
 
+namespace dtracker::audio
+{
+    class PerformanceMonitor;
+    class RtLog;
+}
+
+namespace dtracker::audio::playback
+{
+    class ReclaimQueue;
+    class RenderWorkerPool;
+    class ScratchArena;
+}
+
 namespace dtracker::audio::types
 {
     using PCMData = std::vector<float>;
@@ -25,5 +40,36 @@ namespace dtracker::audio::types
     {
         bool isLooping{false};
         float bpm{120.0f};
+
+        // The transport's sample clock at the first frame of the buffer.
+        // Units that split a buffer pass the sub-block's own frame down.
+        std::uint64_t frame{0};
+
+        // The rate the block plays at. Samples recorded at another rate are
+        // resampled to it; 0 plays every sample at its own rate.
+        unsigned int sampleRate{0};
+
+        // How samples are read between their frames when resampled.
+        dsp::ResampleQuality resampleQuality{dsp::ResampleQuality::Cubic};
+
+        // Where units hand objects they no longer need, so they are not
+        // destroyed on the audio thread. Null means release in place.
+        playback::ReclaimQueue *reclaim{nullptr};
+
+        // Temporary buffers for the block, borrowed with a
+        // ScratchArena::Frame. Null means units use their own fallback.
+        playback::ScratchArena *scratch{nullptr};
+
+        // Threads a mixer may spread its children across. Null means
+        // render them one after another on the calling thread.
+        playback::RenderWorkerPool *workers{nullptr};
+
+        // Where units that own voices report how many are sounding. Null
+        // means nobody is counting.
+        PerformanceMonitor *monitor{nullptr};
+
+        // Where the render path writes log records instead of printing.
+        // Null means the records are dropped.
+        RtLog *log{nullptr};
     };
 } // namespace dtracker::audio::types
\ No newline at end of file
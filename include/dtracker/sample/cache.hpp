@@ -21,10 +21,29 @@ namespace dtracker::sample
         explicit Cache(size_t capacity);
 
         // Inserts or updates an entry. Marks the item as most recently used.
+        // Updating drops the entry's variants, which were made from the old
+        // data.
         bool insert(const std::string &key,
                     std::shared_ptr<const audio::types::PCMData> data,
                     audio::types::AudioProperties properties);
 
+        // Stores a copy of an entry's data converted to 'sampleRate'. The
+        // variant lives and is evicted with its entry. Fails if the entry
+        // is gone or its data is no longer 'source'.
+        bool insertVariant(const std::string &key, unsigned int sampleRate,
+                           std::shared_ptr<const audio::types::PCMData> data,
+                           const std::shared_ptr<const audio::types::PCMData>
+                               &source);
+
+        // Retrieves an entry's variant for 'sampleRate', or null if it has
+        // none yet. Marks the entry as most recently used.
+        std::shared_ptr<const audio::types::PCMData>
+        getVariant(const std::string &key, unsigned int sampleRate);
+
+        // Drops every entry's variants for rates other than 'sampleRate'.
+        // Entries themselves and their LRU order are kept.
+        void retainVariants(unsigned int sampleRate);
+
         // Retrieves an entry and marks it as most recently used.
         std::shared_ptr<const audio::types::PCMData>
         get(const std::string &key);
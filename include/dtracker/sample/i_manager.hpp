@@ -42,5 +42,9 @@ namespace dtracker::sample
         // list.
         virtual std::optional<types::CacheEntry>
         peekCache(const std::string &path) = 0;
+
+        // Sets the rate samples are played at, so they can be converted to
+        // it ahead of time. 0 leaves samples at their own rate.
+        virtual void setTargetSampleRate(unsigned int sampleRate) = 0;
     };
 } // namespace dtracker::sample
\ No newline at end of file
@@ -1,22 +1,33 @@
 #pragma once
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <dtracker/audio/types.hpp>
 #include <dtracker/sample/cache.hpp>
 #include <dtracker/sample/i_manager.hpp>
 #include <dtracker/sample/types.hpp>
 #include <mutex>
 #include <optional>
+#include <set>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 
 namespace dtracker::sample
 {
     // Manages the sample workflow, including a temporary data cache and a
     // permanent registry of sample instances. This class is thread-safe.
+    //
+    // Given a target sample rate, it also converts cached samples recorded
+    // at other rates on a background thread, and hands out the converted
+    // copy once it is ready, so voices can play it as a straight copy.
     class Manager : public IManager
     {
       public:
         Manager() = default;
-        ~Manager() = default;
+
+        // Stops the conversion thread. Conversions still queued are dropped.
+        ~Manager();
 
         // Caches raw PCM data, returning a shared handle to the cached data.
         std::shared_ptr<const audio::types::PCMData>
@@ -51,7 +62,47 @@ namespace dtracker::sample
         std::optional<types::CacheEntry>
         peekCache(const std::string &path) override;
 
+        // Sets the rate samples are converted to. Samples cached from now
+        // on are queued for conversion at once; samples already cached are
+        // queued the first time getSample() hands them out, and play at
+        // their own rate until their copy is ready. Copies converted for
+        // other rates are dropped.
+        void setTargetSampleRate(unsigned int sampleRate) override;
+
+        // Returns the rate samples are converted to, or 0 if none.
+        unsigned int targetSampleRate() const;
+
+        // Blocks until every queued conversion has been stored.
+        void waitForConversions();
+
       private:
+        // One sample waiting to be converted.
+        struct ConversionJob
+        {
+            std::string key;
+            std::shared_ptr<const audio::types::PCMData> source;
+            unsigned int sourceRate;
+            unsigned int targetRate;
+        };
+
+        // Queues a conversion of 'source' if the target rate calls for one
+        // and none is queued already.
+        void
+        queueConversion(const std::string &key,
+                        std::shared_ptr<const audio::types::PCMData> source,
+                        unsigned int sourceRate);
+
+        // The conversion thread loop.
+        void runConversions();
+
+        // Converts interleaved stereo to another rate with the sinc filter.
+        static std::shared_ptr<const audio::types::PCMData>
+        convert(const audio::types::PCMData &source, unsigned int sourceRate,
+                unsigned int targetRate);
+
+        // The rate samples are converted to, or 0 for none.
+        std::atomic<unsigned int> m_targetSampleRate{0};
+
         // Protects access to the sample registry.
         mutable std::shared_mutex m_registryMutex;
 
@@ -62,5 +113,17 @@ namespace dtracker::sample
 
         // Permanent registry of sample instances.
         std::unordered_map<int, types::SampleEntry> m_sampleRegistry;
+
+        // Conversions waiting for the thread, and the (path, rate) pairs
+        // queued or in progress, so none is converted twice at once.
+        std::deque<ConversionJob> m_conversions;
+        std::set<std::pair<std::string, unsigned int>> m_pendingConversions;
+        std::mutex m_conversionMutex;
+        std::condition_variable m_conversionWake;
+        std::condition_variable m_conversionDone;
+        bool m_stopRequested{false};
+
+        // Started by the first conversion queued.
+        std::thread m_converter;
     };
 } // namespace dtracker::sample
\ No newline at end of file
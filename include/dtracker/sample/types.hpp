@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <dtracker/audio/types.hpp>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -13,15 +14,20 @@ namespace dtracker::sample::types
         std::shared_ptr<const audio::types::PCMData> data;
         audio::types::AudioProperties properties;
         std::list<std::string>::iterator useIt;
+
+        // Copies of 'data' converted to other sample rates, keyed by rate.
+        std::map<unsigned int, std::shared_ptr<const audio::types::PCMData>>
+            variants;
     };
 
     struct SampleMetadata
     {
         // The original sample rate of the audio file (e.g., 44100, 48000).
-        unsigned int sourceSampleRate;
+        // 0 if unknown, in which case the sample plays at the engine's rate.
+        unsigned int sourceSampleRate{0};
 
         // The original bit depth (e.g., 16, 24).
-        unsigned int bitDepth;
+        unsigned int bitDepth{0};
     };
 
     class SampleDescriptor
@@ -16,7 +16,6 @@ namespace dtracker::tracker::types
         // e.g., 4 = 16th notes, 8 = 32nd notes.
         float stepsPerBeat = 4.0f;
 
-        float elapsedMs = 0.0f;
         size_t currentStep = 0;
     };
 
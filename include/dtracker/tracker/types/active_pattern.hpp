@@ -5,6 +5,5 @@ struct ActivePattern
 {
     std::vector<int> steps;
     float stepIntervalMs;
-    float elapsedMs = 0.0f;
     size_t currentStep = 0;
 };
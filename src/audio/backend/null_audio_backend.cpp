@@ -0,0 +1,172 @@
+#include <chrono>
+#include <dtracker/audio/backend/null_audio_backend.hpp>
+#include <iostream>
+
+namespace dtracker::audio::backend
+{
+    NullAudioBackend::NullAudioBackend(Mode mode) : m_mode(mode) {}
+
+    NullAudioBackend::~NullAudioBackend()
+    {
+        closeStream();
+    }
+
+    void NullAudioBackend::setBlockFrames(unsigned int frames)
+    {
+        m_blockFramesOverride = frames;
+    }
+
+    void NullAudioBackend::setBlockLimit(size_t blocks)
+    {
+        m_blockLimit = blocks;
+    }
+
+    void NullAudioBackend::setSink(render::IRenderSink *sink)
+    {
+        m_sink = sink;
+    }
+
+    size_t NullAudioBackend::blocksProcessed() const
+    {
+        return m_blocksProcessed.load(std::memory_order_relaxed);
+    }
+
+    size_t NullAudioBackend::missedDeadlines() const
+    {
+        return m_missedDeadlines.load(std::memory_order_relaxed);
+    }
+
+    // No device to negotiate with; just allocate the block buffer.
+    bool NullAudioBackend::openStream(std::optional<unsigned int> /*deviceId*/,
+                                      types::AudioSettings &settings,
+                                      RenderCallback callback, void *userData)
+    {
+        if (!callback || m_isOpen)
+            return false;
+
+        if (m_blockFramesOverride > 0)
+            settings.bufferFrames = m_blockFramesOverride;
+        if (settings.bufferFrames == 0 || settings.outputChannels == 0)
+            return false;
+
+        m_callback = callback;
+        m_userData = userData;
+        m_settings = settings;
+        m_buffer.assign(static_cast<size_t>(settings.bufferFrames) *
+                            settings.outputChannels,
+                        0.0f);
+        m_blocksProcessed = 0;
+        m_missedDeadlines = 0;
+        m_isOpen = true;
+        return true;
+    }
+
+    bool NullAudioBackend::startStream()
+    {
+        if (!m_isOpen || m_running.load())
+            return false;
+
+        // The thread may have exited on its own after a block limit.
+        stopStream();
+
+        if (m_sink &&
+            !m_sink->open(m_settings.sampleRate, m_settings.outputChannels))
+        {
+            std::cerr << "NullAudioBackend: Failed to open sink\n";
+            return false;
+        }
+
+        m_running = true;
+        m_thread = std::thread(&NullAudioBackend::run, this);
+        return true;
+    }
+
+    void NullAudioBackend::stopStream()
+    {
+        m_running = false;
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+            if (m_sink)
+                m_sink->close();
+        }
+    }
+
+    void NullAudioBackend::closeStream()
+    {
+        stopStream();
+        m_isOpen = false;
+    }
+
+    bool NullAudioBackend::isStreamOpen() const
+    {
+        return m_isOpen;
+    }
+
+    bool NullAudioBackend::isStreamRunning() const
+    {
+        return m_running.load();
+    }
+
+    bool NullAudioBackend::requiresDevice() const
+    {
+        return false;
+    }
+
+    // There are no devices to enumerate.
+    DeviceManager NullAudioBackend::createDeviceManager() const
+    {
+        return DeviceManager(nullptr);
+    }
+
+    // Pulls blocks until stopped. In realtime mode each block has a fixed
+    // deadline on the steady clock; a callback that overruns it is reported
+    // to the next callback as an xrun, just like a device underflow.
+    void NullAudioBackend::run()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const unsigned int nFrames = m_settings.bufferFrames;
+        const unsigned int channels = m_settings.outputChannels;
+        const auto blockDuration =
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(
+                    static_cast<double>(nFrames) / m_settings.sampleRate));
+
+        auto deadline = Clock::now() + blockDuration;
+        bool xrun = false;
+        size_t blocks = 0;
+
+        while (m_running.load(std::memory_order_relaxed))
+        {
+            m_callback(m_buffer.data(), nFrames, channels, xrun,
+                       m_userData);
+            xrun = false;
+
+            if (m_sink)
+                m_sink->write(m_buffer.data(), nFrames);
+
+            m_blocksProcessed.fetch_add(1, std::memory_order_relaxed);
+            if (m_blockLimit > 0 && ++blocks >= m_blockLimit)
+                break;
+
+            if (m_mode == Mode::Realtime)
+            {
+                if (Clock::now() > deadline)
+                {
+                    // We are late; skip ahead rather than trying to catch up.
+                    m_missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+                    xrun = true;
+                    deadline = Clock::now();
+                }
+                else
+                {
+                    std::this_thread::sleep_until(deadline);
+                }
+                deadline += blockDuration;
+            }
+        }
+
+        m_running = false;
+    }
+} // namespace dtracker::audio::backend
@@ -0,0 +1,125 @@
+#include <dtracker/audio/backend/rtaudio_backend.hpp>
+#include <iostream>
+
+namespace dtracker::audio::backend
+{
+    // Creates the RtAudio instance and routes its errors to stderr.
+    RtAudioBackend::RtAudioBackend() : m_audio(std::make_unique<RtAudio>())
+    {
+        m_audio->setErrorCallback(
+            [](RtAudioErrorType type, const std::string &errorText)
+            {
+                std::cerr << "[RtAudio Error] (" << static_cast<int>(type)
+                          << "): " << errorText << "\n";
+            });
+    }
+
+    RtAudioBackend::~RtAudioBackend()
+    {
+        closeStream();
+    }
+
+    // RtAudio callback that forwards the block to the engine's callback.
+    // It runs on RtAudio's high-priority, real-time audio thread.
+    int RtAudioBackend::rtAudioCallback(void *outputBuffer,
+                                        void * /*inputBuffer*/,
+                                        unsigned int nFrames,
+                                        double /*streamTime*/,
+                                        RtAudioStreamStatus status,
+                                        void *userData)
+    {
+        auto *self = static_cast<RtAudioBackend *>(userData);
+        self->m_callback(static_cast<float *>(outputBuffer), nFrames,
+                         self->m_channels, status != 0, self->m_userData);
+        return 0; // Continues stream
+    }
+
+    // Configures and opens the RtAudio stream.
+    bool RtAudioBackend::openStream(std::optional<unsigned int> deviceId,
+                                    types::AudioSettings &settings,
+                                    RenderCallback callback, void *userData)
+    {
+        if (!deviceId.has_value() || !callback)
+            return false;
+
+        m_callback = callback;
+        m_userData = userData;
+        m_channels = settings.outputChannels;
+
+        RtAudio::StreamParameters outputParams;
+        outputParams.deviceId = *deviceId;
+        outputParams.nChannels = settings.outputChannels;
+        outputParams.firstChannel = 0;
+
+        // Bind the C-style callback to this backend by passing it as the
+        // userdata argument. RtAudio may adjust bufferFrames.
+        auto err = m_audio->openStream(
+            &outputParams, nullptr, RTAUDIO_FLOAT32, settings.sampleRate,
+            &settings.bufferFrames, &RtAudioBackend::rtAudioCallback, this);
+
+        if (err != RTAUDIO_NO_ERROR)
+        {
+            std::cerr << "RtAudioBackend: Failed to open stream: "
+                      << m_audio->getErrorText() << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool RtAudioBackend::startStream()
+    {
+        auto err = m_audio->startStream();
+        if (err != RTAUDIO_NO_ERROR)
+        {
+            std::cerr << "RtAudioBackend: Failed to start stream: "
+                      << m_audio->getErrorText() << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    void RtAudioBackend::stopStream()
+    {
+        if (!m_audio->isStreamRunning())
+            return;
+
+        auto err = m_audio->stopStream();
+        if (err != RTAUDIO_NO_ERROR)
+        {
+            std::cerr << "RtAudioBackend: Failed to stop stream ("
+                      << static_cast<int>(err)
+                      << "): " << m_audio->getErrorText() << "\n";
+        }
+    }
+
+    void RtAudioBackend::closeStream()
+    {
+        stopStream();
+
+        if (m_audio->isStreamOpen())
+            m_audio->closeStream(); // No return value; errors go through the
+                                    // error callback
+    }
+
+    bool RtAudioBackend::isStreamOpen() const
+    {
+        return m_audio->isStreamOpen();
+    }
+
+    bool RtAudioBackend::isStreamRunning() const
+    {
+        return m_audio->isStreamRunning();
+    }
+
+    bool RtAudioBackend::requiresDevice() const
+    {
+        return true;
+    }
+
+    // Creates a device manager with a reference to the internal RtAudio
+    // instance.
+    DeviceManager RtAudioBackend::createDeviceManager() const
+    {
+        return DeviceManager(m_audio.get());
+    }
+} // namespace dtracker::audio::backend
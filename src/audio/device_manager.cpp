@@ -60,6 +60,10 @@ namespace dtracker::audio
     // Attempts to find the first output-capable device
     std::optional<unsigned int> DeviceManager::findUsableOutputDevice()
     {
+        // A backend without devices (e.g. the null driver) has none to find
+        if (!m_audio)
+            return std::nullopt;
+
         // Get all available device IDs
         std::vector<unsigned int> ids = m_audio->getDeviceIds();
 
@@ -82,6 +86,11 @@ namespace dtracker::audio
     // Returns device information for a specific device ID
     RtAudio::DeviceInfo DeviceManager::getDeviceInfo(unsigned int id) const
     {
+        // Without an RtAudio instance there is no such device; report one
+        // with no channels
+        if (!m_audio)
+            return RtAudio::DeviceInfo{};
+
         return m_audio->getDeviceInfo(id);
     }
 
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/dsp/fft.hpp>
+#include <stdexcept>
+
+namespace dtracker::audio::dsp
+{
+    RealFft::RealFft(size_t size) : m_size(size)
+    {
+        if (size < 4 || (size & (size - 1)) != 0)
+            throw std::invalid_argument(
+                "RealFft size must be a power of two of at least 4");
+
+        const size_t half = size / 2;
+        m_real.resize(half);
+        m_imag.resize(half);
+        m_workReal.resize(half);
+        m_workImag.resize(half);
+        m_binReal.resize(bins());
+        m_binImag.resize(bins());
+
+        // Twiddles are worked out in double so the error does not grow with
+        // the index.
+        constexpr double kPi = 3.14159265358979323846;
+        m_twiddleReal.resize(half / 2);
+        m_twiddleImag.resize(half / 2);
+        for (size_t k = 0; k < half / 2; ++k)
+        {
+            const double angle = -2.0 * kPi * k / half;
+            m_twiddleReal[k] = static_cast<float>(std::cos(angle));
+            m_twiddleImag[k] = static_cast<float>(std::sin(angle));
+        }
+
+        m_splitReal.resize(half + 1);
+        m_splitImag.resize(half + 1);
+        for (size_t k = 0; k <= half; ++k)
+        {
+            const double angle = -2.0 * kPi * k / size;
+            m_splitReal[k] = static_cast<float>(std::cos(angle));
+            m_splitImag[k] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    // Each pass splits every sequence of 'length' points in two, reading
+    // from one pair of buffers and writing the other. 'stride' sequences
+    // are interleaved, so the inner loop runs over 'stride' neighbouring
+    // points with one twiddle: short at first, but by then the outer loop
+    // is long, and the later passes are wide.
+    void RealFft::transformHalf()
+    {
+        const size_t points = m_size / 2;
+        float *inReal = m_real.data();
+        float *inImag = m_imag.data();
+        float *outReal = m_workReal.data();
+        float *outImag = m_workImag.data();
+
+        for (size_t length = points, stride = 1; length > 1;
+             length /= 2, stride *= 2)
+        {
+            const size_t half = length / 2;
+            for (size_t p = 0; p < half; ++p)
+            {
+                const float wr = m_twiddleReal[p * stride];
+                const float wi = m_twiddleImag[p * stride];
+                const float *aReal = inReal + stride * p;
+                const float *aImag = inImag + stride * p;
+                const float *bReal = inReal + stride * (p + half);
+                const float *bImag = inImag + stride * (p + half);
+                float *sumReal = outReal + stride * 2 * p;
+                float *sumImag = outImag + stride * 2 * p;
+                float *diffReal = sumReal + stride;
+                float *diffImag = sumImag + stride;
+
+                for (size_t q = 0; q < stride; ++q)
+                {
+                    const float dr = aReal[q] - bReal[q];
+                    const float di = aImag[q] - bImag[q];
+                    sumReal[q] = aReal[q] + bReal[q];
+                    sumImag[q] = aImag[q] + bImag[q];
+                    diffReal[q] = dr * wr - di * wi;
+                    diffImag[q] = dr * wi + di * wr;
+                }
+            }
+            std::swap(inReal, outReal);
+            std::swap(inImag, outImag);
+        }
+
+        // An odd number of passes leaves the result in the work buffers.
+        if (inReal != m_real.data())
+        {
+            std::copy(inReal, inReal + points, m_real.begin());
+            std::copy(inImag, inImag + points, m_imag.begin());
+        }
+    }
+
+    // Even samples go in as real parts and odd ones as imaginary parts. The
+    // spectra of the two halves are then pulled apart through the symmetry
+    // of a real signal's spectrum and combined into the full one.
+    void RealFft::forward(const float *input, float *real, float *imag)
+    {
+        const size_t half = m_size / 2;
+        for (size_t k = 0; k < half; ++k)
+        {
+            m_real[k] = input[2 * k];
+            m_imag[k] = input[2 * k + 1];
+        }
+
+        transformHalf();
+
+        for (size_t k = 0; k <= half; ++k)
+        {
+            const size_t i = k == half ? 0 : k;
+            const size_t j = k == 0 ? 0 : half - k;
+
+            // even = (Z[k] + conj(Z[n - k])) / 2
+            // odd = (Z[k] - conj(Z[n - k])) / 2i
+            const float evenReal = 0.5f * (m_real[i] + m_real[j]);
+            const float evenImag = 0.5f * (m_imag[i] - m_imag[j]);
+            const float oddReal = 0.5f * (m_imag[i] + m_imag[j]);
+            const float oddImag = -0.5f * (m_real[i] - m_real[j]);
+
+            real[k] = evenReal + oddReal * m_splitReal[k] -
+                      oddImag * m_splitImag[k];
+            imag[k] = evenImag + oddReal * m_splitImag[k] +
+                      oddImag * m_splitReal[k];
+        }
+    }
+
+    void RealFft::magnitudes(const float *input, float *out)
+    {
+        forward(input, m_binReal.data(), m_binImag.data());
+        for (size_t k = 0; k < bins(); ++k)
+            out[k] = std::sqrt(m_binReal[k] * m_binReal[k] +
+                               m_binImag[k] * m_binImag[k]);
+    }
+} // namespace dtracker::audio::dsp
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||             \
+    defined(_M_IX86)
+#define DTRACKER_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace dtracker::audio::dsp
+{
+    namespace
+    {
+        // --- Scalar kernels: the reference every SIMD variant must match ---
+
+        void clearScalar(float *dst, size_t n)
+        {
+            std::fill(dst, dst + n, 0.0f);
+        }
+
+        void accumulateScalar(float *dst, const float *src, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                dst[i] += src[i];
+        }
+
+        void accumulateScaledScalar(float *dst, const float *src, float gain,
+                                    size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                dst[i] += src[i] * gain;
+        }
+
+        void accumulateStereoScalar(float *dst, const float *src,
+                                    float gainLeft, float gainRight,
+                                    size_t frames)
+        {
+            for (size_t i = 0; i < frames; ++i)
+            {
+                dst[i * 2] += src[i * 2] * gainLeft;
+                dst[i * 2 + 1] += src[i * 2 + 1] * gainRight;
+            }
+        }
+
+        void applyStereoGainScalar(float *buffer, float gainLeft,
+                                   float gainRight, size_t frames)
+        {
+            for (size_t i = 0; i < frames; ++i)
+            {
+                buffer[i * 2] *= gainLeft;
+                buffer[i * 2 + 1] *= gainRight;
+            }
+        }
+
+        void floatToInt16Scalar(std::int16_t *dst, const float *src, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float clamped = std::clamp(src[i], -1.0f, 1.0f);
+                dst[i] = static_cast<std::int16_t>(clamped * 32767.0f);
+            }
+        }
+
+        void int16ToFloatScalar(float *dst, const std::int16_t *src, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                dst[i] = static_cast<float>(src[i]) * (1.0f / 32767.0f);
+        }
+
+        void measureScalar(const float *src, size_t n, float *peaks,
+                           float *sumSquares)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float x = src[i];
+                peaks[i & 1] = std::max(peaks[i & 1], std::fabs(x));
+                sumSquares[i & 1] += x * x;
+            }
+        }
+
+        void dotStereoScalar(const float *src, const float *coeffs, size_t n,
+                             float *sums)
+        {
+            for (size_t i = 0; i < n; ++i)
+                sums[i & 1] += src[i] * coeffs[i];
+        }
+
+        constexpr MixKernels kScalarKernels{
+            clearScalar,            accumulateScalar,
+            accumulateScaledScalar, accumulateStereoScalar,
+            applyStereoGainScalar,  floatToInt16Scalar,
+            int16ToFloatScalar,     measureScalar,
+            dotStereoScalar,
+        };
+
+        // --- CPU detection ---
+
+#ifdef DTRACKER_X86
+        void cpuid(int leaf, int subleaf, unsigned int regs[4])
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuidex(info, leaf, subleaf);
+            for (int i = 0; i < 4; ++i)
+                regs[i] = static_cast<unsigned int>(info[i]);
+#else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        // Reads XCR0 to learn which register files the OS saves on a context
+        // switch. A CPU feature is useless if the OS does not preserve it.
+        unsigned long long readXcr0()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            unsigned int eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        }
+#endif
+
+        // Finds the widest instruction set both the CPU and the OS support.
+        InstructionSet detectInstructionSet()
+        {
+#ifdef DTRACKER_X86
+            unsigned int regs[4] = {};
+            cpuid(0, 0, regs);
+            const unsigned int maxLeaf = regs[0];
+            if (maxLeaf < 1)
+                return InstructionSet::Scalar;
+
+            cpuid(1, 0, regs);
+            const bool sse2 = regs[3] & (1u << 26);
+            const bool osxsave = regs[2] & (1u << 27);
+            const bool avx = regs[2] & (1u << 28);
+
+            bool avx2 = false;
+            bool avx512 = false;
+            if (maxLeaf >= 7 && osxsave && avx)
+            {
+                const unsigned long long xcr0 = readXcr0();
+                // XMM and YMM state.
+                const bool osAvx = (xcr0 & 0x6) == 0x6;
+                // Opmask, upper ZMM and high ZMM state as well.
+                const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+                cpuid(7, 0, regs);
+                avx2 = osAvx && (regs[1] & (1u << 5));
+                avx512 = osAvx512 && (regs[1] & (1u << 16));
+            }
+
+            if (avx512 && detail::avx512Kernels())
+                return InstructionSet::AVX512;
+            if (avx2 && detail::avx2Kernels())
+                return InstructionSet::AVX2;
+            if (sse2 && detail::sse2Kernels())
+                return InstructionSet::SSE2;
+#endif
+            return InstructionSet::Scalar;
+        }
+    } // namespace
+
+    // Detection runs once, on first use. The engine calls this while it is
+    // constructed so the audio thread never pays for it.
+    const MixKernels &kernels()
+    {
+        static const MixKernels *const active =
+            kernelsFor(activeInstructionSet());
+        return *active;
+    }
+
+    InstructionSet activeInstructionSet()
+    {
+        static const InstructionSet active = detectInstructionSet();
+        return active;
+    }
+
+    // Only hands out tables the CPU can actually run.
+    const MixKernels *kernelsFor(InstructionSet set)
+    {
+        if (static_cast<int>(set) > static_cast<int>(activeInstructionSet()))
+            return nullptr;
+
+        switch (set)
+        {
+        case InstructionSet::Scalar:
+            return detail::scalarKernels();
+        case InstructionSet::SSE2:
+            return detail::sse2Kernels();
+        case InstructionSet::AVX2:
+            return detail::avx2Kernels();
+        case InstructionSet::AVX512:
+            return detail::avx512Kernels();
+        }
+        return nullptr;
+    }
+
+    const char *instructionSetName(InstructionSet set)
+    {
+        switch (set)
+        {
+        case InstructionSet::Scalar:
+            return "scalar";
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        }
+        return "unknown";
+    }
+
+    namespace detail
+    {
+        const MixKernels *scalarKernels()
+        {
+            return &kScalarKernels;
+        }
+    } // namespace detail
+} // namespace dtracker::audio::dsp
@@ -0,0 +1,236 @@
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||             \
+    defined(_M_IX86)
+
+#include <immintrin.h>
+
+// Compiled for AVX2 regardless of the project's baseline flags; only called
+// after CPUID has confirmed support.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DTRACKER_AVX2
+#else
+#define DTRACKER_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace dtracker::audio::dsp
+{
+    namespace
+    {
+        constexpr size_t kWidth = 8; // Floats per register
+
+        DTRACKER_AVX2 void clearAvx2(float *dst, size_t n)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                _mm256_storeu_ps(dst + i, zero);
+            for (; i < n; ++i)
+                dst[i] = 0.0f;
+        }
+
+        DTRACKER_AVX2 void accumulateAvx2(float *dst, const float *src,
+                                          size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256 sum = _mm256_add_ps(_mm256_loadu_ps(dst + i),
+                                                 _mm256_loadu_ps(src + i));
+                _mm256_storeu_ps(dst + i, sum);
+            }
+            for (; i < n; ++i)
+                dst[i] += src[i];
+        }
+
+        // Shared by the mono and stereo scaled accumulates. 'gains' holds
+        // the gain for each lane; for stereo it alternates left and right.
+        DTRACKER_AVX2 void accumulateWithGains(float *dst, const float *src,
+                                               __m256 gains, float gainEven,
+                                               float gainOdd, size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256 scaled =
+                    _mm256_mul_ps(_mm256_loadu_ps(src + i), gains);
+                const __m256 sum =
+                    _mm256_add_ps(_mm256_loadu_ps(dst + i), scaled);
+                _mm256_storeu_ps(dst + i, sum);
+            }
+            for (; i < n; ++i)
+                dst[i] += src[i] * ((i & 1) ? gainOdd : gainEven);
+        }
+
+        DTRACKER_AVX2 void accumulateScaledAvx2(float *dst, const float *src,
+                                                float gain, size_t n)
+        {
+            accumulateWithGains(dst, src, _mm256_set1_ps(gain), gain, gain, n);
+        }
+
+        DTRACKER_AVX2 void accumulateStereoAvx2(float *dst, const float *src,
+                                                float gainLeft,
+                                                float gainRight, size_t frames)
+        {
+            const __m256 gains =
+                _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight,
+                               gainLeft, gainRight, gainLeft, gainRight);
+            accumulateWithGains(dst, src, gains, gainLeft, gainRight,
+                                frames * 2);
+        }
+
+        DTRACKER_AVX2 void applyStereoGainAvx2(float *buffer, float gainLeft,
+                                               float gainRight, size_t frames)
+        {
+            const __m256 gains =
+                _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight,
+                               gainLeft, gainRight, gainLeft, gainRight);
+            const size_t n = frames * 2;
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256 scaled =
+                    _mm256_mul_ps(_mm256_loadu_ps(buffer + i), gains);
+                _mm256_storeu_ps(buffer + i, scaled);
+            }
+            for (; i < n; ++i)
+                buffer[i] *= (i & 1) ? gainRight : gainLeft;
+        }
+
+        DTRACKER_AVX2 void floatToInt16Avx2(std::int16_t *dst,
+                                            const float *src, size_t n)
+        {
+            const __m256 lo = _mm256_set1_ps(-1.0f);
+            const __m256 hi = _mm256_set1_ps(1.0f);
+            const __m256 scale = _mm256_set1_ps(32767.0f);
+
+            size_t i = 0;
+            for (; i + 2 * kWidth <= n; i += 2 * kWidth)
+            {
+                __m256 a = _mm256_loadu_ps(src + i);
+                __m256 b = _mm256_loadu_ps(src + i + kWidth);
+                a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(a, lo), hi),
+                                  scale);
+                b = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(b, lo), hi),
+                                  scale);
+
+                // Truncate like static_cast, then narrow to 16 bits. The pack
+                // works per 128-bit lane, so restore the order afterwards.
+                __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(a),
+                                                    _mm256_cvttps_epi32(b));
+                packed = _mm256_permute4x64_epi64(packed, 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                                    packed);
+            }
+            for (; i < n; ++i)
+            {
+                float v = src[i] < -1.0f ? -1.0f : src[i];
+                v = v > 1.0f ? 1.0f : v;
+                dst[i] = static_cast<std::int16_t>(v * 32767.0f);
+            }
+        }
+
+        DTRACKER_AVX2 void int16ToFloatAvx2(float *dst, const std::int16_t *src,
+                                            size_t n)
+        {
+            const __m256 scale = _mm256_set1_ps(1.0f / 32767.0f);
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m128i x = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(src + i));
+                const __m256 values =
+                    _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(values, scale));
+            }
+            for (; i < n; ++i)
+                dst[i] = static_cast<float>(src[i]) * (1.0f / 32767.0f);
+        }
+
+        DTRACKER_AVX2 void measureAvx2(const float *src, size_t n,
+                                       float *peaks, float *sumSquares)
+        {
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+            __m256 peak = _mm256_setzero_ps();
+            __m256 sum = _mm256_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256 x = _mm256_loadu_ps(src + i);
+                peak = _mm256_max_ps(peak, _mm256_andnot_ps(signBit, x));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(x, x));
+            }
+
+            // Lanes alternate even and odd samples, like the input.
+            float peakLanes[kWidth];
+            float sumLanes[kWidth];
+            _mm256_storeu_ps(peakLanes, peak);
+            _mm256_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+            {
+                if (peakLanes[lane] > peaks[lane & 1])
+                    peaks[lane & 1] = peakLanes[lane];
+                sumSquares[lane & 1] += sumLanes[lane];
+            }
+
+            for (; i < n; ++i)
+            {
+                const float magnitude = src[i] < 0.0f ? -src[i] : src[i];
+                if (magnitude > peaks[i & 1])
+                    peaks[i & 1] = magnitude;
+                sumSquares[i & 1] += src[i] * src[i];
+            }
+        }
+
+        DTRACKER_AVX2 void dotStereoAvx2(const float *src, const float *coeffs,
+                                         size_t n, float *sums)
+        {
+            __m256 sum = _mm256_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                sum = _mm256_add_ps(
+                    sum, _mm256_mul_ps(_mm256_loadu_ps(src + i),
+                                       _mm256_loadu_ps(coeffs + i)));
+
+            float sumLanes[kWidth];
+            _mm256_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+                sums[lane & 1] += sumLanes[lane];
+
+            for (; i < n; ++i)
+                sums[i & 1] += src[i] * coeffs[i];
+        }
+
+        constexpr MixKernels kAvx2Kernels{
+            clearAvx2,            accumulateAvx2,
+            accumulateScaledAvx2, accumulateStereoAvx2,
+            applyStereoGainAvx2,  floatToInt16Avx2,
+            int16ToFloatAvx2,     measureAvx2,
+            dotStereoAvx2,
+        };
+    } // namespace
+
+    namespace detail
+    {
+        const MixKernels *avx2Kernels()
+        {
+            return &kAvx2Kernels;
+        }
+    } // namespace detail
+} // namespace dtracker::audio::dsp
+
+#else
+
+namespace dtracker::audio::dsp::detail
+{
+    // Not an x86 target.
+    const MixKernels *avx2Kernels()
+    {
+        return nullptr;
+    }
+} // namespace dtracker::audio::dsp::detail
+
+#endif
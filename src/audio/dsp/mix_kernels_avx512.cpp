@@ -0,0 +1,271 @@
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+// Compiled for AVX-512F regardless of the project's baseline flags; only
+// called after CPUID and XCR0 have confirmed support. Tails are handled with
+// masked loads and stores instead of a scalar loop.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DTRACKER_AVX512
+#else
+#define DTRACKER_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace dtracker::audio::dsp
+{
+    namespace
+    {
+        constexpr size_t kWidth = 16; // Floats per register
+
+        // A mask selecting the first 'count' lanes (count < kWidth).
+        DTRACKER_AVX512 __mmask16 tailMask(size_t count)
+        {
+            return static_cast<__mmask16>((1u << count) - 1u);
+        }
+
+        DTRACKER_AVX512 void clearAvx512(float *dst, size_t n)
+        {
+            const __m512 zero = _mm512_setzero_ps();
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                _mm512_storeu_ps(dst + i, zero);
+            if (i < n)
+                _mm512_mask_storeu_ps(dst + i, tailMask(n - i), zero);
+        }
+
+        DTRACKER_AVX512 void accumulateAvx512(float *dst, const float *src,
+                                              size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m512 sum = _mm512_add_ps(_mm512_loadu_ps(dst + i),
+                                                 _mm512_loadu_ps(src + i));
+                _mm512_storeu_ps(dst + i, sum);
+            }
+            if (i < n)
+            {
+                const __mmask16 mask = tailMask(n - i);
+                const __m512 sum =
+                    _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst + i),
+                                  _mm512_maskz_loadu_ps(mask, src + i));
+                _mm512_mask_storeu_ps(dst + i, mask, sum);
+            }
+        }
+
+        // Shared by the mono and stereo scaled accumulates. 'gains' holds
+        // the gain for each lane; for stereo it alternates left and right.
+        // Every block starts on an even sample, so the pattern lines up.
+        DTRACKER_AVX512 void accumulateWithGains(float *dst, const float *src,
+                                                 __m512 gains, size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m512 scaled =
+                    _mm512_mul_ps(_mm512_loadu_ps(src + i), gains);
+                const __m512 sum =
+                    _mm512_add_ps(_mm512_loadu_ps(dst + i), scaled);
+                _mm512_storeu_ps(dst + i, sum);
+            }
+            if (i < n)
+            {
+                const __mmask16 mask = tailMask(n - i);
+                const __m512 scaled = _mm512_mul_ps(
+                    _mm512_maskz_loadu_ps(mask, src + i), gains);
+                const __m512 sum =
+                    _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst + i), scaled);
+                _mm512_mask_storeu_ps(dst + i, mask, sum);
+            }
+        }
+
+        // Builds a register of alternating left/right gains.
+        DTRACKER_AVX512 __m512 stereoGains(float gainLeft, float gainRight)
+        {
+            return _mm512_setr_ps(gainLeft, gainRight, gainLeft, gainRight,
+                                  gainLeft, gainRight, gainLeft, gainRight,
+                                  gainLeft, gainRight, gainLeft, gainRight,
+                                  gainLeft, gainRight, gainLeft, gainRight);
+        }
+
+        DTRACKER_AVX512 void accumulateScaledAvx512(float *dst,
+                                                    const float *src,
+                                                    float gain, size_t n)
+        {
+            accumulateWithGains(dst, src, _mm512_set1_ps(gain), n);
+        }
+
+        DTRACKER_AVX512 void accumulateStereoAvx512(float *dst,
+                                                    const float *src,
+                                                    float gainLeft,
+                                                    float gainRight,
+                                                    size_t frames)
+        {
+            accumulateWithGains(dst, src, stereoGains(gainLeft, gainRight),
+                                frames * 2);
+        }
+
+        DTRACKER_AVX512 void applyStereoGainAvx512(float *buffer,
+                                                   float gainLeft,
+                                                   float gainRight,
+                                                   size_t frames)
+        {
+            const __m512 gains = stereoGains(gainLeft, gainRight);
+            const size_t n = frames * 2;
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m512 scaled =
+                    _mm512_mul_ps(_mm512_loadu_ps(buffer + i), gains);
+                _mm512_storeu_ps(buffer + i, scaled);
+            }
+            if (i < n)
+            {
+                const __mmask16 mask = tailMask(n - i);
+                const __m512 scaled = _mm512_mul_ps(
+                    _mm512_maskz_loadu_ps(mask, buffer + i), gains);
+                _mm512_mask_storeu_ps(buffer + i, mask, scaled);
+            }
+        }
+
+        // Clamps, scales and truncates like static_cast.
+        DTRACKER_AVX512 __m512i toInt32(__m512 v)
+        {
+            const __m512 clamped = _mm512_min_ps(
+                _mm512_max_ps(v, _mm512_set1_ps(-1.0f)), _mm512_set1_ps(1.0f));
+            return _mm512_cvttps_epi32(
+                _mm512_mul_ps(clamped, _mm512_set1_ps(32767.0f)));
+        }
+
+        DTRACKER_AVX512 void floatToInt16Avx512(std::int16_t *dst,
+                                                const float *src, size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256i packed =
+                    _mm512_cvtsepi32_epi16(toInt32(_mm512_loadu_ps(src + i)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                                    packed);
+            }
+            if (i < n)
+            {
+                const __mmask16 mask = tailMask(n - i);
+                _mm512_mask_cvtsepi32_storeu_epi16(
+                    dst + i, mask,
+                    toInt32(_mm512_maskz_loadu_ps(mask, src + i)));
+            }
+        }
+
+        DTRACKER_AVX512 void int16ToFloatAvx512(float *dst,
+                                                const std::int16_t *src,
+                                                size_t n)
+        {
+            const __m512 scale = _mm512_set1_ps(1.0f / 32767.0f);
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m256i x = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(src + i));
+                const __m512 values =
+                    _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(x));
+                _mm512_storeu_ps(dst + i, _mm512_mul_ps(values, scale));
+            }
+            // Masked 16-bit loads need AVX-512BW; the tail is short anyway.
+            for (; i < n; ++i)
+                dst[i] = static_cast<float>(src[i]) * (1.0f / 32767.0f);
+        }
+
+        DTRACKER_AVX512 void measureAvx512(const float *src, size_t n,
+                                           float *peaks, float *sumSquares)
+        {
+            __m512 peak = _mm512_setzero_ps();
+            __m512 sum = _mm512_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m512 x = _mm512_loadu_ps(src + i);
+                peak = _mm512_max_ps(peak, _mm512_abs_ps(x));
+                sum = _mm512_fmadd_ps(x, x, sum);
+            }
+            // Masked-off lanes load as zero, which changes neither result.
+            if (i < n)
+            {
+                const __m512 x =
+                    _mm512_maskz_loadu_ps(tailMask(n - i), src + i);
+                peak = _mm512_max_ps(peak, _mm512_abs_ps(x));
+                sum = _mm512_fmadd_ps(x, x, sum);
+            }
+
+            // Lanes alternate even and odd samples, like the input.
+            float peakLanes[kWidth];
+            float sumLanes[kWidth];
+            _mm512_storeu_ps(peakLanes, peak);
+            _mm512_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+            {
+                if (peakLanes[lane] > peaks[lane & 1])
+                    peaks[lane & 1] = peakLanes[lane];
+                sumSquares[lane & 1] += sumLanes[lane];
+            }
+        }
+
+        DTRACKER_AVX512 void dotStereoAvx512(const float *src,
+                                             const float *coeffs, size_t n,
+                                             float *sums)
+        {
+            __m512 sum = _mm512_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                sum = _mm512_fmadd_ps(_mm512_loadu_ps(src + i),
+                                      _mm512_loadu_ps(coeffs + i), sum);
+            // Masked-off lanes load as zero and add nothing.
+            if (i < n)
+            {
+                const __mmask16 mask = tailMask(n - i);
+                sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, src + i),
+                                      _mm512_maskz_loadu_ps(mask, coeffs + i),
+                                      sum);
+            }
+
+            float sumLanes[kWidth];
+            _mm512_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+                sums[lane & 1] += sumLanes[lane];
+        }
+
+        constexpr MixKernels kAvx512Kernels{
+            clearAvx512,            accumulateAvx512,
+            accumulateScaledAvx512, accumulateStereoAvx512,
+            applyStereoGainAvx512,  floatToInt16Avx512,
+            int16ToFloatAvx512,     measureAvx512,
+            dotStereoAvx512,
+        };
+    } // namespace
+
+    namespace detail
+    {
+        const MixKernels *avx512Kernels()
+        {
+            return &kAvx512Kernels;
+        }
+    } // namespace detail
+} // namespace dtracker::audio::dsp
+
+#else
+
+namespace dtracker::audio::dsp::detail
+{
+    // AVX-512 is only used on 64-bit x86.
+    const MixKernels *avx512Kernels()
+    {
+        return nullptr;
+    }
+} // namespace dtracker::audio::dsp::detail
+
+#endif
@@ -0,0 +1,233 @@
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||             \
+    defined(_M_IX86)
+
+#include <immintrin.h>
+
+// Compiled for SSE2 regardless of the project's baseline flags; only called
+// after CPUID has confirmed support.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DTRACKER_SSE2
+#else
+#define DTRACKER_SSE2 __attribute__((target("sse2")))
+#endif
+
+namespace dtracker::audio::dsp
+{
+    namespace
+    {
+        constexpr size_t kWidth = 4; // Floats per register
+
+        DTRACKER_SSE2 void clearSse2(float *dst, size_t n)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                _mm_storeu_ps(dst + i, zero);
+            for (; i < n; ++i)
+                dst[i] = 0.0f;
+        }
+
+        DTRACKER_SSE2 void accumulateSse2(float *dst, const float *src,
+                                          size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m128 sum = _mm_add_ps(_mm_loadu_ps(dst + i),
+                                              _mm_loadu_ps(src + i));
+                _mm_storeu_ps(dst + i, sum);
+            }
+            for (; i < n; ++i)
+                dst[i] += src[i];
+        }
+
+        // Shared by the mono and stereo scaled accumulates. 'gains' holds
+        // the gain for each lane; for stereo it alternates left and right.
+        DTRACKER_SSE2 void accumulateWithGains(float *dst, const float *src,
+                                               __m128 gains, float gainEven,
+                                               float gainOdd, size_t n)
+        {
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), gains);
+                _mm_storeu_ps(dst + i,
+                              _mm_add_ps(_mm_loadu_ps(dst + i), scaled));
+            }
+            for (; i < n; ++i)
+                dst[i] += src[i] * ((i & 1) ? gainOdd : gainEven);
+        }
+
+        DTRACKER_SSE2 void accumulateScaledSse2(float *dst, const float *src,
+                                                float gain, size_t n)
+        {
+            accumulateWithGains(dst, src, _mm_set1_ps(gain), gain, gain, n);
+        }
+
+        DTRACKER_SSE2 void accumulateStereoSse2(float *dst, const float *src,
+                                                float gainLeft,
+                                                float gainRight, size_t frames)
+        {
+            const __m128 gains =
+                _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+            accumulateWithGains(dst, src, gains, gainLeft, gainRight,
+                                frames * 2);
+        }
+
+        DTRACKER_SSE2 void applyStereoGainSse2(float *buffer, float gainLeft,
+                                               float gainRight, size_t frames)
+        {
+            const __m128 gains =
+                _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+            const size_t n = frames * 2;
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                _mm_storeu_ps(buffer + i,
+                              _mm_mul_ps(_mm_loadu_ps(buffer + i), gains));
+            for (; i < n; ++i)
+                buffer[i] *= (i & 1) ? gainRight : gainLeft;
+        }
+
+        DTRACKER_SSE2 void floatToInt16Sse2(std::int16_t *dst,
+                                            const float *src, size_t n)
+        {
+            const __m128 lo = _mm_set1_ps(-1.0f);
+            const __m128 hi = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(32767.0f);
+
+            size_t i = 0;
+            for (; i + 2 * kWidth <= n; i += 2 * kWidth)
+            {
+                __m128 a = _mm_loadu_ps(src + i);
+                __m128 b = _mm_loadu_ps(src + i + kWidth);
+                a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, lo), hi), scale);
+                b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, lo), hi), scale);
+
+                // Truncate like static_cast, then narrow to 16 bits.
+                const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a),
+                                                       _mm_cvttps_epi32(b));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                                 packed);
+            }
+            for (; i < n; ++i)
+            {
+                float v = src[i] < -1.0f ? -1.0f : src[i];
+                v = v > 1.0f ? 1.0f : v;
+                dst[i] = static_cast<std::int16_t>(v * 32767.0f);
+            }
+        }
+
+        DTRACKER_SSE2 void int16ToFloatSse2(float *dst, const std::int16_t *src,
+                                            size_t n)
+        {
+            const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+
+            size_t i = 0;
+            for (; i + 2 * kWidth <= n; i += 2 * kWidth)
+            {
+                const __m128i x = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(src + i));
+
+                // Sign-extend by placing each value in the top half of a
+                // 32-bit lane and shifting it back down arithmetically.
+                const __m128i low =
+                    _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+                const __m128i high =
+                    _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+                _mm_storeu_ps(dst + i,
+                              _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                _mm_storeu_ps(dst + i + kWidth,
+                              _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+            }
+            for (; i < n; ++i)
+                dst[i] = static_cast<float>(src[i]) * (1.0f / 32767.0f);
+        }
+
+        DTRACKER_SSE2 void measureSse2(const float *src, size_t n,
+                                       float *peaks, float *sumSquares)
+        {
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+            __m128 peak = _mm_setzero_ps();
+            __m128 sum = _mm_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+            {
+                const __m128 x = _mm_loadu_ps(src + i);
+                peak = _mm_max_ps(peak, _mm_andnot_ps(signBit, x));
+                sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+            }
+
+            // Lanes alternate even and odd samples, like the input.
+            float peakLanes[kWidth];
+            float sumLanes[kWidth];
+            _mm_storeu_ps(peakLanes, peak);
+            _mm_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+            {
+                if (peakLanes[lane] > peaks[lane & 1])
+                    peaks[lane & 1] = peakLanes[lane];
+                sumSquares[lane & 1] += sumLanes[lane];
+            }
+
+            for (; i < n; ++i)
+            {
+                const float magnitude = src[i] < 0.0f ? -src[i] : src[i];
+                if (magnitude > peaks[i & 1])
+                    peaks[i & 1] = magnitude;
+                sumSquares[i & 1] += src[i] * src[i];
+            }
+        }
+
+        DTRACKER_SSE2 void dotStereoSse2(const float *src, const float *coeffs,
+                                         size_t n, float *sums)
+        {
+            __m128 sum = _mm_setzero_ps();
+
+            size_t i = 0;
+            for (; i + kWidth <= n; i += kWidth)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + i),
+                                                 _mm_loadu_ps(coeffs + i)));
+
+            float sumLanes[kWidth];
+            _mm_storeu_ps(sumLanes, sum);
+            for (size_t lane = 0; lane < kWidth; ++lane)
+                sums[lane & 1] += sumLanes[lane];
+
+            for (; i < n; ++i)
+                sums[i & 1] += src[i] * coeffs[i];
+        }
+
+        constexpr MixKernels kSse2Kernels{
+            clearSse2,            accumulateSse2,
+            accumulateScaledSse2, accumulateStereoSse2,
+            applyStereoGainSse2,  floatToInt16Sse2,
+            int16ToFloatSse2,     measureSse2,
+            dotStereoSse2,
+        };
+    } // namespace
+
+    namespace detail
+    {
+        const MixKernels *sse2Kernels()
+        {
+            return &kSse2Kernels;
+        }
+    } // namespace detail
+} // namespace dtracker::audio::dsp
+
+#else
+
+namespace dtracker::audio::dsp::detail
+{
+    // Not an x86 target.
+    const MixKernels *sse2Kernels()
+    {
+        return nullptr;
+    }
+} // namespace dtracker::audio::dsp::detail
+
+#endif
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/dsp/resampler.hpp>
+
+namespace dtracker::audio::dsp
+{
+    namespace
+    {
+        // The frame a filter starts on, relative to the frame at or before
+        // the position.
+        constexpr std::int64_t kSincLead = kSincTaps / 2 - 1;
+
+        // The passband, as a fraction of the source's Nyquist frequency, or
+        // of the output's when reading below the source's rate.
+        // The rest is left for the filter to roll off in.
+        constexpr double kSincCutoff = 0.92;
+
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kSincHalfWidth = kSincTaps / 2.0;
+
+        // The Blackman-windowed sinc every table is built from, at 'd'
+        // source frames from the position read.
+        double sincKernel(double d)
+        {
+            const double x = kPi * kSincCutoff * d;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(x) / x;
+
+            const double w = d / kSincHalfWidth;
+            if (std::fabs(w) >= 1.0)
+                return 0.0;
+            return sinc * (0.42 + 0.5 * std::cos(kPi * w) +
+                           0.08 * std::cos(2.0 * kPi * w));
+        }
+
+        // One row per phase, plus one so the last phase can blend into the
+        // next frame. Each tap is stored twice, once per channel, so a row
+        // lines up with the interleaved frames it is applied to.
+        using SincTable =
+            std::array<std::array<float, kSincTaps * 2>, kSincPhases + 1>;
+
+        // Built during static initialization, so the audio thread never
+        // builds it.
+        const SincTable kSincTable = []
+        {
+            SincTable table{};
+            for (size_t phase = 0; phase <= kSincPhases; ++phase)
+            {
+                const double fraction =
+                    static_cast<double>(phase) / kSincPhases;
+                double taps[kSincTaps];
+                double sum = 0.0;
+                for (size_t k = 0; k < kSincTaps; ++k)
+                {
+                    taps[k] = sincKernel(static_cast<double>(k) - kSincLead -
+                                         fraction);
+                    sum += taps[k];
+                }
+
+                // Every phase passes DC at unity gain.
+                for (size_t k = 0; k < kSincTaps; ++k)
+                {
+                    const float tap = static_cast<float>(taps[k] / sum);
+                    table[phase][k * 2] = tap;
+                    table[phase][k * 2 + 1] = tap;
+                }
+            }
+            return table;
+        }();
+
+        // The kernel sampled kSincPhases times per frame across its width,
+        // plus a zero past the end, for filters stretched to any length.
+        using SincCurve = std::array<float, kSincTaps * kSincPhases + 2>;
+
+        const SincCurve kSincCurve = []
+        {
+            SincCurve curve{};
+            for (size_t i = 0; i + 1 < curve.size(); ++i)
+                curve[i] = static_cast<float>(sincKernel(
+                    static_cast<double>(i) / kSincPhases - kSincHalfWidth));
+            return curve;
+        }();
+
+        // The kernel at 'd' frames, interpolated from the curve.
+        float sincCurveAt(double d)
+        {
+            const double index = (d + kSincHalfWidth) * kSincPhases;
+            if (index <= 0.0 || index >= kSincTaps * kSincPhases)
+                return 0.0f;
+            const auto i = static_cast<size_t>(index);
+            const float t = static_cast<float>(index - i);
+            return kSincCurve[i] + (kSincCurve[i + 1] - kSincCurve[i]) * t;
+        }
+
+        // The sample of 'channel' at 'frame', or silence outside the source.
+        float sampleAt(const float *src, std::int64_t srcFrames,
+                       std::int64_t frame, int channel)
+        {
+            return frame >= 0 && frame < srcFrames ? src[frame * 2 + channel]
+                                                   : 0.0f;
+        }
+
+        // Catmull-Rom through four frames, at 't' between the middle two.
+        float hermite(float y0, float y1, float y2, float y3, float t)
+        {
+            const float c1 = 0.5f * (y2 - y0);
+            const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+            const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            return ((c3 * t + c2) * t + c1) * t + y1;
+        }
+
+        // Copies the frames a filter reads, or null if they all lie inside
+        // the source and can be read in place. Near the ends the filter
+        // reaches past the source, so those frames are copied out with
+        // silence around them.
+        const float *filterWindow(const float *src, std::int64_t srcFrames,
+                                  std::int64_t first, size_t taps,
+                                  float *padded)
+        {
+            if (first >= 0 && first + static_cast<std::int64_t>(taps) <=
+                                  srcFrames)
+                return src + first * 2;
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                padded[k * 2] = sampleAt(src, srcFrames, first + k, 0);
+                padded[k * 2 + 1] = sampleAt(src, srcFrames, first + k, 1);
+            }
+            return padded;
+        }
+
+        // Reads at or above the source's rate, blending the two table rows
+        // around each position.
+        size_t sincInterpolate(float *dst, size_t frames, const float *src,
+                               std::int64_t srcFrames, double &position,
+                               double step, float gainLeft, float gainRight)
+        {
+            float padded[kSincTaps * 2];
+            size_t written = 0;
+            for (; written < frames && position < srcFrames; ++written)
+            {
+                const auto frame = static_cast<std::int64_t>(position);
+                const double phase = (position - frame) * kSincPhases;
+                const auto row = static_cast<size_t>(phase);
+                const float blend = static_cast<float>(phase - row);
+
+                const float *window = filterWindow(
+                    src, srcFrames, frame - kSincLead, kSincTaps, padded);
+
+                float current[2] = {0.0f, 0.0f};
+                float next[2] = {0.0f, 0.0f};
+                dotStereo(window, kSincTable[row].data(), kSincTaps * 2,
+                          current);
+                dotStereo(window, kSincTable[row + 1].data(), kSincTaps * 2,
+                          next);
+
+                dst[written * 2] +=
+                    (current[0] + (next[0] - current[0]) * blend) * gainLeft;
+                dst[written * 2 + 1] +=
+                    (current[1] + (next[1] - current[1]) * blend) * gainRight;
+                position += step;
+            }
+            return written;
+        }
+
+        // Reads below the source's rate. The kernel is stretched over 'step'
+        // times as many frames, which moves its cutoff down to the output's
+        // Nyquist frequency, so what the output cannot hold is filtered out
+        // instead of folding back. Its taps are read off the curve for each
+        // frame, which costs more than a table row; this path is for exports
+        // and background conversion.
+        size_t sincDecimate(float *dst, size_t frames, const float *src,
+                            std::int64_t srcFrames, double &position,
+                            double step, float gainLeft, float gainRight)
+        {
+            const double stretch =
+                std::min(step, static_cast<double>(kSincMaxStretch));
+            const auto reach = static_cast<std::int64_t>(
+                std::ceil(kSincHalfWidth * stretch));
+            const auto taps = static_cast<size_t>(reach * 2);
+
+            float coeffs[kSincTaps * kSincMaxStretch * 2];
+            float padded[kSincTaps * kSincMaxStretch * 2];
+            size_t written = 0;
+            for (; written < frames && position < srcFrames; ++written)
+            {
+                const auto frame = static_cast<std::int64_t>(position);
+                const std::int64_t first = frame - reach + 1;
+
+                float sum = 0.0f;
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const float tap = sincCurveAt(
+                        (static_cast<double>(first + k) - position) /
+                        stretch);
+                    coeffs[k * 2] = tap;
+                    coeffs[k * 2 + 1] = tap;
+                    sum += tap;
+                }
+
+                const float *window =
+                    filterWindow(src, srcFrames, first, taps, padded);
+                float sums[2] = {0.0f, 0.0f};
+                dotStereo(window, coeffs, taps * 2, sums);
+
+                // Dividing by the taps' sum passes DC at unity gain.
+                const float scale = sum != 0.0f ? 1.0f / sum : 0.0f;
+                dst[written * 2] += sums[0] * scale * gainLeft;
+                dst[written * 2 + 1] += sums[1] * scale * gainRight;
+                position += step;
+            }
+            return written;
+        }
+    } // namespace
+
+    // The quality is picked once per call, so each loop is a tight one.
+    // Linear and cubic read a few frames with scalar code, where a kernel
+    // call per frame would cost more than it saved; the sinc filter's 32
+    // products per phase go through the SIMD kernel.
+    size_t resampleStereo(float *dst, size_t frames, const float *src,
+                          size_t srcFrames, double &position, double step,
+                          float gainLeft, float gainRight,
+                          ResampleQuality quality)
+    {
+        const auto count = static_cast<std::int64_t>(srcFrames);
+        size_t written = 0;
+
+        switch (quality)
+        {
+        case ResampleQuality::Linear:
+            for (; written < frames && position < srcFrames; ++written)
+            {
+                const auto frame = static_cast<std::int64_t>(position);
+                const float t = static_cast<float>(position - frame);
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float a = sampleAt(src, count, frame, ch);
+                    const float b = sampleAt(src, count, frame + 1, ch);
+                    dst[written * 2 + ch] +=
+                        (a + (b - a) * t) * (ch ? gainRight : gainLeft);
+                }
+                position += step;
+            }
+            break;
+
+        case ResampleQuality::Cubic:
+            for (; written < frames && position < srcFrames; ++written)
+            {
+                const auto frame = static_cast<std::int64_t>(position);
+                const float t = static_cast<float>(position - frame);
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float value =
+                        hermite(sampleAt(src, count, frame - 1, ch),
+                                sampleAt(src, count, frame, ch),
+                                sampleAt(src, count, frame + 1, ch),
+                                sampleAt(src, count, frame + 2, ch), t);
+                    dst[written * 2 + ch] +=
+                        value * (ch ? gainRight : gainLeft);
+                }
+                position += step;
+            }
+            break;
+
+        case ResampleQuality::Sinc:
+            written = step > 1.0
+                          ? sincDecimate(dst, frames, src, count, position,
+                                         step, gainLeft, gainRight)
+                          : sincInterpolate(dst, frames, src, count, position,
+                                            step, gainLeft, gainRight);
+            break;
+        }
+        return written;
+    }
+} // namespace dtracker::audio::dsp
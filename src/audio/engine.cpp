@@ -1,67 +1,240 @@
+#include <algorithm>
+#include <chrono>
+#include <dtracker/audio/backend/rtaudio_backend.hpp>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
 #include <dtracker/audio/engine.hpp>
 #include <dtracker/audio/playback/tone_playback.hpp>
 #include <dtracker/audio/types.hpp>
 #include <iostream>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include <stdexcept>
+#include <thread>
 
 namespace dtracker::audio
 {
+    namespace
+    {
+        // One worker per core, leaving a core for the audio thread itself.
+        size_t defaultRenderThreadCount()
+        {
+            const unsigned int cores = std::thread::hardware_concurrency();
+            return cores > 1 ? cores - 1 : 0;
+        }
 
-    // RtAudio callback that fills the output buffer by rendering from the
-    // current playback unit.
+        // What the audio thread managed to set up, as published flags.
+        constexpr unsigned int kRealtimeApplied = 1u << 0;
+        constexpr unsigned int kDenormalsFlushed = 1u << 1;
+        constexpr unsigned int kPinned = 1u << 2;
+        constexpr unsigned int kPriorityRaised = 1u << 3;
+    } // namespace
+
+    // Backend callback that fills the output buffer by rendering from the
+    // engine's playback graph.
     // It runs on a high-priority, real-time audio thread.
-    // The 'userData' is a raw pointer to the main playback unit (the proxy).
-    int audioCallback(void *outputBuffer, void * /*inputBuffer*/,
-                      unsigned int nFrames, double /*streamTime*/,
-                      RtAudioStreamStatus status, void *userData)
+    // The 'userData' is a raw pointer to the engine.
+    void Engine::audioCallback(float *buffer, unsigned int nFrames,
+                               unsigned int channels, bool xrun,
+                               void *userData)
     {
-        if (status)
-            std::cerr << "Stream underflow/overflow detected!\n";
+        static_cast<Engine *>(userData)->processBlock(buffer, nFrames,
+                                                      channels, xrun);
+    }
 
-        dtracker::audio::types::RenderContext context;
+    void Engine::processBlock(float *buffer, unsigned int nFrames,
+                              unsigned int channels, bool xrun)
+    {
+        const auto callbackStart = std::chrono::steady_clock::now();
 
-        float *buffer = static_cast<float *>(outputBuffer);
-        constexpr unsigned int channels = 2;
+        // Thread settings can only be applied from the thread itself, and
+        // the backend creates it, so the first callback does it.
+        if (m_realtimePending)
+        {
+            applyRealtimeSettings();
+            m_realtimePending = false;
+        }
 
         // Always clear the buffer to prevent leftover audio artifacts.
-        std::memset(buffer, 0, sizeof(float) * nFrames * channels);
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
+
+        // A new quantum only takes over once the old one's carried frames
+        // have been played, so no rendered audio is dropped.
+        if (m_carryFrames == 0)
+            m_activeQuantum =
+                m_processingQuantum.load(std::memory_order_relaxed);
+
+        // Each size gets its own loop with the quantum as a constant. The
+        // carry buffer was sized for the channel count at open.
+        const bool fitsCarry =
+            static_cast<size_t>(kMaxProcessingQuantum) * channels <=
+            m_carry.size();
+        switch (fitsCarry ? m_activeQuantum : 0)
+        {
+        case 32:
+            processQuanta<32>(buffer, nFrames, channels);
+            break;
+        case 64:
+            processQuanta<64>(buffer, nFrames, channels);
+            break;
+        case 128:
+            processQuanta<128>(buffer, nFrames, channels);
+            break;
+        default:
+            processDeviceBlock(buffer, nFrames, channels);
+            break;
+        }
+
+        // Counting and logging replace printing: the GUI polls the monitor
+        // and the log's flusher prints, so the audio thread never takes the
+        // iostream lock.
+        if (xrun)
+            m_log.write(LogLevel::Warning, "AudioEngine",
+                        "stream underflow/overflow detected",
+                        m_transport.frame());
+
+        const auto elapsed = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                      callbackStart);
+        const std::uint64_t bufferNanos =
+            m_settings.sampleRate
+                ? std::uint64_t{nFrames} * 1000000000u / m_settings.sampleRate
+                : 0;
+        m_monitor.recordCallback(static_cast<std::uint64_t>(elapsed.count()),
+                                 bufferNanos, xrun);
+        m_monitor.setActiveUnits(m_mixerUnit->unitCount());
+    }
+
+    template <unsigned int Quantum>
+    void Engine::processQuanta(float *buffer, unsigned int nFrames,
+                               unsigned int channels)
+    {
+        static_assert(Quantum > 0 && Quantum <= kMaxProcessingQuantum,
+                      "Quantum must fit the carry buffer");
 
-        // Only attempt rendering if a valid unit is provided
-        if (auto *unit = static_cast<playback::ProxyPlaybackUnit *>(userData))
+        // Play what is left of the quantum rendered for the last buffer.
+        unsigned int written = std::min(m_carryFrames, nFrames);
+        if (written > 0)
         {
-            context.isLooping = unit->isLooping();
-            context.bpm = unit->bpm(); // Get the current BPM
-            unit->render(buffer, nFrames, channels, context);
+            const float *carried =
+                m_carry.data() +
+                static_cast<size_t>(Quantum - m_carryFrames) * channels;
+            std::copy(carried,
+                      carried + static_cast<size_t>(written) * channels,
+                      buffer);
+            m_carryFrames -= written;
         }
-        else
+
+        // Whole quanta are rendered straight into the device buffer.
+        while (nFrames - written >= Quantum)
         {
-            std::cerr << "AudioEngine: No playback unit provided to callback\n";
+            renderSubBlock(buffer + static_cast<size_t>(written) * channels,
+                           Quantum, channels);
+            written += Quantum;
         }
 
-        return 0; // Continues stream
+        // The tail gets a full quantum too; what does not fit is carried.
+        if (written < nFrames)
+        {
+            renderSubBlock(m_carry.data(), Quantum, channels);
+            const unsigned int rest = nFrames - written;
+            std::copy(m_carry.data(),
+                      m_carry.data() + static_cast<size_t>(rest) * channels,
+                      buffer + static_cast<size_t>(written) * channels);
+            m_carryFrames = Quantum - rest;
+        }
+    }
+
+    // The arena is sized for the block size negotiated at open. Should the
+    // backend ever hand us a larger block, render it in pieces rather than
+    // run out of scratch memory.
+    void Engine::processDeviceBlock(float *buffer, unsigned int nFrames,
+                                    unsigned int channels)
+    {
+        const unsigned int maxFrames =
+            m_scratchArena.blockFrames() ? m_scratchArena.blockFrames()
+                                         : nFrames;
+        for (unsigned int offset = 0; offset < nFrames; offset += maxFrames)
+        {
+            const unsigned int frames = std::min(maxFrames, nFrames - offset);
+            renderSubBlock(buffer + static_cast<size_t>(offset) * channels,
+                           frames, channels);
+        }
     }
 
-    // Sets up RtAudio and the device manager
-    Engine::Engine()
-        : m_audio(std::make_unique<RtAudio>()),
-          m_proxyUnit(std::make_unique<playback::ProxyPlaybackUnit>()),
-          m_mixerUnit(std::make_unique<playback::MixerPlaybackUnit>())
+    // The global playback state is read for every sub-block, so a tempo or
+    // looping change lands on a quantum boundary.
+    void Engine::renderSubBlock(float *buffer, unsigned int nFrames,
+                                unsigned int channels)
     {
+        types::RenderContext context;
+
+        // The proxy carries the global playback state set by the GUI.
+        context.isLooping = m_proxyUnit->isLooping();
+        context.bpm = m_proxyUnit->bpm(); // Get the current BPM
+        context.sampleRate = m_settings.sampleRate;
+        context.resampleQuality = m_proxyUnit->resampleQuality();
+        context.reclaim = m_reclaimQueue.get();
+        context.scratch = &m_scratchArena;
+        context.workers = m_workerPool.get();
+        context.monitor = &m_monitor;
+        context.log = &m_log;
+        context.frame = m_transport.frame();
+
+        m_proxyUnit->render(buffer, nFrames, channels, context);
+        m_transport.advance(nFrames);
+        m_monitor.publishVoices();
+    }
+
+    // Each setting is tried on its own; one being refused does not stop
+    // the others.
+    void Engine::applyRealtimeSettings()
+    {
+        unsigned int flags = kRealtimeApplied;
+        if (m_streamRealtime.flushDenormals && realtime::flushDenormals())
+            flags |= kDenormalsFlushed;
+        if (m_streamRealtime.cpuCore >= 0 &&
+            realtime::pinToCore(m_streamRealtime.cpuCore))
+            flags |= kPinned;
+        if (m_streamRealtime.raisePriority && realtime::raisePriority())
+            flags |= kPriorityRaised;
+        m_realtimeFlags.store(flags, std::memory_order_release);
+    }
+
+    // Sets up the default RtAudio backend
+    Engine::Engine() : Engine(std::make_unique<backend::RtAudioBackend>()) {}
+
+    // Sets up the playback graph on top of the given backend
+    Engine::Engine(std::unique_ptr<backend::IAudioBackend> backend)
+        : m_backend(std::move(backend)),
+          m_reclaimQueue(std::make_unique<playback::ReclaimQueue>()),
+          m_renderThreads(defaultRenderThreadCount()),
+          m_mixerUnit(std::make_unique<playback::MixerPlaybackUnit>()),
+          m_proxyUnit(std::make_unique<playback::ProxyPlaybackUnit>())
+    {
+        if (!m_backend)
+            throw std::invalid_argument("Engine requires an audio backend.");
+
         std::cout << "AudioEngine: Initialized\n";
 
         // Route all audio through the proxy, which then delegates to the main
         // mixer. This decouples the C-style callback from the rest of the
         // system.
         m_proxyUnit->setDelegate(m_mixerUnit.get());
-        m_audio->setErrorCallback(
-            [](RtAudioErrorType type, const std::string &errorText)
-            {
-                std::cerr << "[RtAudio Error] (" << static_cast<int>(type)
-                          << "): " << errorText << "\n";
-            });
+
+        // Pick the SIMD mixing kernels now rather than on the first callback.
+        std::cout << "AudioEngine: Mixing with "
+                  << dsp::instructionSetName(dsp::activeInstructionSet())
+                  << " kernels\n";
+
+        // Anything the audio thread retires is destroyed on this thread.
+        m_reclaimQueue->startCollector();
+
+        // And anything it logs is printed on another.
+        m_log.startFlusher();
+    }
+
+    // The backend must stop calling into the graph before it is destroyed.
+    Engine::~Engine()
+    {
+        stop();
     }
 
     // Start the audio engine stream with the currently selected device
@@ -69,15 +242,16 @@ namespace dtracker::audio
     {
         std::cout << "AudioEngine: Starting...\n";
 
-        // A device must be selected before the engine can start.
-        if (!m_selectedDeviceId.has_value())
+        // A device must be selected before the engine can start, unless the
+        // backend does not use one.
+        if (m_backend->requiresDevice() && !m_selectedDeviceId.has_value())
         {
             std::cerr << "AudioEngine: No output device set\n";
             return false;
         }
 
-        // openStream handles the actual interaction with RtAudio.
-        const bool success = openStream(*m_selectedDeviceId);
+        // openStream handles the actual interaction with the backend.
+        const bool success = openStream(m_selectedDeviceId);
         if (success)
             // Update state if successful.
             m_started = true;
@@ -90,56 +264,65 @@ namespace dtracker::audio
         if (!m_started)
             return;
 
-        // Stop the stream.
-        if (m_audio->isStreamRunning())
-        {
-            auto err = m_audio->stopStream();
-            if (err != RTAUDIO_NO_ERROR)
-            {
-                std::cerr << "AudioEngine: Failed to stop stream ("
-                          << static_cast<int>(err)
-                          << "): " << m_audio->getErrorText() << "\n";
-            }
-        }
-
-        // Close the stream
-        if (m_audio->isStreamOpen())
-        {
-            m_audio
-                ->closeStream(); // No return value; error goes through callback
-        }
+        m_backend->closeStream();
 
         m_started = false;
         std::cout << "AudioEngine: Engine stopped\n";
     }
 
-    // Internal helper that configures and opens the RtAudio stream.
-    bool Engine::openStream(unsigned int deviceId)
+    // Internal helper that configures, opens and starts the backend stream.
+    bool Engine::openStream(std::optional<unsigned int> deviceId)
     {
-        RtAudio::StreamParameters outputParams;
-        outputParams.deviceId = deviceId;
-        outputParams.nChannels = m_settings.outputChannels;
-        outputParams.firstChannel = 0;
-
         // Bind the C-style callback to our running engine instance by passing
-        // a pointer to the proxy unit as the userdata argument.
-        auto err = m_audio->openStream(
-            &outputParams, nullptr, RTAUDIO_FLOAT32, m_settings.sampleRate,
-            &m_settings.bufferFrames, &audioCallback, m_proxyUnit.get());
-
-        if (err != RTAUDIO_NO_ERROR)
+        // a pointer to the engine as the userdata argument.
+        if (!m_backend->openStream(deviceId, m_settings, &Engine::audioCallback,
+                                   this))
         {
-            std::cerr << "AudioEngine: Failed to open stream: "
-                      << m_audio->getErrorText() << "\n";
+            std::cerr << "AudioEngine: Failed to open stream\n";
             return false;
         }
 
+        // The audio thread applies its settings on the first callback. Lock
+        // the pools and sample data now, so that callback cannot fault.
+        {
+            std::lock_guard<std::mutex> lock(m_lockedRegionsMutex);
+            m_streamRealtime = m_realtimeOptions;
+            syncLockedMemory();
+        }
+        m_realtimeFlags.store(0, std::memory_order_relaxed);
+        m_realtimePending = m_streamRealtime.enabled;
+
+        // The backend may have adjusted the block size; size the scratch
+        // arena for what it actually negotiated, or for the largest quantum
+        // if that is bigger. The stream is not running yet, so the audio
+        // thread cannot be using it.
+        const unsigned int blockFrames =
+            std::max(m_settings.bufferFrames, kMaxProcessingQuantum);
+        m_scratchArena.configure(blockFrames, m_settings.outputChannels);
+
+        // Rebuild the worker pool for the same block shape. Workers are
+        // spawned here, off the audio thread, and then sleep until needed.
+        // The audio thread spins on them, so only workers that get realtime
+        // priority take part.
+        m_workerPool.reset();
+        if (m_renderThreads > 0)
+            m_workerPool = std::make_unique<playback::RenderWorkerPool>(
+                m_renderThreads, playback::MixerPlaybackUnit::kMaxUnits,
+                blockFrames, m_settings.outputChannels,
+                m_streamRealtime.enabled && m_streamRealtime.flushDenormals,
+                true);
+
+        // A fresh stream starts on a quantum boundary.
+        m_carry.assign(static_cast<size_t>(kMaxProcessingQuantum) *
+                           m_settings.outputChannels,
+                       0.0f);
+        m_carryFrames = 0;
+
         // Start the stream.
-        err = m_audio->startStream();
-        if (err != RTAUDIO_NO_ERROR)
+        if (!m_backend->startStream())
         {
-            std::cerr << "AudioEngine: Failed to start stream: "
-                      << m_audio->getErrorText() << "\n";
+            std::cerr << "AudioEngine: Failed to start stream\n";
+            m_backend->closeStream();
             return false;
         }
 
@@ -150,13 +333,13 @@ namespace dtracker::audio
     // Returns true if the audio stream is open.
     bool Engine::isStreamOpen() const
     {
-        return m_audio->isStreamOpen();
+        return m_backend->isStreamOpen();
     }
 
     // Returns true if the audio stream is currently running.
     bool Engine::isStreamRunning() const
     {
-        return m_audio->isStreamRunning();
+        return m_backend->isStreamRunning();
     }
 
     // Returns the current active output device info, if available.
@@ -165,26 +348,167 @@ namespace dtracker::audio
         return m_selectedDeviceId;
     }
 
+    backend::IAudioBackend *Engine::audioBackend() const
+    {
+        return m_backend.get();
+    }
+
+    playback::ReclaimQueue *Engine::reclaimQueue() const
+    {
+        return m_reclaimQueue.get();
+    }
+
+    RtLog &Engine::realtimeLog()
+    {
+        return m_log;
+    }
+
+    const playback::Transport &Engine::transport() const
+    {
+        return m_transport;
+    }
+
+    void Engine::setRenderThreadCount(size_t count)
+    {
+        m_renderThreads = count;
+    }
+
+    size_t Engine::renderThreadCount() const
+    {
+        return m_renderThreads;
+    }
+
+    bool Engine::setProcessingQuantum(unsigned int frames)
+    {
+        if (!isSupportedQuantum(frames))
+        {
+            std::cerr << "AudioEngine: Unsupported processing quantum "
+                      << frames << "\n";
+            return false;
+        }
+
+        m_processingQuantum.store(frames, std::memory_order_relaxed);
+        return true;
+    }
+
+    unsigned int Engine::processingQuantum() const
+    {
+        return m_processingQuantum.load(std::memory_order_relaxed);
+    }
+
+    void Engine::setRealtimeOptions(const realtime::Options &options)
+    {
+        m_realtimeOptions = options;
+    }
+
+    const realtime::Options &Engine::realtimeOptions() const
+    {
+        return m_realtimeOptions;
+    }
+
+    PerformanceSnapshot Engine::performanceSnapshot() const
+    {
+        PerformanceSnapshot snapshot = m_monitor.snapshot();
+        snapshot.scratchOverflows = m_scratchArena.overflowCount();
+        if (m_workerPool)
+            snapshot.scratchOverflows += m_workerPool->scratchOverflowCount();
+        return snapshot;
+    }
+
+    void Engine::resetPerformanceCounters()
+    {
+        m_monitor.reset();
+    }
+
+    realtime::Report Engine::realtimeReport() const
+    {
+        const unsigned int flags =
+            m_realtimeFlags.load(std::memory_order_acquire);
+
+        realtime::Report report;
+        report.applied = flags & kRealtimeApplied;
+        report.denormalsFlushed = flags & kDenormalsFlushed;
+        report.pinned = flags & kPinned;
+        report.priorityRaised = flags & kPriorityRaised;
+        if (m_workerPool)
+        {
+            report.renderWorkers = m_workerPool->workerCount();
+            report.realtimeRenderWorkers = m_workerPool->activeWorkerCount();
+        }
+
+        std::lock_guard<std::mutex> lock(m_lockedRegionsMutex);
+        report.memoryLocked = !m_lockedRegions.empty();
+        for (const LockedRegion &region : m_lockedRegions)
+        {
+            if (region.locked)
+                report.lockedBytes += region.bytes;
+            else
+                report.memoryLocked = false;
+        }
+        return report;
+    }
+
+    // Regions registered while a locking stream is open are locked at once;
+    // the rest wait for the next openStream().
+    bool Engine::lockMemory(const void *data, size_t bytes)
+    {
+        if (!data || bytes == 0)
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_lockedRegionsMutex);
+        LockedRegion region{data, bytes, false};
+        if (isStreamOpen() && m_streamRealtime.enabled &&
+            m_streamRealtime.lockMemory)
+            region.locked = realtime::lockMemory(data, bytes);
+        m_lockedRegions.push_back(region);
+        return region.locked;
+    }
+
+    void Engine::unlockMemory(const void *data, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_lockedRegionsMutex);
+        auto it = std::find_if(m_lockedRegions.begin(), m_lockedRegions.end(),
+                               [&](const LockedRegion &region) {
+                                   return region.data == data &&
+                                          region.bytes == bytes;
+                               });
+        if (it == m_lockedRegions.end())
+            return;
+
+        if (it->locked)
+            realtime::unlockMemory(it->data, it->bytes);
+        m_lockedRegions.erase(it);
+    }
+
+    // Called with m_lockedRegionsMutex held.
+    void Engine::syncLockedMemory()
+    {
+        const bool wanted =
+            m_streamRealtime.enabled && m_streamRealtime.lockMemory;
+        for (LockedRegion &region : m_lockedRegions)
+        {
+            if (wanted && !region.locked)
+            {
+                region.locked = realtime::lockMemory(region.data, region.bytes);
+            }
+            else if (!wanted && region.locked)
+            {
+                realtime::unlockMemory(region.data, region.bytes);
+                region.locked = false;
+            }
+        }
+    }
+
     // Sets the selected output device.
     void Engine::setOutputDevice(unsigned int deviceId)
     {
         m_selectedDeviceId = deviceId;
     }
 
-    // Creates a device manager with a reference to the internal RtAudio
-    // instance.
+    // Creates a device manager through the backend.
     DeviceManager Engine::createDeviceManager() const
     {
-        if (!m_audio)
-            throw std::runtime_error(
-                "Cannot create DeviceManager: m_audio is null");
-        return DeviceManager(m_audio.get());
-    }
-
-    // Get a const pointer to the proxyPlaybackUnit.
-    playback::ProxyPlaybackUnit *Engine::proxyPlaybackUnit()
-    {
-        return m_proxyUnit.get();
+        return m_backend->createDeviceManager();
     }
 
     // Get access to the mixer unit.
@@ -200,7 +524,6 @@ namespace dtracker::audio
 
     const types::AudioSettings &dtracker::audio::Engine::getSettings() const
     {
-        // TODO: insert return statement here
         return m_settings;
     }
 
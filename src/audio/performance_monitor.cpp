@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <dtracker/audio/performance_monitor.hpp>
+
+namespace dtracker::audio
+{
+    // Only the audio thread writes, so read-modify-writes are plain loads
+    // and stores; readers only need each value to be whole.
+    void PerformanceMonitor::recordCallback(std::uint64_t elapsedNanos,
+                                            std::uint64_t bufferNanos,
+                                            bool xrun)
+    {
+        const std::uint64_t load =
+            bufferNanos ? elapsedNanos * kLoadScale / bufferNanos : 0;
+
+        const auto bump = [](std::atomic<std::uint64_t> &counter,
+                             std::uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount,
+                          std::memory_order_relaxed);
+        };
+
+        bump(m_callbacks, 1);
+        bump(m_loadSum, load);
+        if (xrun)
+            bump(m_xruns, 1);
+        if (load > kLoadScale)
+            bump(m_overloads, 1);
+
+        m_lastNanos.store(elapsedNanos, std::memory_order_relaxed);
+        m_lastLoad.store(load, std::memory_order_relaxed);
+        if (load > m_peakLoad.load(std::memory_order_relaxed))
+            m_peakLoad.store(load, std::memory_order_relaxed);
+
+        constexpr auto kBinLoad = static_cast<std::uint64_t>(
+            PerformanceSnapshot::kLoadBinWidth * kLoadScale);
+        const size_t bin = std::min<std::uint64_t>(
+            load / kBinLoad, PerformanceSnapshot::kLoadBins - 1);
+        bump(m_histogram[bin], 1);
+    }
+
+    void PerformanceMonitor::setActiveUnits(size_t count)
+    {
+        m_activeUnits.store(count, std::memory_order_relaxed);
+    }
+
+    void PerformanceMonitor::countVoices(size_t count)
+    {
+        m_voiceTally.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void PerformanceMonitor::publishVoices()
+    {
+        const size_t voices =
+            m_voiceTally.exchange(0, std::memory_order_relaxed);
+        m_activeVoices.store(voices, std::memory_order_relaxed);
+    }
+
+    PerformanceSnapshot PerformanceMonitor::snapshot() const
+    {
+        constexpr float kScale = static_cast<float>(kLoadScale);
+
+        PerformanceSnapshot snapshot;
+        snapshot.callbacks = m_callbacks.load(std::memory_order_relaxed);
+        snapshot.xruns = m_xruns.load(std::memory_order_relaxed);
+        snapshot.overloads = m_overloads.load(std::memory_order_relaxed);
+        snapshot.lastCallbackNanos =
+            m_lastNanos.load(std::memory_order_relaxed);
+        snapshot.load = m_lastLoad.load(std::memory_order_relaxed) / kScale;
+        snapshot.peakLoad =
+            m_peakLoad.load(std::memory_order_relaxed) / kScale;
+        if (snapshot.callbacks > 0)
+            snapshot.averageLoad =
+                static_cast<float>(m_loadSum.load(std::memory_order_relaxed)) /
+                (kScale * snapshot.callbacks);
+
+        snapshot.activeUnits = m_activeUnits.load(std::memory_order_relaxed);
+        snapshot.activeVoices =
+            m_activeVoices.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < m_histogram.size(); ++i)
+            snapshot.loadHistogram[i] =
+                m_histogram[i].load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    // Meant for the control thread while the stream is stopped; a reset
+    // that races a callback can leave that one callback half counted.
+    void PerformanceMonitor::reset()
+    {
+        for (auto *counter : {&m_callbacks, &m_xruns, &m_overloads,
+                              &m_lastNanos, &m_lastLoad, &m_peakLoad,
+                              &m_loadSum})
+            counter->store(0, std::memory_order_relaxed);
+        for (auto &bin : m_histogram)
+            bin.store(0, std::memory_order_relaxed);
+
+        m_activeUnits.store(0, std::memory_order_relaxed);
+        m_activeVoices.store(0, std::memory_order_relaxed);
+        m_voiceTally.store(0, std::memory_order_relaxed);
+    }
+} // namespace dtracker::audio
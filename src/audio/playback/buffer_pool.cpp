@@ -38,6 +38,17 @@ namespace dtracker::audio::playback
                                                { this->release(b); });
     }
 
+    // Each buffer's samples live in their own allocation.
+    void BufferPool::forEachRegion(
+        const std::function<void(const void *, size_t)> &visit) const
+    {
+        visit(m_pool.data(), m_pool.size() * sizeof(types::PCMData));
+        visit(m_freeList.data(),
+              m_freeList.capacity() * sizeof(types::PCMData *));
+        for (const types::PCMData &buffer : m_pool)
+            visit(buffer.data(), buffer.size() * sizeof(float));
+    }
+
     void BufferPool::release(types::PCMData *buffer)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/playback/compiled_graph.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+
+namespace dtracker::audio::playback
+{
+    CompiledGraph::CompiledGraph(std::vector<GraphNode> nodes,
+                                 std::vector<std::uint32_t> sources,
+                                 std::vector<GraphStep> steps,
+                                 size_t slotCount, size_t outputNode,
+                                 size_t slotSamples)
+        : m_nodes(std::move(nodes)), m_sources(std::move(sources)),
+          m_steps(std::move(steps)), m_slotCount(slotCount),
+          m_outputNode(outputNode), m_slotSamples(slotSamples)
+    {
+        // Every buffer the process list touches is allocated here, once.
+        m_slots.assign(m_slotCount * m_slotSamples, 0.0f);
+    }
+
+    // Overwrites the buffer with one block of the graph.
+    void CompiledGraph::render(float *buffer, unsigned int nFrames,
+                               unsigned int channels,
+                               const types::RenderContext &context)
+    {
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
+        renderAdd(buffer, nFrames, channels, context, 1.0f, 1.0f);
+    }
+
+    // Slots were sized for the block size at compile time. Larger blocks are
+    // processed in pieces that fit.
+    void CompiledGraph::renderAdd(float *buffer, unsigned int nFrames,
+                                  unsigned int channels,
+                                  const types::RenderContext &context,
+                                  float gainLeft, float gainRight)
+    {
+        if (channels == 0 || m_slotSamples < channels)
+            return;
+
+        const unsigned int maxFrames =
+            static_cast<unsigned int>(m_slotSamples / channels);
+        types::RenderContext chunkContext = context;
+        for (unsigned int offset = 0; offset < nFrames; offset += maxFrames)
+        {
+            const unsigned int frames = std::min(maxFrames, nFrames - offset);
+            chunkContext.frame = context.frame + offset;
+            process(buffer + static_cast<size_t>(offset) * channels, frames,
+                    channels, chunkContext, gainLeft, gainRight);
+        }
+    }
+
+    // The heart of the graph: one pass over the process list.
+    void CompiledGraph::process(float *output, unsigned int nFrames,
+                                unsigned int channels,
+                                const types::RenderContext &context,
+                                float gainLeft, float gainRight)
+    {
+        const size_t samples = static_cast<size_t>(nFrames) * channels;
+
+        for (const GraphStep &step : m_steps)
+        {
+            float *dst =
+                step.dst == GraphStep::kOutputSlot ? output : slotData(step.dst);
+            switch (step.op)
+            {
+            case GraphStep::Op::Clear:
+                dsp::clear(dst, samples);
+                break;
+
+            case GraphStep::Op::RenderSources:
+                renderSources(dst, step.src, step.count, nFrames, channels,
+                              context);
+                break;
+
+            case GraphStep::Op::MixBus:
+            {
+                float left = 1.0f;
+                float right = 1.0f;
+                nodeGains(m_nodes[step.node], channels, left, right);
+
+                // Only the final mix into the caller's buffer carries the
+                // caller's gains.
+                if (step.dst == GraphStep::kOutputSlot)
+                {
+                    left *= gainLeft;
+                    right *= gainRight;
+                }
+
+                const float *src = slotData(step.src);
+                if (channels == 2)
+                    dsp::accumulateStereo(dst, src, left, right, nFrames);
+                else
+                    dsp::accumulateScaled(dst, src, left, samples);
+                break;
+            }
+            }
+        }
+    }
+
+    void CompiledGraph::renderSources(float *output, size_t first,
+                                      size_t count, unsigned int nFrames,
+                                      unsigned int channels,
+                                      const types::RenderContext &context)
+    {
+        RenderWorkerPool *workers = context.workers;
+        if (workers && count > 1 && workers->canRun(count, nFrames, channels))
+        {
+            // Render each source into its own buffer in parallel, then sum
+            // them in order so the result does not depend on scheduling.
+            m_batchFirst = first;
+            workers->run(count, &CompiledGraph::renderSourceTask, this,
+                         context, nFrames, channels);
+            const size_t samples = static_cast<size_t>(nFrames) * channels;
+            for (size_t i = 0; i < count; ++i)
+                dsp::accumulate(output, workers->slot(i), samples);
+            return;
+        }
+
+        for (size_t i = first; i < first + count; ++i)
+        {
+            const GraphNode &node = m_nodes[m_sources[i]];
+            float left = 1.0f;
+            float right = 1.0f;
+            nodeGains(node, channels, left, right);
+            node.unit->renderAdd(output, nFrames, channels, context, left,
+                                 right);
+        }
+    }
+
+    // Runs on a pool worker or the audio thread. Each index is rendered by
+    // exactly one thread.
+    void CompiledGraph::renderSourceTask(void *userData, size_t index,
+                                         float *output, unsigned int nFrames,
+                                         unsigned int channels,
+                                         const types::RenderContext &context)
+    {
+        auto *graph = static_cast<CompiledGraph *>(userData);
+        const GraphNode &node =
+            graph->m_nodes[graph->m_sources[graph->m_batchFirst + index]];
+        float left = 1.0f;
+        float right = 1.0f;
+        nodeGains(node, channels, left, right);
+        node.unit->renderAdd(output, nFrames, channels, context, left, right);
+    }
+
+    void CompiledGraph::nodeGains(const GraphNode &node, unsigned int channels,
+                                  float &gainLeft, float &gainRight)
+    {
+        gainLeft = node.volume;
+        gainRight = node.volume;
+        if (channels == 2)
+            dsp::panGains(node.volume, node.pan, gainLeft, gainRight);
+    }
+
+    float *CompiledGraph::slotData(std::uint32_t slot)
+    {
+        return m_slots.data() + static_cast<size_t>(slot) * m_slotSamples;
+    }
+
+    void CompiledGraph::reset()
+    {
+        for (std::uint32_t source : m_sources)
+            m_nodes[source].unit->reset();
+    }
+
+    void CompiledGraph::setParameter(UnitParam param, float value)
+    {
+        GraphNode &output = m_nodes[m_outputNode];
+        switch (param)
+        {
+        case UnitParam::Volume:
+            output.volume = std::clamp(value, 0.0f, 1.0f);
+            break;
+        case UnitParam::Pan:
+            output.pan = std::clamp(value, -1.0f, 1.0f);
+            break;
+        }
+    }
+
+    bool CompiledGraph::isFinished() const
+    {
+        return std::all_of(m_sources.begin(), m_sources.end(),
+                           [this](std::uint32_t source)
+                           { return m_nodes[source].unit->isFinished(); });
+    }
+
+    const std::vector<GraphStep> &CompiledGraph::steps() const
+    {
+        return m_steps;
+    }
+
+    size_t CompiledGraph::slotCount() const
+    {
+        return m_slotCount;
+    }
+} // namespace dtracker::audio::playback
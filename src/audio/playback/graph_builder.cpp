@@ -0,0 +1,229 @@
+#include <dtracker/audio/playback/graph_builder.hpp>
+#include <iostream>
+
+namespace dtracker::audio::playback
+{
+    GraphBuilder::NodeId
+    GraphBuilder::addSource(std::shared_ptr<PlaybackUnit> unit, float volume,
+                            float pan)
+    {
+        Node node;
+        node.data.unit = std::move(unit);
+        node.data.volume = volume;
+        node.data.pan = pan;
+        m_nodes.push_back(std::move(node));
+        return m_nodes.size() - 1;
+    }
+
+    GraphBuilder::NodeId GraphBuilder::addBus(float volume, float pan)
+    {
+        Node node;
+        node.data.volume = volume;
+        node.data.pan = pan;
+        node.isBus = true;
+        m_nodes.push_back(std::move(node));
+        return m_nodes.size() - 1;
+    }
+
+    bool GraphBuilder::connect(NodeId from, NodeId to)
+    {
+        if (from >= m_nodes.size() || to >= m_nodes.size() || from == to)
+        {
+            std::cerr << "GraphBuilder: invalid connection\n";
+            return false;
+        }
+        if (!isBus(to))
+        {
+            std::cerr << "GraphBuilder: only buses accept inputs\n";
+            return false;
+        }
+        if (!isBus(from) && m_nodes[from].consumers > 0)
+        {
+            std::cerr << "GraphBuilder: a source can only feed one bus\n";
+            return false;
+        }
+        if (!isBus(from) && !m_nodes[from].data.unit)
+        {
+            std::cerr << "GraphBuilder: source has no unit\n";
+            return false;
+        }
+
+        m_nodes[to].inputs.push_back(from);
+        m_nodes[from].consumers++;
+        return true;
+    }
+
+    size_t GraphBuilder::nodeCount() const
+    {
+        return m_nodes.size();
+    }
+
+    bool GraphBuilder::isBus(NodeId id) const
+    {
+        return m_nodes[id].isBus;
+    }
+
+    std::unique_ptr<CompiledGraph>
+    GraphBuilder::compile(NodeId output, unsigned int maxFrames,
+                          unsigned int channels) const
+    {
+        if (output >= m_nodes.size() || !isBus(output))
+        {
+            std::cerr << "GraphBuilder: output must be a bus\n";
+            return nullptr;
+        }
+        if (maxFrames == 0 || channels == 0)
+        {
+            std::cerr << "GraphBuilder: block size and channels must be "
+                      << "non-zero\n";
+            return nullptr;
+        }
+
+        const size_t nodeCount = m_nodes.size();
+
+        // 1. Find everything that feeds the output. Other nodes are dropped.
+        std::vector<bool> reachable(nodeCount, false);
+        std::vector<NodeId> stack{output};
+        reachable[output] = true;
+        while (!stack.empty())
+        {
+            const NodeId id = stack.back();
+            stack.pop_back();
+            for (NodeId input : m_nodes[id].inputs)
+            {
+                if (!reachable[input])
+                {
+                    reachable[input] = true;
+                    stack.push_back(input);
+                }
+            }
+        }
+
+        // 2. Order the reachable nodes so every node comes after all of its
+        // inputs (Kahn's algorithm). Ties go to the lower ID, so the same
+        // graph always compiles to the same process list.
+        std::vector<std::vector<NodeId>> consumers(nodeCount);
+        std::vector<size_t> pendingInputs(nodeCount, 0);
+        size_t reachableCount = 0;
+        for (NodeId id = 0; id < nodeCount; ++id)
+        {
+            if (!reachable[id])
+                continue;
+            ++reachableCount;
+            pendingInputs[id] = m_nodes[id].inputs.size();
+            for (NodeId input : m_nodes[id].inputs)
+                consumers[input].push_back(id);
+        }
+
+        std::vector<NodeId> order;
+        order.reserve(reachableCount);
+        for (NodeId id = 0; id < nodeCount; ++id)
+        {
+            if (reachable[id] && pendingInputs[id] == 0)
+                order.push_back(id);
+        }
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            for (NodeId consumer : consumers[order[i]])
+            {
+                if (--pendingInputs[consumer] == 0)
+                    order.push_back(consumer);
+            }
+        }
+
+        if (order.size() != reachableCount)
+        {
+            std::cerr << "GraphBuilder: graph has a cycle\n";
+            return nullptr;
+        }
+
+        // 3. Emit the process list, assigning each bus a slot from its
+        // first write until its last reader has consumed it. Freed slots
+        // are handed out again lowest first.
+        std::vector<GraphStep> steps;
+        std::vector<std::uint32_t> sources;
+        std::vector<std::uint32_t> slotOf(nodeCount, 0);
+        std::vector<size_t> usesLeft(nodeCount, 0);
+        std::vector<bool> slotInUse;
+
+        auto allocateSlot = [&slotInUse]() -> std::uint32_t
+        {
+            for (size_t slot = 0; slot < slotInUse.size(); ++slot)
+            {
+                if (!slotInUse[slot])
+                {
+                    slotInUse[slot] = true;
+                    return static_cast<std::uint32_t>(slot);
+                }
+            }
+            slotInUse.push_back(true);
+            return static_cast<std::uint32_t>(slotInUse.size() - 1);
+        };
+
+        for (NodeId id : order)
+        {
+            if (!isBus(id))
+                continue;
+
+            const Node &bus = m_nodes[id];
+            const std::uint32_t slot = allocateSlot();
+            slotOf[id] = slot;
+            // The output is read once more, by the final mix.
+            usesLeft[id] = id == output ? 1 : consumers[id].size();
+
+            GraphStep clear;
+            clear.op = GraphStep::Op::Clear;
+            clear.dst = slot;
+            steps.push_back(clear);
+
+            // Sources render straight into this bus's slot as one batch.
+            GraphStep render;
+            render.op = GraphStep::Op::RenderSources;
+            render.dst = slot;
+            render.src = static_cast<std::uint32_t>(sources.size());
+            for (NodeId input : bus.inputs)
+            {
+                if (!isBus(input))
+                    sources.push_back(static_cast<std::uint32_t>(input));
+            }
+            render.count = static_cast<std::uint32_t>(sources.size()) -
+                           render.src;
+            if (render.count > 0)
+                steps.push_back(render);
+
+            // Buses were processed earlier; mix their slots in.
+            for (NodeId input : bus.inputs)
+            {
+                if (!isBus(input))
+                    continue;
+
+                GraphStep mix;
+                mix.op = GraphStep::Op::MixBus;
+                mix.dst = slot;
+                mix.src = slotOf[input];
+                mix.node = static_cast<std::uint32_t>(input);
+                steps.push_back(mix);
+
+                if (--usesLeft[input] == 0)
+                    slotInUse[slotOf[input]] = false;
+            }
+        }
+
+        GraphStep finalMix;
+        finalMix.op = GraphStep::Op::MixBus;
+        finalMix.dst = GraphStep::kOutputSlot;
+        finalMix.src = slotOf[output];
+        finalMix.node = static_cast<std::uint32_t>(output);
+        steps.push_back(finalMix);
+
+        std::vector<GraphNode> nodes;
+        nodes.reserve(nodeCount);
+        for (const Node &node : m_nodes)
+            nodes.push_back(node.data);
+
+        return std::make_unique<CompiledGraph>(
+            std::move(nodes), std::move(sources), std::move(steps),
+            slotInUse.size(), output,
+            static_cast<size_t>(maxFrames) * channels);
+    }
+} // namespace dtracker::audio::playback
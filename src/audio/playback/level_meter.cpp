@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/playback/level_meter.hpp>
+
+namespace dtracker::audio::playback
+{
+    namespace
+    {
+        // Interpolation points between two samples for the true peak.
+        constexpr size_t kTruePeakPhases = 3;
+
+        // Levels below this (about -200 dB) are flushed to zero so falling
+        // peaks and averages never turn denormal.
+        constexpr float kSilence = 1e-10f;
+
+        using TruePeakFilter =
+            std::array<std::array<float, LevelMeter::kTruePeakTaps>,
+                       kTruePeakPhases>;
+
+        // A Hann-windowed sinc per phase, each normalized to unity gain. The
+        // point interpolated lies between taps 3 and 4.
+        const TruePeakFilter &truePeakFilter()
+        {
+            static const TruePeakFilter filter = []
+            {
+                constexpr double kPi = 3.14159265358979323846;
+                const double halfWidth = LevelMeter::kTruePeakTaps / 2.0;
+
+                TruePeakFilter phases{};
+                for (size_t p = 0; p < kTruePeakPhases; ++p)
+                {
+                    const double position =
+                        halfWidth - 1.0 + (p + 1.0) / (kTruePeakPhases + 1.0);
+                    double sum = 0.0;
+                    double taps[LevelMeter::kTruePeakTaps];
+                    for (size_t k = 0; k < LevelMeter::kTruePeakTaps; ++k)
+                    {
+                        const double d = static_cast<double>(k) - position;
+                        const double sinc =
+                            std::sin(kPi * d) / (kPi * d);
+                        const double window =
+                            0.5 * (1.0 + std::cos(kPi * d / halfWidth));
+                        taps[k] = sinc * window;
+                        sum += taps[k];
+                    }
+                    for (size_t k = 0; k < LevelMeter::kTruePeakTaps; ++k)
+                        phases[p][k] = static_cast<float>(taps[k] / sum);
+                }
+                return phases;
+            }();
+            return filter;
+        }
+
+        float settle(float level)
+        {
+            return level < kSilence ? 0.0f : level;
+        }
+    } // namespace
+
+    // Builds the shared filter here, so the audio thread never does.
+    LevelMeter::LevelMeter(unsigned int sampleRate)
+        : m_sampleRate(std::max(sampleRate, 1u))
+    {
+        truePeakFilter();
+    }
+
+    void LevelMeter::process(const float *samples, unsigned int frames,
+                             unsigned int channels, std::uint64_t frame)
+    {
+        if (frames == 0 || channels == 0 || channels > 2)
+            return;
+
+        // One pass gives both peaks and both sums of squares. Mono audio
+        // is split into even and odd samples, so fold those back together.
+        float peaks[2] = {0.0f, 0.0f};
+        float sums[2] = {0.0f, 0.0f};
+        dsp::measure(samples, static_cast<size_t>(frames) * channels, peaks,
+                     sums);
+        if (channels == 1)
+        {
+            peaks[0] = std::max(peaks[0], peaks[1]);
+            sums[0] += sums[1];
+        }
+
+        const float seconds =
+            static_cast<float>(frames) / static_cast<float>(m_sampleRate);
+        const float fall =
+            std::pow(10.0f, -kPeakFallDbPerSecond * seconds / 20.0f);
+        const float smoothing = 1.0f - std::exp(-seconds / kRmsWindowSeconds);
+        float truePeaks[2] = {peaks[0], peaks[1]};
+        if (m_truePeakEnabled.load(std::memory_order_relaxed))
+            interpolatedPeaks(samples, frames, channels, truePeaks);
+
+        for (unsigned int ch = 0; ch < channels; ++ch)
+        {
+            m_peak[ch] = settle(std::max(peaks[ch], m_peak[ch] * fall));
+
+            const float meanSquare = sums[ch] / static_cast<float>(frames);
+            m_meanSquare[ch] =
+                settle(m_meanSquare[ch] +
+                       smoothing * (meanSquare - m_meanSquare[ch]));
+
+            m_truePeak[ch] =
+                settle(std::max(truePeaks[ch], m_truePeak[ch] * fall));
+        }
+
+        if (channels == 1)
+        {
+            m_peak[1] = m_peak[0];
+            m_meanSquare[1] = m_meanSquare[0];
+            m_truePeak[1] = m_truePeak[0];
+        }
+
+        ++m_blocks;
+        publish(frame + frames);
+    }
+
+    // Each output sample comes from the last kTruePeakTaps input frames, so
+    // the line holds the frames carried over from the previous block and then
+    // a chunk of this one, interleaved as they arrive. A phase is then a sum
+    // of scaled, shifted copies of the line, and both channels are filtered
+    // and reduced at once: measure() keeps them apart in its even and odd
+    // lanes, which for mono audio are folded back together.
+    void LevelMeter::interpolatedPeaks(const float *samples,
+                                       unsigned int frames,
+                                       unsigned int channels, float *peaks)
+    {
+        const TruePeakFilter &filter = truePeakFilter();
+        const size_t carried = (kTruePeakTaps - 1) * channels;
+
+        // The carried frames are laid out for the old channel count.
+        if (channels != m_lineChannels)
+        {
+            m_line.fill(0.0f);
+            m_lineChannels = channels;
+        }
+
+        float phasePeaks[2] = {0.0f, 0.0f};
+        float sums[2] = {0.0f, 0.0f};
+        for (unsigned int start = 0; start < frames;
+             start += kTruePeakChunkFrames)
+        {
+            const size_t n =
+                static_cast<size_t>(
+                    std::min(frames - start, kTruePeakChunkFrames)) *
+                channels;
+            std::copy_n(samples + static_cast<size_t>(start) * channels, n,
+                        m_line.data() + carried);
+
+            for (const auto &taps : filter)
+            {
+                dsp::clear(m_phase.data(), n);
+                for (size_t k = 0; k < kTruePeakTaps; ++k)
+                    dsp::accumulateScaled(m_phase.data(),
+                                          m_line.data() + k * channels,
+                                          taps[k], n);
+                dsp::measure(m_phase.data(), n, phasePeaks, sums);
+            }
+
+            std::copy_n(m_line.data() + n, carried, m_line.data());
+        }
+
+        if (channels == 1)
+            phasePeaks[0] = std::max(phasePeaks[0], phasePeaks[1]);
+        for (unsigned int ch = 0; ch < channels; ++ch)
+            peaks[ch] = std::max(peaks[ch], phasePeaks[ch]);
+    }
+
+    // The fence keeps the level stores from being seen before the sequence
+    // turns odd.
+    void LevelMeter::publish(std::uint64_t frame)
+    {
+        const std::uint64_t sequence =
+            m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t ch = 0; ch < 2; ++ch)
+        {
+            m_publishedPeak[ch].store(m_peak[ch], std::memory_order_relaxed);
+            m_publishedRms[ch].store(std::sqrt(m_meanSquare[ch]),
+                                     std::memory_order_relaxed);
+            m_publishedTruePeak[ch].store(m_truePeak[ch],
+                                          std::memory_order_relaxed);
+        }
+        m_publishedFrame.store(frame, std::memory_order_relaxed);
+        m_publishedBlocks.store(m_blocks, std::memory_order_relaxed);
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void LevelMeter::setTruePeakEnabled(bool enabled)
+    {
+        m_truePeakEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool LevelMeter::truePeakEnabled() const
+    {
+        return m_truePeakEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Copies until no publish overlapped the copy. A publish takes a few
+    // stores, so retries are rare and short.
+    LevelReading LevelMeter::read() const
+    {
+        LevelReading reading;
+        for (;;)
+        {
+            const std::uint64_t before =
+                m_sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+
+            for (size_t ch = 0; ch < 2; ++ch)
+            {
+                reading.peak[ch] =
+                    m_publishedPeak[ch].load(std::memory_order_relaxed);
+                reading.rms[ch] =
+                    m_publishedRms[ch].load(std::memory_order_relaxed);
+                reading.truePeak[ch] =
+                    m_publishedTruePeak[ch].load(std::memory_order_relaxed);
+            }
+            reading.frame = m_publishedFrame.load(std::memory_order_relaxed);
+            reading.blocks =
+                m_publishedBlocks.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before)
+                return reading;
+        }
+    }
+} // namespace dtracker::audio::playback
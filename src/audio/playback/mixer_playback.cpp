@@ -1,24 +1,183 @@
-#include <cstring> // for std::memset
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
 #include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+#include <dtracker/audio/rt_log.hpp>
 #include <iostream>
+#include <thread>
 
 namespace dtracker::audio::playback
 {
-    void MixerPlaybackUnit::setBufferPool(BufferPool *pool)
+    void MixerPlaybackUnit::setWaveformTap(WaveformTap *tap)
     {
-        m_bufferPool = pool;
+        m_waveformTap.store(tap, std::memory_order_seq_cst);
+        waitForOutputPass();
     }
 
-    void MixerPlaybackUnit::setWaveformQueue(
-        rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *queue)
+    void MixerPlaybackUnit::setLevelMeter(LevelMeter *meter)
     {
-        m_waveformQueue = queue;
+        m_levelMeter.store(meter, std::memory_order_seq_cst);
+        waitForOutputPass();
     }
 
-    // Adds a new playback unit to the internal list
+    // The store above and the audio thread's increment are both sequentially
+    // consistent, so a pass that had not started when the counter was read
+    // here will load the new pointer. Only the pass in flight at that moment
+    // can still hold the old one, and it is done as soon as the counter
+    // moves on. This waits for at most one tap write and meter pass, however
+    // busy the audio thread is, and not at all when it is idle.
+    void MixerPlaybackUnit::waitForOutputPass() const
+    {
+        const uint64_t pass = m_outputPass.load(std::memory_order_seq_cst);
+        if ((pass & 1) == 0)
+            return;
+
+        while (m_outputPass.load(std::memory_order_acquire) == pass)
+            std::this_thread::yield();
+    }
+
+    MixerPlaybackUnit::MixerPlaybackUnit()
+    {
+        // Reserve up front so applying an AddUnit never allocates on the
+        // audio thread.
+        m_units.reserve(kMaxUnits);
+    }
+
+    // Queues a new playback unit to be added on the next block
     void MixerPlaybackUnit::addUnit(std::shared_ptr<PlaybackUnit> unit)
     {
-        m_units.push_back(std::move(unit));
+        if (!unit)
+            return;
+
+        GraphCommand command;
+        command.type = GraphCommand::Type::AddUnit;
+        command.unit = std::move(unit);
+        if (!submit(std::move(command)))
+            std::cerr << "MixerPlaybackUnit: command queue full, "
+                      << "dropping unit\n";
+    }
+
+    // Queues a unit to be removed on the next block
+    void MixerPlaybackUnit::removeUnit(std::shared_ptr<PlaybackUnit> unit)
+    {
+        GraphCommand command;
+        command.type = GraphCommand::Type::RemoveUnit;
+        command.unit = std::move(unit);
+        submit(std::move(command));
+    }
+
+    // Queues a parameter change to be applied on the next block
+    void MixerPlaybackUnit::setUnitParameter(std::shared_ptr<PlaybackUnit> unit,
+                                             UnitParam param, float value)
+    {
+        GraphCommand command;
+        command.type = GraphCommand::Type::SetParam;
+        command.unit = std::move(unit);
+        command.param = param;
+        command.value = value;
+        submit(std::move(command));
+    }
+
+    // Pushes a command onto the ring. Control threads serialize here so the
+    // single-consumer ring only ever sees one producer at a time, and so the
+    // bookkeeping counters stay in the same order as the commands.
+    bool MixerPlaybackUnit::submit(GraphCommand command)
+    {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+
+        const auto type = command.type;
+
+        // Count the command before the audio thread can possibly apply it.
+        if (type == GraphCommand::Type::AddUnit)
+            m_pendingAdds.fetch_add(1);
+        else if (type == GraphCommand::Type::Clear)
+            m_pendingClears.fetch_add(1);
+
+        if (!m_commands.try_push(std::move(command)))
+        {
+            if (type == GraphCommand::Type::AddUnit)
+                m_pendingAdds.fetch_sub(1);
+            else if (type == GraphCommand::Type::Clear)
+                m_pendingClears.fetch_sub(1);
+            return false;
+        }
+
+        if (type == GraphCommand::Type::AddUnit)
+            m_addsSinceClear.fetch_add(1);
+        else if (type == GraphCommand::Type::Clear)
+            m_addsSinceClear.store(0);
+        return true;
+    }
+
+    // Drains the command ring. Runs on the audio thread at the top of each
+    // block; never blocks, never allocates and never destroys a unit.
+    void MixerPlaybackUnit::applyCommands(const types::RenderContext &context)
+    {
+        while (GraphCommand *command = m_commands.front())
+        {
+            switch (command->type)
+            {
+            case GraphCommand::Type::AddUnit:
+                if (m_units.size() < kMaxUnits)
+                {
+                    m_units.push_back(std::move(command->unit));
+                }
+                else
+                {
+                    rtLog(context, LogLevel::Warning, "MixerPlaybackUnit",
+                          "unit limit of {} reached, dropping unit",
+                          kMaxUnits);
+                    retire(context, std::move(command->unit));
+                }
+                m_liveUnits.store(m_units.size());
+                m_pendingAdds.fetch_sub(1);
+                break;
+
+            case GraphCommand::Type::RemoveUnit:
+            {
+                auto it =
+                    std::find(m_units.begin(), m_units.end(), command->unit);
+                if (it != m_units.end())
+                {
+                    retire(context, std::move(*it));
+                    m_units.erase(it);
+                }
+                m_liveUnits.store(m_units.size());
+                break;
+            }
+
+            case GraphCommand::Type::Clear:
+                for (auto &unit : m_units)
+                    retire(context, std::move(unit));
+                m_units.clear();
+                m_liveUnits.store(0);
+                m_pendingClears.fetch_sub(1);
+                break;
+
+            case GraphCommand::Type::SetParam:
+                if (command->unit)
+                    command->unit->setParameter(command->param,
+                                                command->value);
+                break;
+            }
+
+            // The command may still hold the last reference to its unit
+            // (e.g. a RemoveUnit issued by a control thread that let go).
+            retire(context, std::move(command->unit));
+            m_commands.pop();
+        }
+    }
+
+    // Runs on a pool worker or the audio thread. Each index is rendered by
+    // exactly one thread, and the unit list cannot change during the batch.
+    void MixerPlaybackUnit::renderUnitTask(void *userData, size_t index,
+                                           float *output, unsigned int nFrames,
+                                           unsigned int channels,
+                                           const types::RenderContext &context)
+    {
+        auto *mixer = static_cast<MixerPlaybackUnit *>(userData);
+        mixer->m_units[index]->renderAdd(output, nFrames, channels, context);
     }
 
     // Mixes all active units into the provided output buffer
@@ -26,28 +185,44 @@ namespace dtracker::audio::playback
                                    unsigned int channels,
                                    const types::RenderContext &context)
     {
+        // Bring the unit list up to date with the control threads.
+        applyCommands(context);
+
         // Start with silence
-        std::fill(buffer, buffer + nFrames * channels, 0.0f);
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
 
-        // Temporary buffer for each unit's output
-        std::vector<float> temp(nFrames * channels, 0.0f);
+        RenderWorkerPool *workers = context.workers;
+        if (workers && m_units.size() > 1 &&
+            workers->canRun(m_units.size(), nFrames, channels))
+        {
+            // Render every child into its own slot in parallel, then sum the
+            // slots in order so the mix is the same whichever thread
+            // rendered each child.
+            workers->run(m_units.size(), &MixerPlaybackUnit::renderUnitTask,
+                         this, context, nFrames, channels);
+            const size_t samples = static_cast<size_t>(nFrames) * channels;
+            for (size_t i = 0; i < m_units.size(); ++i)
+                dsp::accumulate(buffer, workers->slot(i), samples);
+        }
+        else
+        {
+            // Each unit adds itself straight into the mix.
+            for (auto &unit : m_units)
+                unit->renderAdd(buffer, nFrames, channels, context);
+        }
 
+        // Remove finished units
         for (auto it = m_units.begin(); it != m_units.end();)
         {
-            std::fill(temp.begin(), temp.end(), 0.0f); // Zero the temp
-            (*it)->render(temp.data(), nFrames, channels,
-                          context); // Render to temp
-
-            // Mix into main buffer
-            for (unsigned int i = 0; i < nFrames * channels; ++i)
-                buffer[i] += temp[i];
-
-            // Remove finished units
             if ((*it)->isFinished())
             {
-                std::cout << "MixerPlaybackUnit: "
-                          << "tracks finished, erasing\n";
+                rtLog(context, LogLevel::Info, "MixerPlaybackUnit",
+                      "unit finished, erasing ({} left)",
+                      m_units.size() - 1);
+                // Hand the subtree off rather than destroying it here.
+                retire(context, std::move(*it));
                 it = m_units.erase(it);
+                m_liveUnits.store(m_units.size());
             }
             else
             {
@@ -55,48 +230,52 @@ namespace dtracker::audio::playback
             }
         }
 
-        // --- ADDED: WAVEFORM TAP ---
         // At this point, 'buffer' contains the final, mixed master output.
-        if (m_bufferPool && m_waveformQueue)
-        {
-            // Acquire a recycled buffer from the pool.
-            auto transportBuffer = m_bufferPool->acquire();
-            if (transportBuffer)
-            {
-                // Copy this frame's audio into the transport buffer.
-                size_t samplesToCopy = std::min((size_t)nFrames * channels,
-                                                transportBuffer->size());
-                memcpy(transportBuffer->data(), buffer,
-                       samplesToCopy * sizeof(float));
-
-                // Push the smart pointer to the buffer onto the lock-free
-                // queue.
-                // If the push fails (queue is full), the transportBuffer is
-                // destroyed here, returning the raw buffer to the pool.
-                m_waveformQueue->try_push(std::move(transportBuffer));
-            }
-        }
+        // The tap copies it into its ring without locking or allocating.
+        // The pass counter lets the setters wait until the old pointers are
+        // done.
+        m_outputPass.fetch_add(1, std::memory_order_seq_cst);
+        if (WaveformTap *tap = m_waveformTap.load(std::memory_order_seq_cst))
+            tap->write(buffer, nFrames, channels);
+        if (LevelMeter *meter = m_levelMeter.load(std::memory_order_seq_cst))
+            meter->process(buffer, nFrames, channels, context.frame);
+        m_outputPass.fetch_add(1, std::memory_order_release);
     }
 
+    // Queues the removal of every unit on the next block
     void MixerPlaybackUnit::clear()
     {
-        m_units.clear();
+        GraphCommand command;
+        command.type = GraphCommand::Type::Clear;
+        submit(std::move(command));
     }
 
+    // Nothing to reset: units are removed through clear(). Kept silent
+    // since the proxy may forward this from the audio thread.
     void MixerPlaybackUnit::reset()
     {
-        std::cout << "MixerPlaybackUnit: resetting all contained units\n";
-
         // for (auto *unit : m_units)
         // {
         //     unit->reset();
         // }
     }
 
-    // True if no units are left to play
+    // True if no units are left to play once pending commands are applied.
+    // Safe to call from any thread.
     bool MixerPlaybackUnit::isFinished() const
     {
-        return m_units.empty();
+        // A pending Clear empties the mix; only adds queued after it count.
+        if (m_pendingClears.load() > 0)
+            return m_addsSinceClear.load() == 0;
+
+        // The audio thread bumps m_liveUnits before retiring an add, so a
+        // unit is always visible in at least one of these counters.
+        return m_pendingAdds.load() == 0 && m_liveUnits.load() == 0;
+    }
+
+    size_t MixerPlaybackUnit::unitCount() const
+    {
+        return m_liveUnits.load();
     }
 
 } // namespace dtracker::audio::playback
@@ -1,7 +1,7 @@
-#include <algorithm> // For std::fill
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
 #include <dtracker/audio/playback/pattern_playback_unit.hpp>
-#include <iostream>
-#include <vector>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
 
 namespace dtracker::audio::playback
 {
@@ -18,112 +18,85 @@ namespace dtracker::audio::playback
         m_activeNotes.reserve(64);
     }
 
-    // Performs one block of processing. This is the heart of the sequencer.
+    // Overwrites the buffer with one block of the pattern.
     void PatternPlaybackUnit::render(float *buffer, unsigned int nFrames,
                                      unsigned int channels,
                                      const types::RenderContext &context)
+    {
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
+        renderAdd(buffer, nFrames, channels, context, 1.0f, 1.0f);
+    }
+
+    // Performs one block of processing. This is the heart of the sequencer.
+    void PatternPlaybackUnit::renderAdd(float *buffer, unsigned int nFrames,
+                                        unsigned int channels,
+                                        const types::RenderContext &context,
+                                        float gainLeft, float gainRight)
     {
         // Ensure we have the tools we need to work.
         if (!m_sampleUnitPool || m_pattern.steps.empty())
-        {
-            std::fill(buffer, buffer + nFrames * channels, 0.0f);
             return;
-        }
-
-        // --- DYNAMIC TIMING CALCULATION ---
-        // Calculate the duration of a single beat in milliseconds from the BPM.
-        const float msPerBeat = 60000.0f / context.bpm;
-        // Calculate the duration of a single step for this specific pattern.
-        const float stepIntervalMs = msPerBeat / m_pattern.stepsPerBeat;
 
         // --- 1. SCHEDULING LOGIC ---
-        // Only schedule new notes if the pattern hasn't completed its first
-        // full loop.
-
-        // Use the render call as a high-precision timer.
-        float deltaTimeMs =
-            (static_cast<float>(nFrames) / m_sampleRate) * 1000.0f;
-        m_pattern.elapsedMs += deltaTimeMs;
-
-        // Get all the steps that fall within the current time window, use the
-        // blue print to recyce playback units and add them to active notes
+        // Trigger every step that falls inside this block at the frame it
+        // falls on, rather than at the start of the block. Step 0 starts the
+        // pattern, and each following step is one step length later.
         // Note: Only build notes when the currentStep reader is <
         // pattern.steps.size() When the playback manager is looping, it'll
         // reset the current step to start this process again
-        while (m_pattern.elapsedMs >= stepIntervalMs &&
-               m_pattern.currentStep < m_pattern.steps.size())
+        if (!m_started)
         {
-            // Get the sample to play
-            int sampleIdToPlay = m_pattern.steps[m_pattern.currentStep];
+            m_nextStepTime = Transport::toTime(context.frame);
+            m_started = true;
+        }
 
-            if (sampleIdToPlay >= 0) // A non-negative ID is a note, not a rest.
-            {
-                // Look up the sample's data in our pre-built blueprint.
-                auto blueprintIt = m_blueprint.find(sampleIdToPlay);
-                if (blueprintIt != m_blueprint.end())
-                {
-                    // Acquire a recycled player from the pool (fast and
-                    // allocation-free).
-                    auto unitPtr = m_sampleUnitPool->acquire();
-                    if (unitPtr)
-                    {
-                        // Configure the recycled player with the correct
-                        // sample data.
-                        unitPtr->reinitialize(blueprintIt->second);
-                        // Add it to our internal list of notes that are
-                        // currently playing.
-                        m_activeNotes.push_back(std::move(unitPtr));
-                    }
-                }
-            }
+        const Transport::Time stepTime = stepLength(context);
+        const std::uint64_t blockEnd = context.frame + nFrames;
+        while (m_pattern.currentStep < m_pattern.steps.size())
+        {
+            const std::uint64_t stepFrame =
+                Transport::frameAtOrAfter(m_nextStepTime);
+            if (stepFrame >= blockEnd)
+                break;
 
-            // Advance the sequencer state for the next step.
-            m_pattern.currentStep++;
+            const unsigned int offset =
+                stepFrame > context.frame
+                    ? static_cast<unsigned int>(stepFrame - context.frame)
+                    : 0u;
 
-            // If we process the last step, mark that we have looped once.
-            if (m_pattern.currentStep >= m_pattern.steps.size() &&
-                !m_hasFinishedOneLoop)
-            {
-                // Let the track playback unit reset the current step
-                // m_pattern.currentStep = 0;
-                m_hasFinishedOneLoop = true;
+            // A non-negative ID is a note, not a rest.
+            const int sampleIdToPlay = m_pattern.steps[m_pattern.currentStep];
+            if (sampleIdToPlay >= 0)
+                triggerNote(sampleIdToPlay, offset);
 
-                std::cout << "elapsed time " << m_pattern.elapsedMs << "\n";
-            }
-            // Prevents jitter
-            m_pattern.elapsedMs -= stepIntervalMs;
+            // Advance the sequencer state for the next step.
+            m_pattern.currentStep++;
+            m_nextStepTime += stepTime;
         }
 
-        // --- 2. MIXING LOGIC ---
-        // Always render and mix the currently active notes. This allows note
-        // tails to continue playing even after the pattern has finished
-        // scheduling.
-        std::fill(buffer, buffer + nFrames * channels, 0.0f);
-        if (m_activeNotes.empty())
+        // The loop is over once the last step has run its full length. Let
+        // the track playback unit reset the current step.
+        if (m_pattern.currentStep >= m_pattern.steps.size() &&
+            Transport::frameAtOrAfter(m_nextStepTime) <= blockEnd)
         {
-            return;
+            m_hasFinishedOneLoop = true;
         }
 
-        // TODO: pre-allocate this as a private member to remove the last
-        // allocation
-        std::vector<float> temp(nFrames * channels, 0.0f);
-
+        // --- 2. MIXING LOGIC ---
+        // Always mix the currently active notes. This allows note tails to
+        // continue playing even after the pattern has finished scheduling.
+        // Each note adds itself straight into the caller's buffer with the
+        // caller's gains, so there is no intermediate copy.
         for (auto it = m_activeNotes.begin(); it != m_activeNotes.end();)
         {
-            // Render the note into the temporary buffer.
-            (*it)->render(temp.data(), nFrames, channels, context);
-
-            // Additively mix the note's audio into our main output buffer.
-            for (unsigned int i = 0; i < nFrames * channels; ++i)
-            {
-                buffer[i] += temp[i];
-            }
+            (*it)->renderAdd(buffer, nFrames, channels, context, gainLeft,
+                             gainRight);
 
             // If a note has finished playing, remove it from the active list.
             if ((*it)->isFinished())
             {
-                // Erasing the shared_ptr triggers its custom deleter, which
-                // returns the object to the UnitPool.
+                // Dropping the handle pushes the unit back onto the pool's
+                // lock-free free list, which is safe to do right here.
                 it = m_activeNotes.erase(it);
             }
             else
@@ -139,10 +112,77 @@ namespace dtracker::audio::playback
     void PatternPlaybackUnit::reset()
     {
         m_pattern.currentStep = 0;
-        m_pattern.elapsedMs = 0.0f;
+        m_started = false;
         m_hasFinishedOneLoop = false;
     }
 
+    void PatternPlaybackUnit::startAt(Transport::Time time)
+    {
+        reset();
+        m_nextStepTime = time;
+        m_started = true;
+    }
+
+    void PatternPlaybackUnit::setPolyphony(PolyphonyManager *polyphony,
+                                           int trackId)
+    {
+        m_polyphony = polyphony;
+        m_trackId = trackId;
+    }
+
+    size_t PatternPlaybackUnit::activeNoteCount() const
+    {
+        return m_activeNotes.size();
+    }
+
+    // Looks up the sample and starts a recycled player for it.
+    void PatternPlaybackUnit::triggerNote(int sampleId, unsigned int offset)
+    {
+        // Look up the sample's data in our pre-built blueprint.
+        auto blueprintIt = m_blueprint.find(sampleId);
+        if (blueprintIt == m_blueprint.end())
+            return;
+
+        // Acquire a recycled player from the pool, through the polyphony
+        // manager if there is one so a full pool steals instead of dropping.
+        auto unitPtr = m_polyphony ? m_polyphony->acquire(m_trackId)
+                                   : m_sampleUnitPool->acquire();
+        if (!unitPtr)
+            return;
+
+        // Configure the recycled player with the correct sample data, and
+        // hold it back until its step's frame.
+        unitPtr->reinitialize(blueprintIt->second);
+        unitPtr->setStartOffset(offset);
+
+        // Add it to our internal list of notes that are currently playing.
+        m_activeNotes.push_back(std::move(unitPtr));
+    }
+
+    // Steps per beat comes from the pattern; the tempo from the context.
+    Transport::Time PatternPlaybackUnit::stepLength(
+        const types::RenderContext &context) const
+    {
+        return Transport::stepLength(m_sampleRate, context.bpm,
+                                     m_pattern.stepsPerBeat);
+    }
+
+    // The loop ends one step length after the last step starts.
+    Transport::Time PatternPlaybackUnit::loopEndTime(
+        const types::RenderContext &context) const
+    {
+        if (m_pattern.steps.empty())
+            return kNever;
+
+        const Transport::Time next = m_started
+                                         ? m_nextStepTime
+                                         : Transport::toTime(context.frame);
+        const size_t stepsLeft =
+            m_pattern.steps.size() -
+            std::min(m_pattern.currentStep, m_pattern.steps.size());
+        return next + stepsLeft * stepLength(context);
+    }
+
     // The pattern is only truly finished after it has completed its sequence
     // AND all the notes it triggered have finished their playback (the "tail").
     bool PatternPlaybackUnit::isFinished() const
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/playback/playback_unit.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+
+namespace dtracker::audio::playback
+{
+    namespace
+    {
+        // The stack buffer renderAdd() falls back on, in floats.
+        constexpr size_t kStackScratchSamples = 512;
+
+        // Renders 'unit' into the zeroed 'temp', then sums it into the
+        // parent's buffer with the requested gains.
+        void renderAndSum(PlaybackUnit &unit, float *temp, float *output,
+                          unsigned int nFrames, unsigned int channels,
+                          const types::RenderContext &context,
+                          float gainLeft, float gainRight)
+        {
+            const size_t samples = static_cast<size_t>(nFrames) * channels;
+            dsp::clear(temp, samples);
+            unit.render(temp, nFrames, channels, context);
+
+            if (channels == 2)
+                dsp::accumulateStereo(output, temp, gainLeft, gainRight,
+                                      nFrames);
+            else
+                dsp::accumulateScaled(output, temp, gainLeft, samples);
+        }
+    } // namespace
+
+    // Fallback for units that can only overwrite: render into scratch memory,
+    // then sum it into the parent's buffer with the requested gains.
+    void PlaybackUnit::renderAdd(float *output, unsigned int nFrames,
+                                 unsigned int channels,
+                                 const types::RenderContext &context,
+                                 float gainLeft, float gainRight)
+    {
+        const size_t samples = static_cast<size_t>(nFrames) * channels;
+        ScratchArena::Frame scratch(context.scratch);
+        if (float *temp = scratch.allocate(samples))
+        {
+            renderAndSum(*this, temp, output, nFrames, channels, context,
+                         gainLeft, gainRight);
+            return;
+        }
+
+        // No arena, or it is exhausted (and has counted it): render the
+        // block in pieces through the stack rather than allocate.
+        const unsigned int maxFrames =
+            static_cast<unsigned int>(kStackScratchSamples / channels);
+        if (maxFrames == 0)
+            return;
+
+        float temp[kStackScratchSamples];
+        types::RenderContext pieceContext = context;
+        for (unsigned int offset = 0; offset < nFrames; offset += maxFrames)
+        {
+            const unsigned int frames = std::min(maxFrames, nFrames - offset);
+            pieceContext.frame = context.frame + offset;
+            renderAndSum(*this, temp,
+                         output + static_cast<size_t>(offset) * channels,
+                         frames, channels, pieceContext, gainLeft, gainRight);
+        }
+    }
+} // namespace dtracker::audio::playback
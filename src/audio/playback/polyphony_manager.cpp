@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <limits>
+#include <stdexcept>
+
+namespace dtracker::audio::playback
+{
+    PolyphonyManager::PolyphonyManager(UnitPool *pool, size_t maxVoices,
+                                       StealPolicy policy)
+        : m_pool(pool), m_policy(policy)
+    {
+        if (!m_pool)
+            throw std::invalid_argument("PolyphonyManager requires a pool.");
+
+        // Without a limit, an eighth of the pool covers the fade tails.
+        const size_t capacity = m_pool->capacity();
+        if (maxVoices == 0)
+            maxVoices = capacity - std::max<size_t>(capacity / 8, 1);
+        m_maxVoices = std::clamp<size_t>(maxVoices, 1, capacity);
+
+        m_voices.reserve(capacity);
+    }
+
+    UnitPool::PooledUnitPtr PolyphonyManager::acquire(int trackId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        refresh();
+
+        // A track over its own limit gives up one of its own voices;
+        // otherwise the pool-wide limit picks from every track.
+        TrackState &track = m_tracks[trackId];
+        bool stolen = false;
+        if (track.limit > 0 && track.active >= track.limit)
+            stolen = steal(&trackId);
+        else if (m_active >= m_maxVoices)
+            stolen = steal(nullptr);
+
+        auto voice = m_pool->acquire();
+        if (!voice)
+        {
+            // Every spare unit is still fading. Free one up for the next
+            // note rather than letting the pool stay exhausted.
+            if (!stolen)
+                steal(nullptr);
+            m_drops.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        m_voices.push_back(Voice{voice.get(), m_pool->generation(voice.get()),
+                                 trackId, m_nextSerial++});
+        ++m_active;
+        ++track.active;
+        return voice;
+    }
+
+    void PolyphonyManager::setPolicy(StealPolicy policy)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_policy = policy;
+    }
+
+    StealPolicy PolyphonyManager::policy() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_policy;
+    }
+
+    void PolyphonyManager::setFadeFrames(unsigned int frames)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fadeFrames = std::max(frames, 1u);
+    }
+
+    unsigned int PolyphonyManager::fadeFrames() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_fadeFrames;
+    }
+
+    void PolyphonyManager::setTrackLimit(int trackId, size_t limit)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tracks[trackId].limit = limit;
+    }
+
+    size_t PolyphonyManager::trackLimit(int trackId) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_tracks.find(trackId);
+        return it != m_tracks.end() ? it->second.limit : 0;
+    }
+
+    size_t PolyphonyManager::maxVoices() const
+    {
+        return m_maxVoices;
+    }
+
+    size_t PolyphonyManager::activeVoices() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t active = 0;
+        for (const auto &voice : m_voices)
+        {
+            if (isLive(voice) && !voice.unit->isFadingOut())
+                ++active;
+        }
+        return active;
+    }
+
+    std::uint64_t PolyphonyManager::stealCount() const
+    {
+        return m_steals.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t PolyphonyManager::trackStealCount(int trackId) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_tracks.find(trackId);
+        return it != m_tracks.end() ? it->second.steals : 0;
+    }
+
+    std::uint64_t PolyphonyManager::dropCount() const
+    {
+        return m_drops.load(std::memory_order_relaxed);
+    }
+
+    void PolyphonyManager::resetCounters()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &[trackId, track] : m_tracks)
+            track.steals = 0;
+        m_steals.store(0, std::memory_order_relaxed);
+        m_drops.store(0, std::memory_order_relaxed);
+    }
+
+    // A stale check is harmless: a voice released just after it only gets
+    // a fade request that its next acquirer's reinitialize() clears. That
+    // holds because every voice of the pool is acquired through acquire(),
+    // previews included, so no one can take the unit back out between the
+    // check and the fade.
+    bool PolyphonyManager::isLive(const Voice &voice) const
+    {
+        return m_pool->generation(voice.unit) == voice.generation;
+    }
+
+    void PolyphonyManager::refresh()
+    {
+        m_active = 0;
+        for (auto &[trackId, track] : m_tracks)
+            track.active = 0;
+
+        for (size_t i = 0; i < m_voices.size();)
+        {
+            if (!isLive(m_voices[i]))
+            {
+                m_voices[i] = m_voices.back();
+                m_voices.pop_back();
+                continue;
+            }
+
+            if (!m_voices[i].unit->isFadingOut())
+            {
+                ++m_active;
+                ++m_tracks[m_voices[i].trackId].active;
+            }
+            ++i;
+        }
+    }
+
+    // Voices that have not sounded yet rank as loudest, so a note that is
+    // scheduled but not yet started is not stolen for being silent.
+    bool PolyphonyManager::steal(const int *trackId)
+    {
+        const auto loudness = [](const SamplePlaybackUnit &unit)
+        {
+            const float level = unit.level();
+            return level < 0.0f ? std::numeric_limits<float>::max() : level;
+        };
+
+        const Voice *victim = nullptr;
+        for (const auto &voice : m_voices)
+        {
+            if (trackId && voice.trackId != *trackId)
+                continue;
+            if (!isLive(voice) || voice.unit->isFadingOut())
+                continue;
+
+            bool better = !victim;
+            if (victim && m_policy == StealPolicy::Quietest)
+            {
+                const float a = loudness(*voice.unit);
+                const float b = loudness(*victim->unit);
+                better = a < b || (a == b && voice.serial < victim->serial);
+            }
+            else if (victim)
+            {
+                better = voice.serial < victim->serial;
+            }
+
+            if (better)
+                victim = &voice;
+        }
+
+        if (!victim)
+            return false;
+
+        victim->unit->fadeOut(m_fadeFrames);
+
+        TrackState &track = m_tracks[victim->trackId];
+        ++track.steals;
+        if (track.active > 0)
+            --track.active;
+        if (m_active > 0)
+            --m_active;
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+} // namespace dtracker::audio::playback
@@ -70,4 +70,14 @@ namespace dtracker::audio::playback
         return m_bpm.load(std::memory_order_relaxed);
     }
 
+    void ProxyPlaybackUnit::setResampleQuality(dsp::ResampleQuality quality)
+    {
+        m_resampleQuality.store(quality, std::memory_order_relaxed);
+    }
+
+    dsp::ResampleQuality ProxyPlaybackUnit::resampleQuality() const
+    {
+        return m_resampleQuality.load(std::memory_order_relaxed);
+    }
+
 } // namespace dtracker::audio::playback
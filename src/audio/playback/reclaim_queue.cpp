@@ -0,0 +1,95 @@
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+
+namespace dtracker::audio::playback
+{
+    ReclaimQueue::ReclaimQueue(size_t capacity) : m_queue(capacity) {}
+
+    ReclaimQueue::~ReclaimQueue()
+    {
+        stopCollector();
+        collect();
+    }
+
+    // Moves the reference into the ring. If the ring is full, 'object' still
+    // holds it and is released when this function returns.
+    bool ReclaimQueue::retire(Retired object)
+    {
+        if (!object)
+            return true;
+
+        if (m_queue.tryPush(object))
+            return true;
+
+        m_overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Drops every queued reference on the calling thread.
+    size_t ReclaimQueue::collect()
+    {
+        size_t count = 0;
+        Retired object;
+        while (m_queue.tryPop(object))
+        {
+            object.reset();
+            ++count;
+        }
+
+        m_reclaimed.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    void ReclaimQueue::startCollector(std::chrono::milliseconds interval)
+    {
+        if (m_collector.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_collectorMutex);
+            m_stopRequested = false;
+        }
+        m_collector = std::thread(&ReclaimQueue::run, this, interval);
+    }
+
+    void ReclaimQueue::stopCollector()
+    {
+        if (!m_collector.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_collectorMutex);
+            m_stopRequested = true;
+        }
+        m_collectorWake.notify_one();
+        m_collector.join();
+    }
+
+    size_t ReclaimQueue::reclaimedCount() const
+    {
+        return m_reclaimed.load(std::memory_order_relaxed);
+    }
+
+    size_t ReclaimQueue::overflowCount() const
+    {
+        return m_overflows.load(std::memory_order_relaxed);
+    }
+
+    // Polls the ring rather than being woken by the audio thread, so
+    // retire() never has to touch a mutex or make a system call.
+    void ReclaimQueue::run(std::chrono::milliseconds interval)
+    {
+        std::unique_lock<std::mutex> lock(m_collectorMutex);
+        while (!m_stopRequested)
+        {
+            lock.unlock();
+            collect();
+            lock.lock();
+
+            m_collectorWake.wait_for(lock, interval,
+                                     [this] { return m_stopRequested; });
+        }
+
+        lock.unlock();
+        collect();
+    }
+} // namespace dtracker::audio::playback
@@ -0,0 +1,312 @@
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+#include <dtracker/audio/realtime.hpp>
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||             \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define DTRACKER_CPU_RELAX() _mm_pause()
+#else
+#define DTRACKER_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace dtracker::audio::playback
+{
+    // A counting semaphore built on the OS primitive. Posting is a single
+    // system call with no user-space lock, so the audio thread can wake
+    // workers without risking priority inversion.
+    class RenderWorkerPool::Semaphore
+    {
+      public:
+        Semaphore()
+        {
+#if defined(_WIN32)
+            m_handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+#elif defined(__APPLE__)
+            m_handle = dispatch_semaphore_create(0);
+#else
+            sem_init(&m_handle, 0, 0);
+#endif
+        }
+
+        ~Semaphore()
+        {
+#if defined(_WIN32)
+            CloseHandle(m_handle);
+#elif defined(__APPLE__)
+            dispatch_release(m_handle);
+#else
+            sem_destroy(&m_handle);
+#endif
+        }
+
+        void post(size_t count)
+        {
+#if defined(_WIN32)
+            ReleaseSemaphore(m_handle, static_cast<LONG>(count), nullptr);
+#else
+            for (size_t i = 0; i < count; ++i)
+            {
+#if defined(__APPLE__)
+                dispatch_semaphore_signal(m_handle);
+#else
+                sem_post(&m_handle);
+#endif
+            }
+#endif
+        }
+
+        void wait()
+        {
+#if defined(_WIN32)
+            WaitForSingleObject(m_handle, INFINITE);
+#elif defined(__APPLE__)
+            dispatch_semaphore_wait(m_handle, DISPATCH_TIME_FOREVER);
+#else
+            // Retry if a signal interrupts the wait.
+            while (sem_wait(&m_handle) != 0)
+            {
+            }
+#endif
+        }
+
+      private:
+#if defined(_WIN32)
+        HANDLE m_handle;
+#elif defined(__APPLE__)
+        dispatch_semaphore_t m_handle;
+#else
+        sem_t m_handle;
+#endif
+    };
+
+    namespace
+    {
+        constexpr int kGenerationShift = 32;
+        constexpr int kCountShift = 16;
+        constexpr std::uint64_t kFieldMask = 0xFFFF;
+
+        // Floats per slot are rounded up so every slot starts on a cache
+        // line.
+        constexpr size_t kSlotAlign = ScratchArena::kAlignment / sizeof(float);
+    } // namespace
+
+    RenderWorkerPool::RenderWorkerPool(size_t workerCount, size_t maxTasks,
+                                       unsigned int blockFrames,
+                                       unsigned int channels,
+                                       bool flushDenormals,
+                                       bool requireRealtime)
+        : m_wake(std::make_unique<Semaphore>()), m_maxTasks(maxTasks),
+          m_blockFrames(blockFrames), m_channels(channels),
+          m_flushDenormals(flushDenormals), m_requireRealtime(requireRealtime)
+    {
+        if (maxTasks == 0 || maxTasks > kMaxBatch)
+            throw std::invalid_argument(
+                "Worker pool batch size must be between 1 and 65535.");
+        if (blockFrames == 0 || channels == 0)
+            throw std::invalid_argument(
+                "Worker pool block size and channels must be non-zero.");
+
+        // Preallocate one aligned output slot per task.
+        const size_t samples = static_cast<size_t>(blockFrames) * channels;
+        m_slotStride = (samples + kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+        m_slotStorage.assign(m_slotStride * maxTasks + kSlotAlign, 0.0f);
+        const auto address =
+            reinterpret_cast<std::uintptr_t>(m_slotStorage.data());
+        const size_t misalignment = address % ScratchArena::kAlignment;
+        m_slotBase = m_slotStorage.data() +
+                     (misalignment ? (ScratchArena::kAlignment - misalignment) /
+                                         sizeof(float)
+                                   : 0);
+
+        // One arena per worker, plus one for the calling thread.
+        for (size_t i = 0; i <= workerCount; ++i)
+        {
+            m_arenas.push_back(std::make_unique<ScratchArena>());
+            m_arenas.back()->configure(blockFrames, channels);
+        }
+
+        m_workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i)
+            m_workers.emplace_back(&RenderWorkerPool::workerLoop, this, i);
+
+        // Each worker reports whether it got realtime priority as soon as it
+        // starts, so run() knows how many to wake from the first batch on.
+        while (m_startedWorkers.load(std::memory_order_acquire) < workerCount)
+            std::this_thread::yield();
+
+        const size_t active = m_activeWorkers.load(std::memory_order_relaxed);
+        if (active < workerCount)
+            std::cerr << "RenderWorkerPool: " << workerCount - active << " of "
+                      << workerCount << " workers could not get realtime "
+                      << "priority; their share renders on the audio "
+                      << "thread\n";
+    }
+
+    RenderWorkerPool::~RenderWorkerPool()
+    {
+        m_stop.store(true, std::memory_order_release);
+        m_wake->post(m_workers.size());
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    bool RenderWorkerPool::canRun(size_t taskCount, unsigned int nFrames,
+                                  unsigned int channels) const
+    {
+        return taskCount <= m_maxTasks && nFrames <= m_blockFrames &&
+               channels == m_channels &&
+               m_activeWorkers.load(std::memory_order_relaxed) > 0;
+    }
+
+    void RenderWorkerPool::run(size_t taskCount, Task task, void *userData,
+                               const types::RenderContext &context,
+                               unsigned int nFrames, unsigned int channels)
+    {
+        if (taskCount == 0)
+            return;
+
+        // Nobody can be reading the batch: the previous run() waited for all
+        // of its tasks, and a stale worker only reads it after a successful
+        // claim, which the cursor below makes impossible until it is
+        // published.
+        m_batch.task = task;
+        m_batch.userData = userData;
+        m_batch.context = context;
+        m_batch.context.workers = nullptr; // No nested parallelism
+        m_batch.nFrames = nFrames;
+        m_batch.channels = channels;
+
+        m_remaining.store(taskCount, std::memory_order_relaxed);
+
+        const std::uint64_t generation =
+            (m_cursor.load(std::memory_order_relaxed) >> kGenerationShift) + 1;
+        m_cursor.store((generation << kGenerationShift) |
+                           (static_cast<std::uint64_t>(taskCount)
+                            << kCountShift),
+                       std::memory_order_release);
+
+        // Wake only as many workers as there are tasks beyond our own. Only
+        // active workers wait on the semaphore, and the audio thread claims
+        // whatever they do not.
+        const size_t helpers = std::min(
+            m_activeWorkers.load(std::memory_order_relaxed), taskCount - 1);
+        if (helpers > 0)
+            m_wake->post(helpers);
+
+        // The audio thread works on the batch too.
+        drain(*m_arenas.back());
+
+        // Wait for tasks still running on workers. They are short and run
+        // at the caller's priority when it matters, and blocking here would
+        // hand the audio thread to the scheduler.
+        while (m_remaining.load(std::memory_order_acquire) != 0)
+            DTRACKER_CPU_RELAX();
+    }
+
+    const float *RenderWorkerPool::slot(size_t index) const
+    {
+        return m_slotBase + index * m_slotStride;
+    }
+
+    float *RenderWorkerPool::slotData(size_t index)
+    {
+        return m_slotBase + index * m_slotStride;
+    }
+
+    size_t RenderWorkerPool::workerCount() const
+    {
+        return m_workers.size();
+    }
+
+    size_t RenderWorkerPool::activeWorkerCount() const
+    {
+        return m_activeWorkers.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t RenderWorkerPool::scratchOverflowCount() const
+    {
+        std::uint64_t overflows = 0;
+        for (const auto &arena : m_arenas)
+            overflows += arena->overflowCount();
+        return overflows;
+    }
+
+    bool RenderWorkerPool::claim(size_t &index)
+    {
+        std::uint64_t cursor = m_cursor.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const size_t next = cursor & kFieldMask;
+            const size_t count = (cursor >> kCountShift) & kFieldMask;
+            if (next >= count)
+                return false;
+
+            if (m_cursor.compare_exchange_weak(cursor, cursor + 1,
+                                               std::memory_order_acquire))
+            {
+                index = next;
+                return true;
+            }
+        }
+    }
+
+    void RenderWorkerPool::drain(ScratchArena &scratch)
+    {
+        size_t index = 0;
+        while (claim(index))
+        {
+            // Safe to read: the batch cannot complete, and so cannot be
+            // replaced, while this task is outstanding.
+            types::RenderContext context = m_batch.context;
+            context.scratch = &scratch;
+
+            const unsigned int nFrames = m_batch.nFrames;
+            const unsigned int channels = m_batch.channels;
+            float *output = slotData(index);
+            dsp::clear(output, static_cast<size_t>(nFrames) * channels);
+            m_batch.task(m_batch.userData, index, output, nFrames, channels,
+                         context);
+
+            m_remaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void RenderWorkerPool::workerLoop(size_t workerIndex)
+    {
+        // Schedule the worker like the audio thread. A realtime caller that
+        // spins on a worker the scheduler can preempt misses its deadline,
+        // so a worker refused the priority (usually for missing privileges)
+        // sits out when the caller requires it.
+        const bool active = realtime::raisePriority() || !m_requireRealtime;
+        if (active)
+            m_activeWorkers.fetch_add(1, std::memory_order_relaxed);
+        m_startedWorkers.fetch_add(1, std::memory_order_release);
+        if (!active)
+            return;
+
+        if (m_flushDenormals)
+            realtime::flushDenormals();
+
+        ScratchArena &scratch = *m_arenas[workerIndex];
+        for (;;)
+        {
+            m_wake->wait();
+            if (m_stop.load(std::memory_order_acquire))
+                return;
+            drain(scratch);
+        }
+    }
+} // namespace dtracker::audio::playback
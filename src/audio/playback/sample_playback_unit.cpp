@@ -1,9 +1,27 @@
 #include <algorithm>
+#include <cmath>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
 #include <dtracker/audio/playback/sample_playback_unit.hpp>
 #include <iostream>
 
 namespace dtracker::audio::playback
 {
+    namespace
+    {
+        // Voice stealing only needs a rough loudness, so one frame in eight
+        // is enough and keeps the cost off the mixing loop.
+        constexpr size_t kLevelStride = 8;
+
+        float estimatePeak(const float *samples, size_t frames)
+        {
+            float peak = 0.0f;
+            for (size_t i = 0; i < frames; i += kLevelStride)
+                peak = std::max({peak, std::fabs(samples[i * 2]),
+                                 std::fabs(samples[i * 2 + 1])});
+            return peak;
+        }
+    } // namespace
+
     SamplePlaybackUnit::SamplePlaybackUnit()
         : m_descriptor({}), m_position(0), isCheckedOut(false)
     {
@@ -28,6 +46,22 @@ namespace dtracker::audio::playback
             return;
         }
 
+        // A voice being stolen is mixed onto silence through the fade, and
+        // so is one that has to be resampled.
+        if (beginFade() || playbackStep(context) != 1.0)
+        {
+            std::fill(buffer, buffer + (frames * channels), 0.0f);
+            renderAdd(buffer, frames, channels, context);
+            return;
+        }
+
+        // Stay silent until the note's start offset is reached.
+        const unsigned int delay = std::min(m_startOffset, frames);
+        std::fill(buffer, buffer + delay * channels, 0.0f);
+        m_startOffset -= delay;
+        buffer += delay * channels;
+        frames -= delay;
+
         const auto &samples = *pcmPtr;
         const size_t samplesToWrite = frames * channels;
         const size_t samplesRemaining =
@@ -36,6 +70,8 @@ namespace dtracker::audio::playback
 
         // Copy available portion into output buffer
         std::copy_n(samples.begin() + m_position, actualSamples, buffer);
+        m_level.store(estimatePeak(buffer, actualSamples / 2),
+                      std::memory_order_relaxed);
         m_position += actualSamples;
 
         // Fill remaining with silence if we ran out early
@@ -45,15 +81,231 @@ namespace dtracker::audio::playback
         }
     }
 
+    // Same read logic as render(), but adds into the parent's buffer so no
+    // intermediate copy is needed. Past the end of the sample there is
+    // nothing to add.
+    void SamplePlaybackUnit::renderAdd(float *buffer, unsigned int frames,
+                                       unsigned int channels,
+                                       const types::RenderContext &context,
+                                       float gainLeft, float gainRight)
+    {
+        const auto pcmPtr = m_descriptor.pcmData();
+        if (!pcmPtr || channels != 2)
+            return;
+
+        // Nothing to add until the note's start offset is reached.
+        const unsigned int delay = std::min(m_startOffset, frames);
+        m_startOffset -= delay;
+        buffer += delay * channels;
+        frames -= delay;
+
+        const auto &samples = *pcmPtr;
+        if (playbackStep(context) != 1.0)
+        {
+            renderResampled(buffer, frames, samples, context, gainLeft,
+                            gainRight);
+            return;
+        }
+
+        const size_t samplesToWrite = frames * channels;
+        const size_t samplesRemaining =
+            samples.size() > m_position ? samples.size() - m_position : 0;
+        const size_t actualSamples = std::min(samplesToWrite, samplesRemaining);
+
+        const float *source = samples.data() + m_position;
+        if (beginFade())
+        {
+            renderFade(buffer, source, actualSamples / 2, gainLeft, gainRight);
+
+            // Once faded out, the rest of the sample is skipped.
+            if (m_fadeLeft == 0)
+                m_position = samples.size();
+            return;
+        }
+
+        dsp::accumulateStereo(buffer, source, gainLeft, gainRight,
+                              actualSamples / 2);
+        m_level.store(estimatePeak(source, actualSamples / 2) *
+                          std::max(gainLeft, gainRight),
+                      std::memory_order_relaxed);
+
+        // A trailing half frame in malformed data still belongs on the left.
+        if (actualSamples % 2)
+            buffer[actualSamples - 1] += source[actualSamples - 1] * gainLeft;
+
+        m_position += actualSamples;
+    }
+
     bool SamplePlaybackUnit::isFinished() const
     {
         const auto pcmPtr = m_descriptor.pcmData();
         return !pcmPtr || m_position >= pcmPtr->size();
     }
 
+    // The position is kept as a whole frame plus a fraction, so the frame
+    // count stays exact however long the sample.
+    void SamplePlaybackUnit::renderResampled(
+        float *buffer, unsigned int frames, const types::PCMData &samples,
+        const types::RenderContext &context, float gainLeft, float gainRight)
+    {
+        const size_t sourceFrames = samples.size() / 2;
+        const size_t firstFrame = m_position / 2;
+        if (firstFrame >= sourceFrames)
+        {
+            m_position = samples.size();
+            return;
+        }
+
+        const double step = playbackStep(context);
+        double position = static_cast<double>(firstFrame) + m_fraction;
+        float gain = std::max(gainLeft, gainRight);
+
+        if (!beginFade())
+        {
+            dsp::resampleStereo(buffer, frames, samples.data(), sourceFrames,
+                                position, step, gainLeft, gainRight,
+                                context.resampleQuality);
+        }
+        else
+        {
+            // The ramp runs over output frames, so the fade is resampled a
+            // short chunk at a time and scaled on the way into the buffer.
+            constexpr size_t kChunkFrames = 64;
+            float chunk[kChunkFrames * 2];
+            const float fadeStep = 1.0f / static_cast<float>(m_fadeLength);
+            gain *= static_cast<float>(m_fadeLeft) * fadeStep;
+
+            size_t done = 0;
+            while (done < frames && m_fadeLeft > 0)
+            {
+                const size_t wanted = std::min<size_t>(
+                    {kChunkFrames, frames - done, m_fadeLeft});
+                std::fill(chunk, chunk + wanted * 2, 0.0f);
+                const size_t count = dsp::resampleStereo(
+                    chunk, wanted, samples.data(), sourceFrames, position,
+                    step, gainLeft, gainRight, context.resampleQuality);
+
+                float fade = static_cast<float>(m_fadeLeft) * fadeStep;
+                float *out = buffer + done * 2;
+                for (size_t i = 0; i < count; ++i, fade -= fadeStep)
+                {
+                    out[i * 2] += chunk[i * 2] * fade;
+                    out[i * 2 + 1] += chunk[i * 2 + 1] * fade;
+                }
+                m_fadeLeft -= static_cast<unsigned int>(count);
+                done += count;
+                if (count < wanted)
+                    break;
+            }
+
+            // Once faded out, the rest of the sample is skipped.
+            if (m_fadeLeft == 0)
+                position = static_cast<double>(sourceFrames);
+        }
+
+        const size_t lastFrame = std::min(
+            static_cast<size_t>(position), sourceFrames);
+        m_level.store(lastFrame > firstFrame
+                          ? estimatePeak(samples.data() + firstFrame * 2,
+                                         lastFrame - firstFrame) *
+                                gain
+                          : 0.0f,
+                      std::memory_order_relaxed);
+
+        if (lastFrame >= sourceFrames)
+        {
+            m_position = samples.size();
+            m_fraction = 0.0;
+        }
+        else
+        {
+            m_position = lastFrame * 2;
+            m_fraction = position - static_cast<double>(lastFrame);
+        }
+    }
+
+    double
+    SamplePlaybackUnit::playbackStep(const types::RenderContext &context) const
+    {
+        const unsigned int sourceRate =
+            m_descriptor.metadata().sourceSampleRate;
+        if (context.sampleRate == 0 || sourceRate == 0 ||
+            sourceRate == context.sampleRate)
+            return 1.0;
+        return static_cast<double>(sourceRate) / context.sampleRate;
+    }
+
     void SamplePlaybackUnit::reset()
     {
         m_position = 0;
+        m_fraction = 0.0;
+        m_startOffset = 0;
+        m_fadeRequest.store(0, std::memory_order_relaxed);
+        m_fadeLength = 0;
+        m_fadeLeft = 0;
+        m_level.store(-1.0f, std::memory_order_relaxed);
+    }
+
+    void SamplePlaybackUnit::fadeOut(unsigned int frames)
+    {
+        m_fadeRequest.store(std::max(frames, 1u), std::memory_order_relaxed);
+    }
+
+    bool SamplePlaybackUnit::isFadingOut() const
+    {
+        return m_fadeRequest.load(std::memory_order_relaxed) != 0;
+    }
+
+    float SamplePlaybackUnit::level() const
+    {
+        return m_level.load(std::memory_order_relaxed);
+    }
+
+    // Latches a fade requested from another thread. A voice that has not
+    // started yet has nothing to fade, so it ends at once.
+    bool SamplePlaybackUnit::beginFade()
+    {
+        if (m_fadeLength == 0)
+        {
+            const unsigned int request =
+                m_fadeRequest.load(std::memory_order_relaxed);
+            if (request == 0)
+                return false;
+
+            m_fadeLength = request;
+            m_fadeLeft = m_startOffset > 0 ? 0 : request;
+            m_startOffset = 0;
+        }
+        return true;
+    }
+
+    // A linear ramp from the voice's current gain down to silence.
+    void SamplePlaybackUnit::renderFade(float *buffer, const float *source,
+                                        size_t frames, float gainLeft,
+                                        float gainRight)
+    {
+        const size_t count = std::min<size_t>(frames, m_fadeLeft);
+        const float step = 1.0f / static_cast<float>(m_fadeLength);
+        float fade = static_cast<float>(m_fadeLeft) * step;
+
+        for (size_t i = 0; i < count; ++i, fade -= step)
+        {
+            buffer[i * 2] += source[i * 2] * gainLeft * fade;
+            buffer[i * 2 + 1] += source[i * 2 + 1] * gainRight * fade;
+        }
+
+        m_level.store(count ? estimatePeak(source, count) *
+                                  std::max(gainLeft, gainRight) *
+                                  static_cast<float>(m_fadeLeft) * step
+                            : 0.0f,
+                      std::memory_order_relaxed);
+        m_fadeLeft -= static_cast<unsigned int>(count);
+        m_position += count * 2;
+    }
+
+    void SamplePlaybackUnit::setStartOffset(unsigned int frames)
+    {
+        m_startOffset = frames;
     }
 
     const std::vector<float> &SamplePlaybackUnit::data() const
@@ -74,6 +326,13 @@ namespace dtracker::audio::playback
         reset();
     }
 
+    std::shared_ptr<const types::PCMData> SamplePlaybackUnit::releaseSample()
+    {
+        auto pcm = m_descriptor.pcmData();
+        m_descriptor = {};
+        return pcm;
+    }
+
     std::unique_ptr<SamplePlaybackUnit>
     makePlaybackUnit(sample::types::SampleDescriptor descriptor)
     {
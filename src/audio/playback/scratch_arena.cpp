@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+
+namespace dtracker::audio::playback
+{
+    namespace
+    {
+        constexpr size_t kAlignFloats =
+            ScratchArena::kAlignment / sizeof(float);
+
+        // Rounds a request up so the next buffer stays aligned.
+        size_t alignedSize(size_t samples)
+        {
+            return (samples + kAlignFloats - 1) / kAlignFloats * kAlignFloats;
+        }
+    } // namespace
+
+    ScratchArena::Frame::Frame(ScratchArena *arena) : m_arena(arena)
+    {
+        if (m_arena)
+            m_mark = m_arena->m_top;
+    }
+
+    // Gives back everything borrowed through this frame.
+    ScratchArena::Frame::~Frame()
+    {
+        if (m_arena)
+            m_arena->m_top = m_mark;
+    }
+
+    float *ScratchArena::Frame::allocate(size_t samples)
+    {
+        if (!m_arena)
+            return nullptr;
+
+        const size_t size = alignedSize(samples);
+        if (size > m_arena->m_capacity - m_arena->m_top)
+        {
+            m_arena->m_overflows.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        float *buffer = m_arena->m_base + m_arena->m_top;
+        m_arena->m_top += size;
+        return buffer;
+    }
+
+    ScratchArena::ScratchArena(size_t capacity)
+    {
+        allocateStorage(capacity);
+    }
+
+    void ScratchArena::configure(unsigned int frames, unsigned int channels,
+                                 size_t depth)
+    {
+        allocateStorage(alignedSize(static_cast<size_t>(frames) * channels) *
+                        depth);
+        m_blockFrames = frames;
+    }
+
+    size_t ScratchArena::capacity() const
+    {
+        return m_capacity;
+    }
+
+    size_t ScratchArena::used() const
+    {
+        return m_top;
+    }
+
+    std::uint64_t ScratchArena::overflowCount() const
+    {
+        return m_overflows.load(std::memory_order_relaxed);
+    }
+
+    unsigned int ScratchArena::blockFrames() const
+    {
+        return m_blockFrames;
+    }
+
+    void ScratchArena::allocateStorage(size_t capacity)
+    {
+        // Over-allocate so the first buffer can start on a cache line.
+        m_storage.assign(alignedSize(capacity) + kAlignFloats, 0.0f);
+
+        const auto address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+        const auto misalignment = address % kAlignment;
+        const size_t offset =
+            misalignment ? (kAlignment - misalignment) / sizeof(float) : 0;
+
+        m_base = m_storage.data() + offset;
+        m_capacity = alignedSize(capacity);
+        m_top = 0;
+        m_blockFrames = 0;
+        m_overflows.store(0, std::memory_order_relaxed);
+    }
+} // namespace dtracker::audio::playback
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/performance_monitor.hpp>
+#include <dtracker/audio/playback/post_fader.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+#include <dtracker/audio/playback/sequenced_track_playback_unit.hpp>
+
+namespace dtracker::audio::playback
+{
+    SequencedTrackPlaybackUnit::SequencedTrackPlaybackUnit(
+        std::shared_ptr<TrackSequencer> sequencer)
+        : m_sequencer(std::move(sequencer))
+    {
+        // Pre-allocate memory for voices to prevent allocation on the audio
+        // thread. Without a per-track limit, one track can hold every voice
+        // in the pool.
+        if (m_sequencer)
+            m_voices.reserve(m_sequencer->voiceCapacity());
+    }
+
+    void SequencedTrackPlaybackUnit::setVolume(float v)
+    {
+        m_volume = std::clamp(v, 0.0f, 1.0f);
+    }
+
+    void SequencedTrackPlaybackUnit::setPan(float p)
+    {
+        m_pan = std::clamp(p, -1.0f, 1.0f);
+    }
+
+    // Routes realtime parameter changes to the track's gain stage.
+    void SequencedTrackPlaybackUnit::setParameter(UnitParam param, float value)
+    {
+        switch (param)
+        {
+        case UnitParam::Volume:
+            setVolume(value);
+            break;
+        case UnitParam::Pan:
+            setPan(value);
+            break;
+        }
+    }
+
+    // Overwrites the buffer with one block of the track.
+    void SequencedTrackPlaybackUnit::render(float *buffer, unsigned int nFrames,
+                                            unsigned int channels,
+                                            const types::RenderContext &context)
+    {
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
+        renderAdd(buffer, nFrames, channels, context, 1.0f, 1.0f);
+    }
+
+    void SequencedTrackPlaybackUnit::renderAdd(
+        float *buffer, unsigned int nFrames, unsigned int channels,
+        const types::RenderContext &context, float gainLeft, float gainRight)
+    {
+        if (!m_sequencer)
+            return;
+
+        // The first block anchors the schedule to the transport.
+        if (!m_started)
+        {
+            m_sequencer->setOrigin(context.frame);
+            m_started = true;
+        }
+
+        const std::uint64_t blockStart = m_sequencer->trackFrame(context.frame);
+        const std::uint64_t blockEnd = blockStart + nFrames;
+
+        if (m_selfScheduling)
+            scheduleBlock(blockStart, blockEnd, context);
+        else
+            startDueNotes(blockStart, blockEnd);
+        m_position = blockEnd;
+
+        float leftGain = m_volume;
+        float rightGain = m_volume;
+        if (channels == 2)
+            dsp::panGains(m_volume, m_pan, leftGain, rightGain);
+
+        mixPostFader(m_waveformTap.get(), m_spectrumTap.get(),
+                     m_levelMeter.get(), buffer, nFrames, channels, context,
+                     leftGain, rightGain, gainLeft, gainRight,
+                     [&](float *out, float left, float right)
+                     {
+                         mixVoices(out, nFrames, channels, context, left,
+                                   right);
+                     });
+
+        if (context.monitor)
+            context.monitor->countVoices(m_voices.size());
+    }
+
+    // Starts every note due in this block at the frame it falls on. A note
+    // the sequencer delivered late starts at once.
+    size_t SequencedTrackPlaybackUnit::startDueNotes(std::uint64_t blockStart,
+                                                     std::uint64_t blockEnd)
+    {
+        size_t started = 0;
+        auto &events = m_sequencer->events();
+        while (NoteEvent *event = events.front())
+        {
+            if (event->frame >= blockEnd)
+                break;
+
+            if (event->voice)
+            {
+                event->voice->setStartOffset(
+                    event->frame > blockStart
+                        ? static_cast<unsigned int>(event->frame - blockStart)
+                        : 0u);
+                m_voices.push_back(std::move(event->voice));
+            }
+            events.pop();
+            ++started;
+        }
+        return started;
+    }
+
+    // The sequencer stops at a full ring without losing its place, so a
+    // block denser than the ring is scheduled in several rounds.
+    void SequencedTrackPlaybackUnit::scheduleBlock(
+        std::uint64_t blockStart, std::uint64_t blockEnd,
+        const types::RenderContext &context)
+    {
+        auto &events = m_sequencer->events();
+        for (;;)
+        {
+            m_sequencer->scheduleUntil(blockEnd, context.bpm,
+                                       context.isLooping);
+            const bool full = events.size() >= events.capacity();
+            if (startDueNotes(blockStart, blockEnd) == 0 || !full)
+                return;
+        }
+    }
+
+    void SequencedTrackPlaybackUnit::mixVoices(
+        float *buffer, unsigned int nFrames, unsigned int channels,
+        const types::RenderContext &context, float leftGain, float rightGain)
+    {
+        for (auto it = m_voices.begin(); it != m_voices.end();)
+        {
+            (*it)->renderAdd(buffer, nFrames, channels, context, leftGain,
+                             rightGain);
+
+            // Finished voices go straight back to the lock-free pool.
+            if ((*it)->isFinished())
+            {
+                it = m_voices.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void SequencedTrackPlaybackUnit::setWaveformTap(
+        std::shared_ptr<WaveformTap> tap)
+    {
+        m_waveformTap = std::move(tap);
+    }
+
+    void SequencedTrackPlaybackUnit::setSpectrumTap(
+        std::shared_ptr<WaveformTap> tap)
+    {
+        m_spectrumTap = std::move(tap);
+    }
+
+    void SequencedTrackPlaybackUnit::setLevelMeter(
+        std::shared_ptr<LevelMeter> meter)
+    {
+        m_levelMeter = std::move(meter);
+    }
+
+    void SequencedTrackPlaybackUnit::setSelfScheduling(bool enabled)
+    {
+        m_selfScheduling = enabled;
+    }
+
+    void SequencedTrackPlaybackUnit::reset() {}
+
+    bool SequencedTrackPlaybackUnit::isFinished() const
+    {
+        if (!m_sequencer)
+            return true;
+
+        return m_sequencer->hasFinished() && m_sequencer->events().empty() &&
+               m_voices.empty() && m_position >= m_sequencer->endFrame();
+    }
+
+    const std::shared_ptr<TrackSequencer> &
+    SequencedTrackPlaybackUnit::sequencer() const
+    {
+        return m_sequencer;
+    }
+} // namespace dtracker::audio::playback
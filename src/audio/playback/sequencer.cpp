@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <dtracker/audio/playback/sequencer.hpp>
+
+namespace dtracker::audio::playback
+{
+    Sequencer::Sequencer(const Transport &transport) : m_transport(transport)
+    {
+    }
+
+    Sequencer::~Sequencer()
+    {
+        stop();
+    }
+
+    // Waking four times per window leaves three quarters of it as margin
+    // for a late wake-up.
+    void Sequencer::setLookahead(unsigned int frames, unsigned int sampleRate)
+    {
+        m_lookahead.store(frames, std::memory_order_relaxed);
+        if (sampleRate == 0)
+            return;
+
+        const auto interval = std::chrono::microseconds(
+            static_cast<std::int64_t>(frames) * 1000000 / (4 * sampleRate));
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        m_interval = std::max(interval, std::chrono::microseconds(1000));
+    }
+
+    unsigned int Sequencer::lookahead() const
+    {
+        return m_lookahead.load(std::memory_order_relaxed);
+    }
+
+    void Sequencer::setBpm(float bpm)
+    {
+        m_bpm.store(bpm, std::memory_order_relaxed);
+    }
+
+    void Sequencer::setLooping(bool isLooping)
+    {
+        m_isLooping.store(isLooping, std::memory_order_relaxed);
+    }
+
+    // A track has not been rendered yet, so its window starts at frame 0.
+    void Sequencer::addTrack(std::shared_ptr<TrackSequencer> track)
+    {
+        if (!track)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_tracksMutex);
+            track->scheduleUntil(lookahead(),
+                                 m_bpm.load(std::memory_order_relaxed),
+                                 m_isLooping.load(std::memory_order_relaxed));
+            m_tracks.push_back(std::move(track));
+        }
+        start();
+    }
+
+    void Sequencer::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        m_tracks.clear();
+    }
+
+    void Sequencer::start()
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (m_thread.joinable())
+            return;
+
+        m_stopRequested = false;
+        m_thread = std::thread(&Sequencer::run, this);
+    }
+
+    void Sequencer::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            if (!m_thread.joinable())
+                return;
+            m_stopRequested = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    // Tracks whose sequence has ended are dropped; the audio graph keeps
+    // its own reference until their last notes have played.
+    void Sequencer::schedule()
+    {
+        const std::uint64_t now = m_transport.frame();
+        const unsigned int window = lookahead();
+        const float bpm = m_bpm.load(std::memory_order_relaxed);
+        const bool isLooping = m_isLooping.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        for (const auto &track : m_tracks)
+            track->scheduleUntil(track->trackFrame(now) + window, bpm,
+                                 isLooping);
+
+        m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(),
+                                      [](const auto &track)
+                                      { return track->hasFinished(); }),
+                       m_tracks.end());
+    }
+
+    // Polls the transport rather than being woken by the audio thread, so
+    // the callback never has to signal anything.
+    void Sequencer::run()
+    {
+        std::unique_lock<std::mutex> lock(m_threadMutex);
+        while (!m_stopRequested)
+        {
+            lock.unlock();
+            schedule();
+            lock.lock();
+
+            m_wake.wait_for(lock, m_interval,
+                            [this] { return m_stopRequested; });
+        }
+    }
+} // namespace dtracker::audio::playback
@@ -1,14 +1,17 @@
 #include <algorithm> // For std::fill
 #include <cmath>     // For std::max/min
+#include <cstdint>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/performance_monitor.hpp>
+#include <dtracker/audio/playback/post_fader.hpp>
 #include <dtracker/audio/playback/track_playback_unit.hpp>
 #include <iostream>
 
 namespace dtracker::audio::playback
 {
     TrackPlaybackUnit::TrackPlaybackUnit(
-        BufferPool *bufferPool,
-        rigtorp::SPSCQueue<BufferPool::PooledBufferPtr> *waveformQueue)
-        : m_bufferPool(bufferPool), m_waveformQueue(waveformQueue)
+        std::shared_ptr<WaveformTap> waveformTap)
+        : m_waveformTap(std::move(waveformTap))
     {
     }
 
@@ -29,67 +32,121 @@ namespace dtracker::audio::playback
         m_pan = std::clamp(p, -1.0f, 1.0f);
     }
 
+    void TrackPlaybackUnit::setLevelMeter(std::shared_ptr<LevelMeter> meter)
+    {
+        m_levelMeter = std::move(meter);
+    }
+
+    // Routes realtime parameter changes to the track's gain stage.
+    void TrackPlaybackUnit::setParameter(UnitParam param, float value)
+    {
+        switch (param)
+        {
+        case UnitParam::Volume:
+            setVolume(value);
+            break;
+        case UnitParam::Pan:
+            setPan(value);
+            break;
+        }
+    }
+
+    // Overwrites the buffer with one block of the track.
     void TrackPlaybackUnit::render(float *buffer, unsigned int nFrames,
                                    unsigned int channels,
                                    const types::RenderContext &context)
     {
-        // Your existing render logic to play the sequence and apply vol/pan
-        // comes first. It correctly fills the `buffer` with processed audio.
+        dsp::clear(buffer, static_cast<size_t>(nFrames) * channels);
+        renderAdd(buffer, nFrames, channels, context, 1.0f, 1.0f);
+    }
+
+    // Plays the sequence into the parent's buffer. Volume and pan are folded
+    // into the gains handed down to the pattern, so they are applied while
+    // the notes are summed rather than in a separate pass. A tapped or
+    // metered track is mixed on its own first, so the tap and the meter see
+    // it after its own fader.
+    void TrackPlaybackUnit::renderAdd(float *buffer, unsigned int nFrames,
+                                      unsigned int channels,
+                                      const types::RenderContext &context,
+                                      float gainLeft, float gainRight)
+    {
         if (isFinished() || m_units.empty())
-        {
-            std::fill(buffer, buffer + nFrames * channels, 0.0f);
             return;
-        }
-
-        auto &currentUnit = m_units[m_currentUnitIndex];
-        currentUnit->render(buffer, nFrames, channels, context);
 
+        float leftGain = m_volume;
+        float rightGain = m_volume;
         if (channels == 2)
+            dsp::panGains(m_volume, m_pan, leftGain, rightGain);
+
+        mixPostFader(m_waveformTap.get(), nullptr, m_levelMeter.get(), buffer,
+                     nFrames, channels, context, leftGain, rightGain, gainLeft,
+                     gainRight,
+                     [&](float *out, float left, float right)
+                     {
+                         renderPatterns(out, nFrames, channels, context, left,
+                                        right);
+                     });
+
+        // Report every pattern's notes, tails included, once per block.
+        if (context.monitor)
         {
-            float leftGain = m_volume * (1.0f - std::max(0.0f, m_pan));
-            float rightGain = m_volume * (1.0f + std::min(0.0f, m_pan));
-            for (unsigned int i = 0; i < nFrames; ++i)
-            {
-                buffer[i * 2] *= leftGain;
-                buffer[i * 2 + 1] *= rightGain;
-            }
+            size_t voices = 0;
+            for (const auto &unit : m_units)
+                voices += unit->activeNoteCount();
+            context.monitor->countVoices(voices);
         }
+    }
 
-        // TODO: Implement the waveform tap for individual tracks.
-        // Currently, enabling this exhausts the buffer pool too quickly.
-        // This is because a resource leak. The buffers acquired by the
-        // TrackPlaybackUnits are pushed into queues that are never emptied.
-        // After a few seconds, all 128 buffers from the shared BufferPool
-        // are stuck inside these unread queues. The pool runs dry,
-        // m_bufferPool->acquire() starts returning nullptr, and the waveform
-        // tap in the MixerPlaybackUnit stops working because it can't get any
-        // more empty buffers.
-
-        // --- WAVEFORM TAP ---
-        // At this point, 'buffer' contains the final processed audio.
-        // if (m_bufferPool && m_waveformQueue)
-        // {
-        //     // Acquire a recycled buffer from the pool.
-        //     auto transportBuffer = m_bufferPool->acquire();
-        //     if (transportBuffer)
-        //     {
-        //         // Copy this frame's audio into the transport buffer.
-        //         size_t samplesToCopy = std::min((size_t)nFrames * channels,
-        //                                         transportBuffer->size());
-        //         memcpy(transportBuffer->data(), buffer,
-        //                samplesToCopy * sizeof(float));
-
-        //         // Push the smart pointer to the buffer onto the lock-free
-        //         // queue.
-        //         // If the push fails (queue is full), the transportBuffer is
-        //         // destroyed here, returning the raw buffer to the pool.
-        //         m_waveformQueue->try_push(std::move(transportBuffer));
-        //     }
-        // }
-
-        // Handle looping behavior
-        if (currentUnit->hasFinishedLoop())
+    void TrackPlaybackUnit::renderPatterns(float *buffer, unsigned int nFrames,
+                                           unsigned int channels,
+                                           const types::RenderContext &context,
+                                           float leftGain, float rightGain)
+    {
+        // Render up to the end of the current pattern's loop, switch
+        // patterns right there, and carry on with the rest of the block. The
+        // next pattern starts at the loop's exact end time, fraction
+        // included, so loops stay locked to the transport. Patterns
+        // that end without covering any frames are counted, so a sequence
+        // with no length cannot spin here.
+        types::RenderContext chunkContext = context;
+        unsigned int offset = 0;
+        size_t emptySwitches = 0;
+        while (offset < nFrames && emptySwitches <= m_units.size())
         {
+            auto &currentUnit = m_units[m_currentUnitIndex];
+            float *out = buffer + static_cast<size_t>(offset) * channels;
+            chunkContext.frame = context.frame + offset;
+
+            unsigned int frames = nFrames - offset;
+            const Transport::Time loopEnd =
+                currentUnit->loopEndTime(chunkContext);
+            if (loopEnd != PatternPlaybackUnit::kNever)
+            {
+                const std::uint64_t endFrame =
+                    Transport::frameAtOrAfter(loopEnd);
+                if (endFrame < chunkContext.frame + frames)
+                    frames = endFrame > chunkContext.frame
+                                 ? static_cast<unsigned int>(
+                                       endFrame - chunkContext.frame)
+                                 : 0u;
+            }
+
+            if (frames > 0)
+            {
+                currentUnit->renderAdd(out, frames, channels, chunkContext,
+                                       leftGain, rightGain);
+                emptySwitches = 0;
+            }
+            else
+            {
+                ++emptySwitches;
+            }
+            offset += frames;
+
+            // Handle looping behavior
+            if (!currentUnit->hasFinishedLoop())
+                break;
+
             if (context.isLooping)
             {
                 // Reset the current pattern and go back to the first pattern
@@ -102,6 +159,20 @@ namespace dtracker::audio::playback
                 currentUnit->reset();
                 m_currentUnitIndex++;
             }
+            else
+            {
+                // The last pattern plays out its tails.
+                chunkContext.frame = context.frame + offset;
+                if (offset < nFrames)
+                    currentUnit->renderAdd(
+                        buffer + static_cast<size_t>(offset) * channels,
+                        nFrames - offset, channels, chunkContext, leftGain,
+                        rightGain);
+                break;
+            }
+
+            if (loopEnd != PatternPlaybackUnit::kNever)
+                m_units[m_currentUnitIndex]->startAt(loopEnd);
         }
     }
 
@@ -120,6 +191,10 @@ namespace dtracker::audio::playback
 
     bool TrackPlaybackUnit::isFinished() const
     {
+        // A track with nothing to play has nothing left to render.
+        if (m_units.empty())
+            return true;
+
         // The track is finished once it has played all the patterns in its
         // sequence.
         return m_currentUnitIndex >= m_units.size() - 1 &&
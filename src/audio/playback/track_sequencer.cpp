@@ -0,0 +1,156 @@
+#include <dtracker/audio/playback/track_sequencer.hpp>
+
+namespace dtracker::audio::playback
+{
+    TrackSequencer::TrackSequencer(
+        std::vector<dtracker::tracker::types::ActivePattern> patterns,
+        SampleBlueprint blueprint, UnitPool *sampleUnitPool,
+        unsigned int sampleRate, size_t capacity)
+        : m_patterns(std::move(patterns)), m_blueprint(std::move(blueprint)),
+          m_sampleUnitPool(sampleUnitPool), m_sampleRate(sampleRate),
+          m_events(capacity)
+    {
+        if (m_patterns.empty())
+            m_finished.store(true, std::memory_order_release);
+    }
+
+    void TrackSequencer::setPolyphony(PolyphonyManager *polyphony, int trackId)
+    {
+        m_polyphony = polyphony;
+        m_trackId = trackId;
+    }
+
+    // Walks the sequence exactly as TrackPlaybackUnit does at render time:
+    // steps land on whole step lengths added in fixed point, and each
+    // pattern starts at the exact time the previous one ended.
+    void TrackSequencer::scheduleUntil(std::uint64_t untilFrame, float bpm,
+                                       bool isLooping)
+    {
+        if (!m_sampleUnitPool || hasFinished())
+            return;
+
+        // Patterns without steps take no time. Counting them stops a
+        // sequence made only of empty patterns from spinning here.
+        size_t emptyPatterns = 0;
+        while (emptyPatterns <= m_patterns.size())
+        {
+            const auto &pattern = m_patterns[m_patternIndex];
+            const Transport::Time stepTime =
+                Transport::stepLength(m_sampleRate, bpm, pattern.stepsPerBeat);
+            if (stepTime == 0)
+                return;
+
+            while (m_step < pattern.steps.size())
+            {
+                const std::uint64_t stepFrame =
+                    Transport::frameAtOrAfter(m_nextStepTime);
+                if (stepFrame >= untilFrame)
+                    return;
+
+                // A non-negative ID is a note, not a rest.
+                const int sampleId = pattern.steps[m_step];
+                if (sampleId >= 0 && !pushNote(sampleId, stepFrame))
+                    return;
+
+                ++m_step;
+                m_nextStepTime += stepTime;
+            }
+
+            emptyPatterns = pattern.steps.empty() ? emptyPatterns + 1 : 0;
+            if (!nextPattern(isLooping))
+                return;
+        }
+    }
+
+    // Looping repeats the first pattern; otherwise the sequence moves on and
+    // ends after the last pattern's final step has run its length.
+    bool TrackSequencer::nextPattern(bool isLooping)
+    {
+        m_step = 0;
+        if (isLooping)
+        {
+            m_patternIndex = 0;
+            return true;
+        }
+
+        if (m_patternIndex + 1 < m_patterns.size())
+        {
+            ++m_patternIndex;
+            return true;
+        }
+
+        m_endFrame.store(Transport::frameAtOrAfter(m_nextStepTime),
+                         std::memory_order_relaxed);
+        m_finished.store(true, std::memory_order_release);
+        return false;
+    }
+
+    // The lookup and the polyphony manager's mutex are paid here, off the
+    // audio thread.
+    bool TrackSequencer::pushNote(int sampleId, std::uint64_t frame)
+    {
+        auto blueprintIt = m_blueprint.find(sampleId);
+        if (blueprintIt == m_blueprint.end())
+            return true;
+
+        // Only this thread pushes, so a slot free now is still free below.
+        // Checking first keeps a full ring from costing a voice, or stealing
+        // a sounding one, on every retry of the step.
+        if (m_events.size() >= m_events.capacity())
+            return false;
+
+        // The polyphony manager steals a voice if it has to. Without one,
+        // or if even stealing finds nothing free, the note is dropped.
+        auto voice = m_polyphony ? m_polyphony->acquire(m_trackId)
+                                 : m_sampleUnitPool->acquire();
+        if (!voice)
+            return true;
+
+        voice->reinitialize(blueprintIt->second);
+
+        return m_events.try_push(NoteEvent{frame, std::move(voice)});
+    }
+
+    std::uint64_t TrackSequencer::trackFrame(std::uint64_t transportFrame) const
+    {
+        const std::uint64_t start = origin();
+        if (start == kNoOrigin || transportFrame < start)
+            return 0;
+        return transportFrame - start;
+    }
+
+    rigtorp::SPSCQueue<NoteEvent> &TrackSequencer::events()
+    {
+        return m_events;
+    }
+
+    const SampleBlueprint &TrackSequencer::blueprint() const
+    {
+        return m_blueprint;
+    }
+
+    size_t TrackSequencer::voiceCapacity() const
+    {
+        return m_sampleUnitPool ? m_sampleUnitPool->capacity() : 0;
+    }
+
+    void TrackSequencer::setOrigin(std::uint64_t transportFrame)
+    {
+        m_origin.store(transportFrame, std::memory_order_release);
+    }
+
+    std::uint64_t TrackSequencer::origin() const
+    {
+        return m_origin.load(std::memory_order_acquire);
+    }
+
+    bool TrackSequencer::hasFinished() const
+    {
+        return m_finished.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t TrackSequencer::endFrame() const
+    {
+        return m_endFrame.load(std::memory_order_relaxed);
+    }
+} // namespace dtracker::audio::playback
@@ -0,0 +1,36 @@
+#include <cmath>
+#include <dtracker/audio/playback/transport.hpp>
+
+namespace dtracker::audio::playback
+{
+    // Computed in double and rounded once. Every pattern at the same tempo
+    // gets the same integer, which is what keeps them locked together.
+    Transport::Time Transport::stepLength(unsigned int sampleRate, float bpm,
+                                          float stepsPerBeat)
+    {
+        if (sampleRate == 0 || !(bpm > 0.0f) || !(stepsPerBeat > 0.0f))
+            return 0;
+
+        const double frames = 60.0 * sampleRate /
+                              (static_cast<double>(bpm) * stepsPerBeat);
+        return static_cast<Time>(
+            std::llround(std::ldexp(frames, kFractionBits)));
+    }
+
+    std::uint64_t Transport::frame() const
+    {
+        return m_frame.load(std::memory_order_relaxed);
+    }
+
+    // Only the audio thread writes, so a plain load and store is enough.
+    void Transport::advance(unsigned int nFrames)
+    {
+        m_frame.store(m_frame.load(std::memory_order_relaxed) + nFrames,
+                      std::memory_order_relaxed);
+    }
+
+    void Transport::reset()
+    {
+        m_frame.store(0, std::memory_order_relaxed);
+    }
+} // namespace dtracker::audio::playback
@@ -1,75 +1,162 @@
+#include <dtracker/audio/playback/reclaim_queue.hpp>
 #include <dtracker/audio/playback/unit_pool.hpp>
 #include <dtracker/sample/types.hpp>
 #include <stdexcept>
 
 namespace dtracker::audio::playback
 {
+    UnitPool::Handle::Handle(Handle &&other) noexcept
+        : m_pool(other.m_pool), m_unit(other.m_unit)
+    {
+        other.m_pool = nullptr;
+        other.m_unit = nullptr;
+    }
+
+    UnitPool::Handle &UnitPool::Handle::operator=(Handle &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            m_pool = other.m_pool;
+            m_unit = other.m_unit;
+            other.m_pool = nullptr;
+            other.m_unit = nullptr;
+        }
+        return *this;
+    }
+
+    UnitPool::Handle::~Handle()
+    {
+        reset();
+    }
+
+    void UnitPool::Handle::reset()
+    {
+        if (m_unit)
+            m_pool->release(m_unit);
+        m_pool = nullptr;
+        m_unit = nullptr;
+    }
+
     // Creates a pool with a fixed number of pre-allocated SamplePlaybackUnits.
     UnitPool::UnitPool(size_t size)
     {
         if (size == 0)
             throw std::invalid_argument("Object pool size cannot be zero.");
+        if (size >= kNil)
+            throw std::invalid_argument("Object pool size is too large.");
 
-        // Pre-allocate vector memory once to avoid reallocations during setup.
-        m_pool.reserve(size);
-        m_freeList.reserve(size);
+        // Create all objects up front as "blank" units. An array rather
+        // than a vector, since units hold atomics and cannot be moved.
+        m_pool = std::make_unique<SamplePlaybackUnit[]>(size);
+        m_next = std::make_unique<std::atomic<std::uint32_t>[]>(size);
+        m_generations = std::make_unique<std::atomic<std::uint32_t>[]>(size);
+        m_size = size;
 
-        // Create all objects up front and populate the free list.
+        // Chain every unit onto the free stack, unit 0 on top.
         for (size_t i = 0; i < size; ++i)
         {
-            // Create a "blank" unit in place.
-            m_pool.emplace_back(sample::types::SampleDescriptor{});
-            // Add a pointer to the newly created unit to the free list.
-            m_freeList.push_back(&m_pool[i]);
+            m_next[i].store(i + 1 < size ? static_cast<std::uint32_t>(i + 1)
+                                         : kNil,
+                            std::memory_order_relaxed);
+            m_generations[i].store(0, std::memory_order_relaxed);
         }
+        m_head.store(pack(0, 0), std::memory_order_release);
     }
 
-    // Acquires an available unit from the pool.
+    // Pops the top of the free stack.
     UnitPool::PooledUnitPtr UnitPool::acquire()
     {
-        // Lock to ensure thread-safe modification of the free list.
-        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        std::uint32_t index;
+        for (;;)
+        {
+            index = static_cast<std::uint32_t>(head);
+            if (index == kNil)
+                return nullptr; // Return null if all objects are in use.
 
-        if (m_freeList.empty())
-            return nullptr; // Return null if all objects are in use.
+            // The unit may be popped by another thread before the swap, in
+            // which case this read is stale; the tag then fails the swap.
+            const std::uint32_t next =
+                m_next[index].load(std::memory_order_relaxed);
+            const auto tag = static_cast<std::uint32_t>(head >> 32) + 1;
+            if (m_head.compare_exchange_weak(head, pack(tag, next),
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire))
+                break;
+        }
 
-        // Get a pointer from the end of the list.
-        SamplePlaybackUnit *unit = m_freeList.back();
-        m_freeList.pop_back();
+        SamplePlaybackUnit *unit = &m_pool[index];
 
+#ifndef NDEBUG
         // Sanity check to help debug potential logic errors.
         if (unit->isCheckedOut)
             throw std::logic_error(
                 "Object pool corruption: Double checkout detected!");
-
+#endif
         unit->isCheckedOut = true;
 
-        auto deleter = [this](SamplePlaybackUnit *returnedUnit)
-        { this->release(returnedUnit); };
+        return Handle(this, unit);
+    }
 
-        // Return the raw pointer wrapped in a unique_ptr that uses a custom
-        // deleter.
-        // return PooledUnitPtr(unit,
-        //                      [this](SamplePlaybackUnit *u) { release(u); });
-        return std::shared_ptr<SamplePlaybackUnit>(unit, deleter);
+    size_t UnitPool::capacity() const
+    {
+        return m_size;
     }
 
-    // Returns a unit's pointer back to the free list.
-    void UnitPool::release(SamplePlaybackUnit *unit)
+    std::uint32_t UnitPool::generation(const SamplePlaybackUnit *unit) const
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_generations[unit - m_pool.get()].load(
+            std::memory_order_acquire);
+    }
 
+    void UnitPool::setReclaimQueue(ReclaimQueue *reclaim)
+    {
+        m_reclaim = reclaim;
+    }
+
+    void UnitPool::forEachRegion(
+        const std::function<void(const void *, size_t)> &visit) const
+    {
+        visit(m_pool.get(), m_size * sizeof(SamplePlaybackUnit));
+        visit(m_next.get(), m_size * sizeof(std::atomic<std::uint32_t>));
+        visit(m_generations.get(),
+              m_size * sizeof(std::atomic<std::uint32_t>));
+    }
+
+    // Pushes the unit back on top of the free stack. Runs on whichever
+    // thread drops the handle, often the audio thread, so the unit's sample
+    // goes to the reclaim queue: an idle unit must not keep an evicted
+    // sample alive, but freeing it here could happen mid-callback.
+    void UnitPool::release(SamplePlaybackUnit *unit)
+    {
+#ifndef NDEBUG
         // Sanity check to guard against releasing the same object twice.
         if (!unit->isCheckedOut)
             throw std::logic_error(
                 "Object pool corruption: Double release detected!");
-
-        unit->reset(); // Reset the unit to a clean state for its next use.
+#endif
         unit->isCheckedOut = false;
 
-        // Add the pointer back to the list, making it available for the next
-        // acquire().
-        m_freeList.push_back(unit);
+        // Clear the unit before it is back on the stack for others to take.
+        ReclaimQueue::Retired sample = unit->releaseSample();
+        if (m_reclaim && sample)
+            m_reclaim->retire(std::move(sample));
+
+        const auto index = static_cast<std::uint32_t>(unit - m_pool.get());
+        m_generations[index].fetch_add(1, std::memory_order_release);
+
+        std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            m_next[index].store(static_cast<std::uint32_t>(head),
+                                std::memory_order_relaxed);
+            const auto tag = static_cast<std::uint32_t>(head >> 32) + 1;
+            if (m_head.compare_exchange_weak(head, pack(tag, index),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed))
+                break;
+        }
     }
 
-} // namespace dtracker::audio::playback
\ No newline at end of file
+} // namespace dtracker::audio::playback
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+#include <stdexcept>
+
+namespace dtracker::audio::playback
+{
+    WaveformTap::WaveformTap(unsigned int channels, unsigned int blockFrames,
+                             size_t blocks, unsigned int decimation)
+        : m_channels(channels), m_blockFrames(blockFrames), m_blocks(blocks),
+          m_decimation(decimation)
+    {
+        if (channels == 0 || blockFrames == 0 || blocks < 2 || decimation == 0)
+            throw std::invalid_argument(
+                "Waveform tap needs channels, frames and two blocks.");
+
+        m_peaks = std::make_unique<float[]>(m_channels);
+        std::fill(m_peaks.get(), m_peaks.get() + m_channels, 0.0f);
+
+        m_samples =
+            std::make_unique<std::atomic<float>[]>(m_blocks * blockSamples());
+        m_sequences = std::make_unique<std::atomic<std::uint64_t>[]>(m_blocks);
+        for (size_t i = 0; i < m_blocks * blockSamples(); ++i)
+            m_samples[i].store(0.0f, std::memory_order_relaxed);
+        for (size_t i = 0; i < m_blocks; ++i)
+            m_sequences[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Runs on the audio thread. A decimated frame is published once all the
+    // frames it covers have been seen, so partial groups carry over.
+    void WaveformTap::write(const float *samples, unsigned int frames,
+                            unsigned int channels)
+    {
+        if (channels != m_channels)
+            return;
+
+        m_discarding = false;
+        if (m_decimation == 1)
+        {
+            append(samples, frames);
+            return;
+        }
+
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            for (unsigned int ch = 0; ch < m_channels; ++ch)
+            {
+                const float sample = samples[ch];
+                if (std::fabs(sample) > std::fabs(m_peaks[ch]))
+                    m_peaks[ch] = sample;
+            }
+            samples += m_channels;
+
+            if (++m_peakFrames == m_decimation)
+            {
+                append(m_peaks.get(), 1);
+                std::fill(m_peaks.get(), m_peaks.get() + m_channels, 0.0f);
+                m_peakFrames = 0;
+            }
+        }
+    }
+
+    void WaveformTap::discard()
+    {
+        if (!m_discarding)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_discarding = true;
+        }
+
+        // The slot stays marked as in progress, so nobody reads the part
+        // already written, and the next write starts the block over.
+        m_writeFrame = 0;
+        m_peakFrames = 0;
+        std::fill(m_peaks.get(), m_peaks.get() + m_channels, 0.0f);
+    }
+
+    // The stores are relaxed atomics, which compile to plain moves; ordering
+    // comes from the sequence numbers.
+    void WaveformTap::append(const float *samples, unsigned int frames)
+    {
+        while (frames > 0)
+        {
+            if (m_writeFrame == 0)
+                beginBlock(m_writeBlock);
+
+            const unsigned int count =
+                std::min(frames, m_blockFrames - m_writeFrame);
+            const size_t slot = m_writeBlock % m_blocks;
+            std::atomic<float> *dst =
+                m_samples.get() + slot * blockSamples() +
+                static_cast<size_t>(m_writeFrame) * m_channels;
+            const size_t n = static_cast<size_t>(count) * m_channels;
+            for (size_t i = 0; i < n; ++i)
+                dst[i].store(samples[i], std::memory_order_relaxed);
+
+            samples += n;
+            frames -= count;
+            m_writeFrame += count;
+
+            // A full block is published and the next one begins.
+            if (m_writeFrame == m_blockFrames)
+            {
+                m_sequences[slot].store(2 * m_writeBlock + 2,
+                                        std::memory_order_release);
+                ++m_writeBlock;
+                m_writeFrame = 0;
+                m_published.store(m_writeBlock, std::memory_order_release);
+            }
+        }
+    }
+
+    // The fence keeps the sample stores that follow from being seen before
+    // the slot is marked as in progress.
+    void WaveformTap::beginBlock(std::uint64_t block)
+    {
+        m_sequences[block % m_blocks].store(2 * block + 1,
+                                            std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    WaveformTap::Reader::Reader(std::shared_ptr<const WaveformTap> tap)
+        : m_tap(std::move(tap))
+    {
+        if (m_tap)
+            m_cursor = m_tap->publishedBlocks();
+    }
+
+    bool WaveformTap::Reader::read(std::vector<float> &out)
+    {
+        return m_tap && m_tap->readFrom(m_cursor, out, m_skipped);
+    }
+
+    std::uint64_t WaveformTap::Reader::skippedBlocks() const
+    {
+        return m_skipped;
+    }
+
+    const WaveformTap *WaveformTap::Reader::tap() const
+    {
+        return m_tap.get();
+    }
+
+    // Only loads: readers share nothing with the writer or each other that
+    // they would have to store to.
+    bool WaveformTap::readFrom(std::uint64_t &cursor, std::vector<float> &out,
+                               std::uint64_t &skipped) const
+    {
+        const std::uint64_t published =
+            m_published.load(std::memory_order_acquire);
+
+        // The slot after the newest block may already be half overwritten,
+        // so only the other blocks can still be read.
+        const std::uint64_t oldest =
+            published >= m_blocks ? published - m_blocks + 1 : 0;
+        if (cursor < oldest)
+        {
+            skipped += oldest - cursor;
+            cursor = oldest;
+        }
+
+        bool found = false;
+        out.resize(blockSamples());
+        while (cursor < published)
+        {
+            const size_t slot = cursor % m_blocks;
+            const std::uint64_t expected = 2 * cursor + 2;
+            const std::uint64_t before =
+                m_sequences[slot].load(std::memory_order_acquire);
+
+            if (before == expected)
+            {
+                const std::atomic<float> *src =
+                    m_samples.get() + slot * blockSamples();
+                for (size_t i = 0; i < out.size(); ++i)
+                    out[i] = src[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequences[slot].load(std::memory_order_relaxed) ==
+                    expected)
+                {
+                    ++cursor;
+                    found = true;
+                    break;
+                }
+            }
+
+            // The writer lapped this block while it was being read.
+            ++skipped;
+            ++cursor;
+        }
+        return found;
+    }
+
+    unsigned int WaveformTap::channels() const
+    {
+        return m_channels;
+    }
+
+    unsigned int WaveformTap::blockFrames() const
+    {
+        return m_blockFrames;
+    }
+
+    unsigned int WaveformTap::decimation() const
+    {
+        return m_decimation;
+    }
+
+    size_t WaveformTap::capacity() const
+    {
+        return m_blocks;
+    }
+
+    std::uint64_t WaveformTap::publishedBlocks() const
+    {
+        return m_published.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t WaveformTap::droppedBlocks() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    void WaveformTap::forEachRegion(
+        const std::function<void(const void *, size_t)> &visit) const
+    {
+        visit(m_samples.get(),
+              m_blocks * blockSamples() * sizeof(std::atomic<float>));
+        visit(m_sequences.get(),
+              m_blocks * sizeof(std::atomic<std::uint64_t>));
+    }
+
+    size_t WaveformTap::blockSamples() const
+    {
+        return static_cast<size_t>(m_blockFrames) * m_channels;
+    }
+} // namespace dtracker::audio::playback
@@ -1,25 +1,107 @@
-#include <dtracker/audio/playback/pattern_playback_unit.hpp>
+#include <algorithm>
 #include <dtracker/audio/playback/sample_playback_unit.hpp>
-#include <dtracker/audio/playback/track_playback_unit.hpp>
+#include <dtracker/audio/playback/track_sequencer.hpp>
 #include <dtracker/audio/playback_manager.hpp>
+#include <dtracker/audio/render/offline_renderer.hpp>
 
 namespace dtracker::audio
 {
+    namespace
+    {
+        // Lets a pooled voice play on its own in the mixer, which holds its
+        // units by shared_ptr. The voice goes back to the pool when the
+        // mixer's collector drops this wrapper.
+        class PooledVoiceUnit : public playback::PlaybackUnit
+        {
+          public:
+            explicit PooledVoiceUnit(playback::UnitPool::PooledUnitPtr voice)
+                : m_voice(std::move(voice))
+            {
+            }
+
+            void render(float *buffer, unsigned int nFrames,
+                        unsigned int channels,
+                        const types::RenderContext &context) override
+            {
+                m_voice->render(buffer, nFrames, channels, context);
+            }
+
+            void renderAdd(float *buffer, unsigned int nFrames,
+                           unsigned int channels,
+                           const types::RenderContext &context,
+                           float gainLeft, float gainRight) override
+            {
+                m_voice->renderAdd(buffer, nFrames, channels, context,
+                                   gainLeft, gainRight);
+            }
+
+            void reset() override
+            {
+                m_voice->reset();
+            }
+
+            bool isFinished() const override
+            {
+                return m_voice->isFinished();
+            }
+
+          private:
+            playback::UnitPool::PooledUnitPtr m_voice;
+        };
+    } // namespace
+
     // Initializes PlaybackManager with an Engine pointer
     PlaybackManager::PlaybackManager(IEngine *engine,
                                      sample::IManager *sampleManager,
                                      tracker::ITrackManager *trackManager)
-        : m_engine(engine), m_sampleManager(sampleManager),
+        : m_masterWaveformTap(std::make_shared<playback::WaveformTap>()),
+          m_masterLevelMeter(std::make_unique<playback::LevelMeter>(
+              engine->getSettings().sampleRate)),
+          m_spectrumAnalyzer(engine->getSettings().sampleRate),
+          m_engine(engine), m_sampleManager(sampleManager),
           m_trackManager(trackManager), m_unitPool(128),
-          // Create a pool of 128 buffers, each large enough for a common buffer
-          // size.
-          m_bufferPool(128, 1024)
+          m_polyphony(&m_unitPool)
     {
+        m_engine->mixerUnit()->setWaveformTap(m_masterWaveformTap.get());
+        m_engine->mixerUnit()->setLevelMeter(m_masterLevelMeter.get());
+
+        m_sequencer =
+            std::make_unique<playback::Sequencer>(m_engine->transport());
+
+        // Voices drop their samples when released, often on the audio
+        // thread, so the engine's collector frees them.
+        m_unitPool.setReclaimQueue(m_engine->reclaimQueue());
+
+        // The pools are read on every block, so keep them out of swap.
+        const auto lock = [this](const void *data, size_t bytes)
+        { m_engine->lockMemory(data, bytes); };
+        m_unitPool.forEachRegion(lock);
+        m_masterWaveformTap->forEachRegion(lock);
+
+        m_spectrumAnalyzer.attach(kMasterSpectrumId, m_masterWaveformTap);
+        m_spectrumAnalyzer.start();
+
+        // Let samples loaded from now on be converted to the engine's rate
+        // before they are played.
+        if (m_sampleManager)
+            m_sampleManager->setTargetSampleRate(
+                engine->getSettings().sampleRate);
+    }
 
-        m_masterWaveFormQueue = std::make_unique<
-            rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>>(64);
-        m_engine->mixerUnit()->setBufferPool(&m_bufferPool);
-        m_engine->mixerUnit()->setWaveformQueue(m_masterWaveFormQueue.get());
+    PlaybackManager::~PlaybackManager()
+    {
+        m_spectrumAnalyzer.stop();
+        // Both setters wait out a block still using the master tap or
+        // meter, so they can be destroyed along with the manager.
+        m_engine->mixerUnit()->setWaveformTap(nullptr);
+        m_engine->mixerUnit()->setLevelMeter(nullptr);
+        m_sequencer->stop();
+        unlockSamples();
+
+        const auto unlock = [this](const void *data, size_t bytes)
+        { m_engine->unlockMemory(data, bytes); };
+        m_unitPool.forEachRegion(unlock);
+        m_masterWaveformTap->forEachRegion(unlock);
     }
 
     void dtracker::audio::PlaybackManager::playSample(
@@ -36,8 +118,20 @@ namespace dtracker::audio
         {
             m_engine->mixerUnit()->clear();
         }
+        m_sequencer->clear();
+        unlockSamples();
+        {
+            std::lock_guard<std::mutex> lock(m_trackPlayersMutex);
+            m_trackPlayers.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_levelMetersMutex);
+            m_levelMeters.clear();
+        }
         // Also clear out all the waveform resources.
         std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
+        for (const auto &[trackId, tap] : m_waveformQueues)
+            m_spectrumAnalyzer.detach(trackId);
         m_waveformQueues.clear();
     }
 
@@ -55,9 +149,9 @@ namespace dtracker::audio
         if (!m_engine)
             return;
 
-        // Acquire a recycled player from the pool. This is fast and
-        // allocation-free.
-        auto unitPtr = m_unitPool.acquire();
+        // Acquire a recycled player through the polyphony manager, which
+        // every voice from the pool must go through.
+        auto unitPtr = m_polyphony.acquire(kPreviewTrackId);
 
         // Check if the pool had an available object.
         if (unitPtr)
@@ -66,7 +160,8 @@ namespace dtracker::audio
             unitPtr->reinitialize(descriptor);
 
             // Add the ready-to-go unit to the mixer for playback.
-            m_engine->mixerUnit()->addUnit(std::move(unitPtr));
+            m_engine->mixerUnit()->addUnit(
+                std::make_shared<PooledVoiceUnit>(std::move(unitPtr)));
         }
     }
 
@@ -79,22 +174,14 @@ namespace dtracker::audio
         // Before we start, clear everything.
         stopPlayback();
 
-        // Create a new waveform queue for this track.
-        {
-            std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
-            // The queue needs a capacity. 2 seconds of audio data is very safe.
-            m_waveformQueues[trackId] = std::make_unique<
-                rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>>(64);
-        }
-
-        // Pass the raw pointers to the new resources to the builder.
-        auto trackPlayer = buildTrackPlayer(trackId, &m_bufferPool,
-                                            m_waveformQueues[trackId].get());
-
+        auto trackPlayer = buildSequencedTrack(trackId);
         if (!trackPlayer)
             return;
 
-        m_engine->mixerUnit()->addUnit(std::move(trackPlayer));
+        playback::GraphBuilder builder;
+        const auto master = builder.addBus();
+        addTrackPlayer(builder, master, trackId, std::move(trackPlayer));
+        startGraph(builder, master);
     }
 
     void dtracker::audio::PlaybackManager::playAllTracks()
@@ -109,17 +196,123 @@ namespace dtracker::audio
 
         std::vector<int> allTrackIds = m_trackManager->getAllTrackIds();
 
-        std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
+        // Every track feeds one master bus; the whole song is then compiled
+        // into a single flat process list.
+        playback::GraphBuilder builder;
+        const auto master = builder.addBus();
         for (int trackId : allTrackIds)
         {
-            m_waveformQueues[trackId] = std::make_unique<
-                rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>>(64);
-            if (auto trackPlayer = buildTrackPlayer(
-                    trackId, &m_bufferPool, m_waveformQueues[trackId].get()))
+            if (auto trackPlayer = buildSequencedTrack(trackId))
+            {
+                addTrackPlayer(builder, master, trackId,
+                               std::move(trackPlayer));
+            }
+        }
+        startGraph(builder, master);
+    }
+
+    void PlaybackManager::addTrackPlayer(
+        playback::GraphBuilder &builder, playback::GraphBuilder::NodeId bus,
+        int trackId, std::shared_ptr<playback::PlaybackUnit> player)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_trackPlayersMutex);
+            m_trackPlayers[trackId] = player;
+        }
+        builder.connect(builder.addSource(std::move(player)), bus);
+    }
+
+    // Compiling happens here, on the control thread, so the audio thread
+    // only ever runs the finished process list.
+    void PlaybackManager::startGraph(const playback::GraphBuilder &builder,
+                                     playback::GraphBuilder::NodeId output)
+    {
+        const auto &settings = m_engine->getSettings();
+        if (auto graph = builder.compile(output, settings.bufferFrames,
+                                         settings.outputChannels))
+        {
+            m_engine->mixerUnit()->addUnit(std::move(graph));
+        }
+    }
+
+    void PlaybackManager::setTrackVolume(int trackId, float volume)
+    {
+        setTrackParameter(trackId, playback::UnitParam::Volume, volume);
+    }
+
+    void PlaybackManager::setTrackPan(int trackId, float pan)
+    {
+        setTrackParameter(trackId, playback::UnitParam::Pan, pan);
+    }
+
+    // The change travels through the mixer's command queue, so the audio
+    // thread applies it between blocks.
+    void PlaybackManager::setTrackParameter(int trackId,
+                                            playback::UnitParam param,
+                                            float value)
+    {
+        if (!m_engine)
+            return;
+
+        std::shared_ptr<playback::PlaybackUnit> player;
+        {
+            std::lock_guard<std::mutex> lock(m_trackPlayersMutex);
+            if (auto it = m_trackPlayers.find(trackId);
+                it != m_trackPlayers.end())
             {
-                m_engine->mixerUnit()->addUnit(std::move(trackPlayer));
+                player = it->second.lock();
             }
         }
+
+        if (player)
+            m_engine->mixerUnit()->setUnitParameter(std::move(player), param,
+                                                    value);
+    }
+
+    bool PlaybackManager::renderAllTracks(render::IRenderSink &sink,
+                                          size_t maxFrames)
+    {
+        if (!m_engine || !m_trackManager || !m_sampleManager)
+            return false;
+
+        // The bounce gets its own voices and graph so it can run alongside
+        // live playback without competing for pooled units.
+        playback::UnitPool unitPool(128);
+        playback::PolyphonyManager polyphony(&unitPool, m_polyphony.maxVoices(),
+                                             m_polyphony.policy());
+        playback::GraphBuilder builder;
+        const auto master = builder.addBus();
+
+        for (int trackId : m_trackManager->getAllTrackIds())
+        {
+            // Same voice limits as live playback, and no waveform taps;
+            // nobody is watching an offline render. Nothing schedules ahead
+            // either, so each player schedules its notes as it renders.
+            polyphony.setTrackLimit(trackId, m_polyphony.trackLimit(trackId));
+            if (auto trackPlayer =
+                    buildTrackPlayer(trackId, &unitPool, &polyphony))
+            {
+                trackPlayer->setSelfScheduling(true);
+                builder.connect(builder.addSource(std::move(trackPlayer)),
+                                master);
+            }
+        }
+
+        const auto &settings = m_engine->getSettings();
+        auto graph = builder.compile(master, settings.bufferFrames,
+                                     settings.outputChannels);
+        if (!graph)
+            return false;
+
+        types::RenderContext context;
+        context.bpm = m_bpm.load(std::memory_order_relaxed);
+        context.isLooping = false;
+        context.sampleRate = settings.sampleRate;
+        context.resampleQuality = exportResampleQuality();
+
+        render::OfflineRenderer renderer(m_engine->getSettings());
+        auto result = renderer.render(*graph, sink, context, maxFrames);
+        return result.ok;
     }
 
     void dtracker::audio::PlaybackManager::setLoopPlayback(bool shouldLoop)
@@ -127,6 +320,7 @@ namespace dtracker::audio
         if (m_engine != nullptr)
         {
             m_engine->proxyUnit()->setIsLooping(shouldLoop);
+            m_sequencer->setLooping(shouldLoop);
         }
     }
 
@@ -139,29 +333,15 @@ namespace dtracker::audio
         return false;
     }
 
-    std::unique_ptr<playback::TrackPlaybackUnit>
-    dtracker::audio::PlaybackManager::buildTrackPlayer(
-        int trackId, playback::BufferPool *bufferPool,
-        rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr>
-            *waveformQueue)
+    playback::SampleBlueprint
+    PlaybackManager::buildBlueprint(const tracker::types::Track &track)
     {
-        // 1. Get the track's data from the TrackManager.
-        auto trackDataPtr = m_trackManager->getTrack(trackId);
-        if (!trackDataPtr)
-        {
-            return nullptr; // Return null if track doesn't exist
-        }
-
-        // 2. Create the top-level player for this track.
-        auto trackPlaybackUnit = std::make_unique<playback::TrackPlaybackUnit>(
-            bufferPool, waveformQueue);
-
-        trackPlaybackUnit->setVolume(trackDataPtr->volume);
-        trackPlaybackUnit->setPan(trackDataPtr->pan);
+        // The engine's rate may have changed since the last build.
+        m_sampleManager->setTargetSampleRate(
+            m_engine->getSettings().sampleRate);
 
-        // 3. Build the blueprint for all patterns in this track.
         playback::SampleBlueprint blueprint;
-        for (const auto &pattern : trackDataPtr->patterns)
+        for (const auto &pattern : track.patterns)
         {
             for (int sampleId : pattern.steps)
             {
@@ -175,17 +355,117 @@ namespace dtracker::audio
                 }
             }
         }
+        return blueprint;
+    }
+
+    // The track's patterns and blueprint move to a TrackSequencer; the
+    // player only consumes its notes.
+    std::unique_ptr<playback::SequencedTrackPlaybackUnit>
+    PlaybackManager::buildTrackPlayer(int trackId,
+                                      playback::UnitPool *unitPool,
+                                      playback::PolyphonyManager *polyphony)
+    {
+        auto trackDataPtr = m_trackManager->getTrack(trackId);
+        if (!trackDataPtr)
+            return nullptr;
+
+        auto sequence = std::make_shared<playback::TrackSequencer>(
+            trackDataPtr->patterns, buildBlueprint(*trackDataPtr), unitPool,
+            m_engine->getSettings().sampleRate);
+        sequence->setPolyphony(polyphony, trackId);
+
+        auto player = std::make_unique<playback::SequencedTrackPlaybackUnit>(
+            std::move(sequence));
+        player->setVolume(trackDataPtr->volume);
+        player->setPan(trackDataPtr->pan);
+        return player;
+    }
 
-        // 4. Create a playable unit for each pattern in the track's sequence.
-        for (const auto &pattern : trackDataPtr->patterns)
+    // Live, the lookahead thread fills the track's sequencer ahead of the
+    // audio thread.
+    std::unique_ptr<playback::SequencedTrackPlaybackUnit>
+    PlaybackManager::buildSequencedTrack(int trackId)
+    {
+        auto player = buildTrackPlayer(trackId, &m_unitPool, &m_polyphony);
+        if (!player)
+            return nullptr;
+
+        const auto &settings = m_engine->getSettings();
+        m_sequencer->setLookahead(kLookaheadBlocks * settings.bufferFrames,
+                                  settings.sampleRate);
+
+        lockSamples(player->sequencer()->blueprint());
+        m_sequencer->addTrack(player->sequencer());
+
+        player->setWaveformTap(createWaveformTap(trackId));
+        player->setSpectrumTap(createSpectrumTap(trackId));
+        player->setLevelMeter(createLevelMeter(trackId));
+        return player;
+    }
+
+    std::shared_ptr<playback::WaveformTap>
+    PlaybackManager::createWaveformTap(int trackId)
+    {
+        // Blocks cover as much time as the master tap's, whatever the
+        // decimation, so a scope refreshes tracks and master together.
+        const unsigned int decimation = waveformDecimation();
+        auto tap = std::make_shared<playback::WaveformTap>(
+            m_engine->getSettings().outputChannels,
+            std::max(playback::WaveformTap::kDefaultBlockFrames / decimation,
+                     1u),
+            playback::WaveformTap::kDefaultBlocks, decimation);
+
+        std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
+        m_waveformQueues[trackId] = tap;
+        return tap;
+    }
+
+    // The scope tap keeps only peaks, which would alias in a spectrum, so
+    // the analyzer gets its own tap at the full rate.
+    std::shared_ptr<playback::WaveformTap>
+    PlaybackManager::createSpectrumTap(int trackId)
+    {
+        auto tap = std::make_shared<playback::WaveformTap>(
+            m_engine->getSettings().outputChannels);
+        m_spectrumAnalyzer.attach(trackId, tap);
+        return tap;
+    }
+
+    std::shared_ptr<playback::LevelMeter>
+    PlaybackManager::createLevelMeter(int trackId)
+    {
+        auto meter = std::make_shared<playback::LevelMeter>(
+            m_engine->getSettings().sampleRate);
+
+        std::lock_guard<std::mutex> lock(m_levelMetersMutex);
+        m_levelMeters[trackId] = meter;
+        return meter;
+    }
+
+    // Tracks often share samples; each buffer is registered once.
+    void
+    PlaybackManager::lockSamples(const playback::SampleBlueprint &blueprint)
+    {
+        std::lock_guard<std::mutex> lock(m_lockedSamplesMutex);
+        for (const auto &[sampleId, descriptor] : blueprint)
         {
-            auto patternUnit = std::make_unique<playback::PatternPlaybackUnit>(
-                pattern, blueprint, &m_unitPool,
-                m_engine->getSettings().sampleRate);
-            trackPlaybackUnit->addUnit(std::move(patternUnit));
+            const auto &pcm = descriptor.pcmData();
+            if (!pcm || pcm->empty() ||
+                std::find(m_lockedSamples.begin(), m_lockedSamples.end(),
+                          pcm) != m_lockedSamples.end())
+                continue;
+
+            m_engine->lockMemory(pcm->data(), pcm->size() * sizeof(float));
+            m_lockedSamples.push_back(pcm);
         }
+    }
 
-        return trackPlaybackUnit;
+    void PlaybackManager::unlockSamples()
+    {
+        std::lock_guard<std::mutex> lock(m_lockedSamplesMutex);
+        for (const auto &pcm : m_lockedSamples)
+            m_engine->unlockMemory(pcm->data(), pcm->size() * sizeof(float));
+        m_lockedSamples.clear();
     }
 
     void PlaybackManager::setBpm(float bpm)
@@ -196,6 +476,7 @@ namespace dtracker::audio
 
             // Update the proxy so the audio thread sees the change.
             m_engine->proxyUnit()->setBpm(bpm);
+            m_sequencer->setBpm(bpm);
         }
     }
 
@@ -204,28 +485,95 @@ namespace dtracker::audio
         return m_bpm;
     }
 
-    rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr> *
+    void PlaybackManager::setResampleQuality(dsp::ResampleQuality quality)
+    {
+        if (m_engine)
+            m_engine->proxyUnit()->setResampleQuality(quality);
+    }
+
+    dsp::ResampleQuality PlaybackManager::resampleQuality() const
+    {
+        return m_engine ? m_engine->proxyUnit()->resampleQuality()
+                        : dsp::ResampleQuality::Cubic;
+    }
+
+    void
+    PlaybackManager::setExportResampleQuality(dsp::ResampleQuality quality)
+    {
+        m_exportResampleQuality.store(quality, std::memory_order_relaxed);
+    }
+
+    dsp::ResampleQuality PlaybackManager::exportResampleQuality() const
+    {
+        return m_exportResampleQuality.load(std::memory_order_relaxed);
+    }
+
+    playback::WaveformTap::Reader
     PlaybackManager::getWaveformQueueForTrack(int trackId)
     {
         std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
         if (auto it = m_waveformQueues.find(trackId);
             it != m_waveformQueues.end())
         {
-            return it->second.get();
+            return playback::WaveformTap::Reader(it->second);
         }
-        return nullptr;
+        return {};
+    }
+
+    std::uint64_t PlaybackManager::getWaveformDropCount(int trackId)
+    {
+        std::lock_guard<std::mutex> lock(m_waveformQueuesMutex);
+        if (auto it = m_waveformQueues.find(trackId);
+            it != m_waveformQueues.end())
+        {
+            return it->second->droppedBlocks();
+        }
+        return 0;
+    }
+
+    void PlaybackManager::setWaveformDecimation(unsigned int factor)
+    {
+        m_waveformDecimation.store(std::max(factor, 1u),
+                                   std::memory_order_relaxed);
+    }
+
+    unsigned int PlaybackManager::waveformDecimation() const
+    {
+        return m_waveformDecimation.load(std::memory_order_relaxed);
     }
 
-    rigtorp::SPSCQueue<playback::BufferPool::PooledBufferPtr> *
+    playback::WaveformTap::Reader
     dtracker::audio::PlaybackManager::getMasterWaveformQueue()
     {
-        std::lock_guard<std::mutex> lock(m_masterWaveFormQueueMutex);
-        return m_masterWaveFormQueue.get();
+        return playback::WaveformTap::Reader(m_masterWaveformTap);
+    }
+
+    playback::LevelReading PlaybackManager::getTrackLevels(int trackId)
+    {
+        std::lock_guard<std::mutex> lock(m_levelMetersMutex);
+        if (auto it = m_levelMeters.find(trackId); it != m_levelMeters.end())
+            return it->second->read();
+        return {};
+    }
+
+    playback::LevelReading PlaybackManager::getMasterLevels() const
+    {
+        return m_masterLevelMeter->read();
+    }
+
+    SpectrumFrame PlaybackManager::getTrackSpectrum(int trackId) const
+    {
+        return m_spectrumAnalyzer.spectrum(trackId);
+    }
+
+    SpectrumFrame PlaybackManager::getMasterSpectrum() const
+    {
+        return m_spectrumAnalyzer.spectrum(kMasterSpectrumId);
     }
 
-    playback::BufferPool *dtracker::audio::PlaybackManager::getBufferPool()
+    playback::PolyphonyManager &PlaybackManager::polyphony()
     {
-        return &m_bufferPool;
+        return m_polyphony;
     }
 
 } // namespace dtracker::audio
\ No newline at end of file
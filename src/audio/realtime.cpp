@@ -0,0 +1,95 @@
+#include <dtracker/audio/realtime.hpp>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||             \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define DTRACKER_HAS_MXCSR 1
+#endif
+
+namespace dtracker::audio::realtime
+{
+    bool flushDenormals()
+    {
+#if defined(DTRACKER_HAS_MXCSR)
+        // FTZ is bit 15 and DAZ is bit 6 of MXCSR.
+        _mm_setcsr(_mm_getcsr() | 0x8040);
+        return true;
+#elif defined(__aarch64__)
+        // FZ is bit 24 of FPCR; it covers both inputs and outputs.
+        std::uint64_t fpcr;
+        asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+        asm volatile("msr fpcr, %0" : : "r"(fpcr | (std::uint64_t{1} << 24)));
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // macOS only offers affinity hints, which do not pin anything.
+    bool pinToCore(int core)
+    {
+        if (core < 0)
+            return false;
+
+#if defined(_WIN32)
+        if (core >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+            return false;
+        return SetThreadAffinityMask(GetCurrentThread(),
+                                     DWORD_PTR{1} << core) != 0;
+#elif defined(__linux__)
+        if (core >= CPU_SETSIZE)
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+    bool raisePriority()
+    {
+#if defined(_WIN32)
+        return SetThreadPriority(GetCurrentThread(),
+                                 THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+        sched_param param{};
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+    }
+
+    bool lockMemory(const void *data, size_t bytes)
+    {
+        if (!data || bytes == 0)
+            return false;
+
+#if defined(_WIN32)
+        return VirtualLock(const_cast<void *>(data), bytes) != 0;
+#else
+        return mlock(data, bytes) == 0;
+#endif
+    }
+
+    void unlockMemory(const void *data, size_t bytes)
+    {
+        if (!data || bytes == 0)
+            return;
+
+#if defined(_WIN32)
+        VirtualUnlock(const_cast<void *>(data), bytes);
+#else
+        munlock(data, bytes);
+#endif
+    }
+} // namespace dtracker::audio::realtime
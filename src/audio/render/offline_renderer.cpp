@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/render/offline_renderer.hpp>
+#include <stdexcept>
+
+namespace dtracker::audio::render
+{
+    OfflineRenderer::OfflineRenderer(types::AudioSettings settings)
+        : m_settings(settings)
+    {
+        if (m_settings.bufferFrames == 0 || m_settings.outputChannels == 0)
+            throw std::invalid_argument(
+                "Offline render block size and channels must be non-zero.");
+
+        m_block.resize(static_cast<size_t>(m_settings.bufferFrames) *
+                       m_settings.outputChannels);
+        m_scratch.configure(m_settings.bufferFrames,
+                            m_settings.outputChannels);
+    }
+
+    // Pulls blocks from the graph back-to-back. There is no clock here; the
+    // loop runs as fast as the graph can render.
+    OfflineRenderResult OfflineRenderer::render(
+        playback::PlaybackUnit &root, IRenderSink &sink,
+        const types::RenderContext &context, size_t maxFrames)
+    {
+        OfflineRenderResult result;
+
+        if (!sink.open(m_settings.sampleRate, m_settings.outputChannels))
+            return result;
+
+        const unsigned int channels = m_settings.outputChannels;
+        bool sinkOk = true;
+
+        types::RenderContext blockContext = context;
+        if (!blockContext.scratch)
+            blockContext.scratch = &m_scratch;
+        if (!blockContext.sampleRate)
+            blockContext.sampleRate = m_settings.sampleRate;
+
+        while (!root.isFinished() && result.framesRendered < maxFrames)
+        {
+            const unsigned int nFrames = static_cast<unsigned int>(
+                std::min<size_t>(m_settings.bufferFrames,
+                                 maxFrames - result.framesRendered));
+
+            // Same contract as the device callback: start from silence.
+            dsp::clear(m_block.data(), m_block.size());
+            blockContext.frame = context.frame + result.framesRendered;
+            root.render(m_block.data(), nFrames, channels, blockContext);
+
+            if (!sink.write(m_block.data(), nFrames))
+            {
+                sinkOk = false;
+                break;
+            }
+            result.framesRendered += nFrames;
+        }
+
+        result.finished = root.isFinished();
+        result.ok = sink.close() && sinkOk;
+        return result;
+    }
+
+    const types::AudioSettings &OfflineRenderer::settings() const
+    {
+        return m_settings;
+    }
+} // namespace dtracker::audio::render
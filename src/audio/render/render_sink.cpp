@@ -0,0 +1,51 @@
+#include <dtracker/audio/render/render_sink.hpp>
+
+namespace dtracker::audio::render
+{
+    // Records the format and discards anything from a previous render.
+    bool MemoryRenderSink::open(unsigned int sampleRate, unsigned int channels)
+    {
+        if (sampleRate == 0 || channels == 0)
+            return false;
+
+        m_sampleRate = sampleRate;
+        m_channels = channels;
+        m_data.clear();
+        return true;
+    }
+
+    // Appends the block to the end of the buffer.
+    bool MemoryRenderSink::write(const float *buffer, unsigned int nFrames)
+    {
+        if (m_channels == 0)
+            return false;
+
+        m_data.insert(m_data.end(), buffer, buffer + nFrames * m_channels);
+        return true;
+    }
+
+    bool MemoryRenderSink::close()
+    {
+        return true;
+    }
+
+    const types::PCMData &MemoryRenderSink::data() const
+    {
+        return m_data;
+    }
+
+    size_t MemoryRenderSink::frames() const
+    {
+        return m_channels ? m_data.size() / m_channels : 0;
+    }
+
+    unsigned int MemoryRenderSink::sampleRate() const
+    {
+        return m_sampleRate;
+    }
+
+    unsigned int MemoryRenderSink::channels() const
+    {
+        return m_channels;
+    }
+} // namespace dtracker::audio::render
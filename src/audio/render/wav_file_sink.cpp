@@ -0,0 +1,194 @@
+#include <cstring>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <dtracker/audio/render/wav_file_sink.hpp>
+#include <iostream>
+
+namespace dtracker::audio::render
+{
+    namespace
+    {
+        // WAVE format tags from the RIFF specification.
+        constexpr std::uint16_t kFormatPcm = 1;
+        constexpr std::uint16_t kFormatIeeeFloat = 3;
+
+        // Size of the RIFF, fmt and data chunk headers for PCM. Float adds
+        // cbSize to the fmt chunk and a fact chunk, as the RIFF
+        // specification asks of every format other than PCM.
+        constexpr std::uint32_t kPcmHeaderSize = 44;
+        constexpr std::uint32_t kFloatHeaderSize = 58;
+
+        // Appends a value to the byte buffer in little-endian order.
+        template <typename T>
+        void putLittleEndian(std::vector<std::uint8_t> &out, T value)
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+                out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    } // namespace
+
+    WavFileSink::WavFileSink(std::string path, WavSampleFormat format)
+        : m_path(std::move(path)), m_format(format)
+    {
+    }
+
+    // Make sure a sink that goes out of scope still leaves a valid file.
+    WavFileSink::~WavFileSink()
+    {
+        if (m_file.is_open())
+            close();
+    }
+
+    // Creates the file and reserves space for the header.
+    bool WavFileSink::open(unsigned int sampleRate, unsigned int channels)
+    {
+        if (sampleRate == 0 || channels == 0)
+            return false;
+
+        m_file.open(m_path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            std::cerr << "WavFileSink: Failed to open " << m_path << "\n";
+            return false;
+        }
+
+        m_sampleRate = sampleRate;
+        m_channels = channels;
+        m_framesWritten = 0;
+
+        // The sizes are unknown until close(), so write placeholders now.
+        writeHeader();
+        return static_cast<bool>(m_file);
+    }
+
+    // Encodes the block in the target format and appends it to the file.
+    bool WavFileSink::write(const float *buffer, unsigned int nFrames)
+    {
+        if (!m_file.is_open())
+            return false;
+
+        // The RIFF sizes are 32-bit, so stop before they would wrap rather
+        // than leave a corrupt header.
+        const std::uint64_t dataSize =
+            (static_cast<std::uint64_t>(m_framesWritten) + nFrames) *
+            blockAlign();
+        if (dataSize > UINT32_MAX - (headerSize() - 8))
+        {
+            std::cerr << "WavFileSink: " << m_path
+                      << " would exceed the 4 GiB WAV size limit\n";
+            return false;
+        }
+
+        const size_t samples = static_cast<size_t>(nFrames) * m_channels;
+        m_encodeBuffer.clear();
+
+        if (m_format == WavSampleFormat::Float32)
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, &buffer[i], sizeof(bits));
+                putLittleEndian(m_encodeBuffer, bits);
+            }
+        }
+        else
+        {
+            // Clamp and convert in bulk, then lay the bytes out.
+            m_int16Buffer.resize(samples);
+            dsp::floatToInt16(m_int16Buffer.data(), buffer, samples);
+            for (std::int16_t value : m_int16Buffer)
+                putLittleEndian(m_encodeBuffer,
+                                static_cast<std::uint16_t>(value));
+        }
+
+        m_file.write(reinterpret_cast<const char *>(m_encodeBuffer.data()),
+                     static_cast<std::streamsize>(m_encodeBuffer.size()));
+        if (!m_file)
+            return false;
+
+        m_framesWritten += nFrames;
+        return true;
+    }
+
+    // Patches the header with the final sizes and closes the file.
+    bool WavFileSink::close()
+    {
+        if (!m_file.is_open())
+            return false;
+
+        m_file.seekp(0);
+        writeHeader();
+        const bool ok = static_cast<bool>(m_file);
+        m_file.close();
+        return ok;
+    }
+
+    size_t WavFileSink::frames() const
+    {
+        return m_framesWritten;
+    }
+
+    std::uint16_t WavFileSink::bitsPerSample() const
+    {
+        return m_format == WavSampleFormat::Float32 ? 32 : 16;
+    }
+
+    std::uint16_t WavFileSink::blockAlign() const
+    {
+        return static_cast<std::uint16_t>(m_channels * bitsPerSample() / 8);
+    }
+
+    std::uint32_t WavFileSink::headerSize() const
+    {
+        return m_format == WavSampleFormat::Float32 ? kFloatHeaderSize
+                                                    : kPcmHeaderSize;
+    }
+
+    // write() never lets the data outgrow the 32-bit sizes, so the casts
+    // here are exact.
+    void WavFileSink::writeHeader()
+    {
+        const bool isFloat = m_format == WavSampleFormat::Float32;
+        const std::uint16_t align = blockAlign();
+        const std::uint32_t dataSize =
+            static_cast<std::uint32_t>(m_framesWritten * align);
+
+        std::vector<std::uint8_t> header;
+        header.reserve(headerSize());
+
+        // RIFF chunk
+        header.insert(header.end(), {'R', 'I', 'F', 'F'});
+        putLittleEndian<std::uint32_t>(header, headerSize() - 8 + dataSize);
+        header.insert(header.end(), {'W', 'A', 'V', 'E'});
+
+        // fmt chunk
+        header.insert(header.end(), {'f', 'm', 't', ' '});
+        putLittleEndian<std::uint32_t>(header, isFloat ? 18 : 16);
+        putLittleEndian<std::uint16_t>(header,
+                                       isFloat ? kFormatIeeeFloat : kFormatPcm);
+        putLittleEndian<std::uint16_t>(header,
+                                       static_cast<std::uint16_t>(m_channels));
+        putLittleEndian<std::uint32_t>(header, m_sampleRate);
+        putLittleEndian<std::uint32_t>(header, m_sampleRate * align);
+        putLittleEndian<std::uint16_t>(header, align);
+        putLittleEndian<std::uint16_t>(header, bitsPerSample());
+
+        if (isFloat)
+        {
+            // No extra format bytes follow.
+            putLittleEndian<std::uint16_t>(header, 0);
+
+            // fact chunk, holding the length in frames.
+            header.insert(header.end(), {'f', 'a', 'c', 't'});
+            putLittleEndian<std::uint32_t>(header, 4);
+            putLittleEndian<std::uint32_t>(
+                header, static_cast<std::uint32_t>(m_framesWritten));
+        }
+
+        // data chunk
+        header.insert(header.end(), {'d', 'a', 't', 'a'});
+        putLittleEndian<std::uint32_t>(header, dataSize);
+
+        m_file.write(reinterpret_cast<const char *>(header.data()),
+                     static_cast<std::streamsize>(header.size()));
+    }
+} // namespace dtracker::audio::render
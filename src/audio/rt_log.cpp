@@ -0,0 +1,167 @@
+#include <dtracker/audio/rt_log.hpp>
+#include <iostream>
+
+namespace dtracker::audio
+{
+    namespace
+    {
+        const char *levelName(LogLevel level)
+        {
+            switch (level)
+            {
+            case LogLevel::Debug:
+                return "debug";
+            case LogLevel::Info:
+                return "info";
+            case LogLevel::Warning:
+                return "warning";
+            case LogLevel::Error:
+                return "error";
+            }
+            return "?";
+        }
+    } // namespace
+
+    RtLog::RtLog(size_t capacity) : m_queue(capacity) {}
+
+    RtLog::~RtLog()
+    {
+        stopFlusher();
+        flush(std::cout, std::cerr);
+    }
+
+    void RtLog::setLevel(LogLevel level)
+    {
+        m_level.store(level, std::memory_order_relaxed);
+    }
+
+    LogLevel RtLog::level() const
+    {
+        return m_level.load(std::memory_order_relaxed);
+    }
+
+    bool RtLog::push(LogRecord &record)
+    {
+        if (record.level < m_level.load(std::memory_order_relaxed))
+            return false;
+
+        if (m_queue.tryPush(record))
+            return true;
+
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Runs on the flusher (or a test thread), so formatting and stream
+    // locks are fine here.
+    size_t RtLog::flush(std::ostream &out, std::ostream &errors)
+    {
+        size_t count = 0;
+        LogRecord record;
+        while (m_queue.tryPop(record))
+        {
+            std::ostream &stream =
+                record.level >= LogLevel::Warning ? errors : out;
+            stream << format(record) << '\n';
+            ++count;
+        }
+
+        const size_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_reportedDrops)
+        {
+            errors << "RtLog: " << dropped - m_reportedDrops
+                   << " records dropped, ring full\n";
+            m_reportedDrops = dropped;
+        }
+        return count;
+    }
+
+    size_t RtLog::flush(std::ostream &out)
+    {
+        return flush(out, out);
+    }
+
+    void RtLog::startFlusher(std::chrono::milliseconds interval)
+    {
+        if (m_flusher.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_flusherMutex);
+            m_stopRequested = false;
+        }
+        m_flusher = std::thread(&RtLog::run, this, interval);
+    }
+
+    void RtLog::stopFlusher()
+    {
+        if (!m_flusher.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_flusherMutex);
+            m_stopRequested = true;
+        }
+        m_flusherWake.notify_one();
+        m_flusher.join();
+    }
+
+    size_t RtLog::droppedCount() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    // "Source [level @frame]: message", with each "{}" in the message
+    // replaced by the next argument. Arguments without a placeholder are
+    // appended.
+    std::string RtLog::format(const LogRecord &record)
+    {
+        std::string line = record.source ? record.source : "RtLog";
+        line += " [";
+        line += levelName(record.level);
+        line += " @";
+        line += std::to_string(record.frame);
+        line += "]: ";
+
+        size_t arg = 0;
+        const char *text = record.message ? record.message : "";
+        while (*text)
+        {
+            if (text[0] == '{' && text[1] == '}' && arg < record.argCount)
+            {
+                line += std::to_string(record.args[arg++]);
+                text += 2;
+            }
+            else
+            {
+                line += *text++;
+            }
+        }
+
+        for (; arg < record.argCount; ++arg)
+        {
+            line += ' ';
+            line += std::to_string(record.args[arg]);
+        }
+        return line;
+    }
+
+    // Polls the ring rather than being woken by the audio thread, so
+    // write() never has to touch a mutex or make a system call.
+    void RtLog::run(std::chrono::milliseconds interval)
+    {
+        std::unique_lock<std::mutex> lock(m_flusherMutex);
+        while (!m_stopRequested)
+        {
+            lock.unlock();
+            flush(std::cout, std::cerr);
+            lock.lock();
+
+            m_flusherWake.wait_for(lock, interval,
+                                   [this] { return m_stopRequested; });
+        }
+
+        lock.unlock();
+        flush(std::cout, std::cerr);
+    }
+} // namespace dtracker::audio
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/spectrum_analyzer.hpp>
+#include <stdexcept>
+
+namespace dtracker::audio
+{
+    namespace
+    {
+        // The smallest magnitude worth a level, well below kFloorDb.
+        constexpr float kSilence = 1e-7f;
+
+        float toDb(float magnitude)
+        {
+            return std::max(20.0f * std::log10(std::max(magnitude, kSilence)),
+                            SpectrumAnalyzer::kFloorDb);
+        }
+    } // namespace
+
+    SpectrumAnalyzer::SpectrumAnalyzer(unsigned int sampleRate,
+                                       size_t fftSize, size_t bands)
+        : m_sampleRate(std::max(sampleRate, 1u)), m_bandCount(bands),
+          m_hop(fftSize / 4), m_fft(fftSize)
+    {
+        if (bands == 0)
+            throw std::invalid_argument(
+                "SpectrumAnalyzer needs at least one band");
+
+        // A periodic Hann window, scaled so a full-scale sine centred on a
+        // bin reads 0 dB: the window sums to half its length, and the sine
+        // lands half in its positive and half in its negative frequency.
+        constexpr double kPi = 3.14159265358979323846;
+        m_window.resize(fftSize);
+        for (size_t i = 0; i < fftSize; ++i)
+        {
+            const double hann =
+                0.5 - 0.5 * std::cos(2.0 * kPi * i / fftSize);
+            m_window[i] = static_cast<float>(hann * 4.0 / fftSize);
+        }
+        m_windowed.resize(fftSize);
+        m_magnitudes.resize(m_fft.bins());
+    }
+
+    SpectrumAnalyzer::~SpectrumAnalyzer()
+    {
+        stop();
+    }
+
+    void SpectrumAnalyzer::attach(int sourceId,
+                                  std::shared_ptr<playback::WaveformTap> tap)
+    {
+        if (!tap)
+            return;
+
+        auto source = std::make_shared<Source>();
+        source->reader = playback::WaveformTap::Reader(std::move(tap));
+        layoutBands(*source);
+
+        std::lock_guard<std::mutex> lock(m_sourcesMutex);
+        m_sources[sourceId] = std::move(source);
+    }
+
+    void SpectrumAnalyzer::detach(int sourceId)
+    {
+        std::lock_guard<std::mutex> lock(m_sourcesMutex);
+        m_sources.erase(sourceId);
+    }
+
+    SpectrumFrame SpectrumAnalyzer::spectrum(int sourceId) const
+    {
+        std::shared_ptr<Source> source;
+        {
+            std::lock_guard<std::mutex> lock(m_sourcesMutex);
+            if (auto it = m_sources.find(sourceId); it != m_sources.end())
+                source = it->second;
+        }
+        if (!source)
+            return {};
+
+        std::lock_guard<std::mutex> lock(source->frameMutex);
+        return source->frame;
+    }
+
+    // The bands span kMinFrequency to the tap's Nyquist frequency. Each
+    // takes the FFT bins centred inside it; a band too narrow to hold one
+    // takes the bin nearest its centre, so low bands can repeat a bin.
+    void SpectrumAnalyzer::layoutBands(Source &source) const
+    {
+        const unsigned int decimation = source.reader.tap()->decimation();
+        const float rate = static_cast<float>(m_sampleRate) /
+                           static_cast<float>(decimation);
+        const float binWidth = rate / static_cast<float>(m_fft.size());
+        const float maxFrequency = rate / 2.0f;
+        float minFrequency = std::max(kMinFrequency, binWidth);
+        if (minFrequency >= maxFrequency)
+            minFrequency = binWidth;
+
+        const size_t lastBin = m_fft.bins() - 1;
+        const float ratio = maxFrequency / minFrequency;
+        source.bandBins.resize(m_bandCount);
+        for (size_t band = 0; band < m_bandCount; ++band)
+        {
+            const float low = minFrequency *
+                              std::pow(ratio, static_cast<float>(band) /
+                                                  m_bandCount);
+            const float high = minFrequency *
+                               std::pow(ratio, static_cast<float>(band + 1) /
+                                                   m_bandCount);
+
+            size_t first = static_cast<size_t>(std::ceil(low / binWidth));
+            size_t last = band + 1 == m_bandCount
+                              ? lastBin
+                              : static_cast<size_t>(
+                                    std::ceil(high / binWidth)) - 1;
+            if (last < first || first > lastBin)
+            {
+                first = static_cast<size_t>(
+                    std::lround(std::sqrt(low * high) / binWidth));
+                last = first;
+            }
+            source.bandBins[band] = {std::min(first, lastBin),
+                                     std::min(last, lastBin)};
+        }
+
+        source.levels.assign(m_bandCount, kFloorDb);
+        source.fallPerWindow =
+            kFallDbPerSecond * static_cast<float>(m_hop) / rate;
+        source.frame.minFrequency = minFrequency;
+        source.frame.maxFrequency = maxFrequency;
+    }
+
+    size_t SpectrumAnalyzer::analyze()
+    {
+        std::vector<std::shared_ptr<Source>> sources;
+        {
+            std::lock_guard<std::mutex> lock(m_sourcesMutex);
+            sources.reserve(m_sources.size());
+            for (const auto &[id, source] : m_sources)
+                sources.push_back(source);
+        }
+
+        size_t windows = 0;
+        for (const auto &source : sources)
+            windows += analyzeSource(*source);
+        return windows;
+    }
+
+    size_t SpectrumAnalyzer::analyzeSource(Source &source)
+    {
+        const unsigned int channels = source.reader.tap()->channels();
+        while (source.reader.read(m_block))
+        {
+            // A window across a gap would show a click that never played.
+            if (source.reader.skippedBlocks() != source.skipped)
+            {
+                source.pending.clear();
+                source.skipped = source.reader.skippedBlocks();
+            }
+
+            const float scale = 1.0f / static_cast<float>(channels);
+            for (size_t i = 0; i < m_block.size(); i += channels)
+            {
+                float sum = 0.0f;
+                for (unsigned int ch = 0; ch < channels; ++ch)
+                    sum += m_block[i + ch];
+                source.pending.push_back(sum * scale);
+            }
+        }
+
+        const size_t fftSize = m_fft.size();
+        size_t windows = 0;
+        size_t offset = 0;
+        while (source.pending.size() - offset >= fftSize)
+        {
+            const float *input = source.pending.data() + offset;
+            for (size_t i = 0; i < fftSize; ++i)
+                m_windowed[i] = input[i] * m_window[i];
+            m_fft.magnitudes(m_windowed.data(), m_magnitudes.data());
+
+            for (size_t band = 0; band < m_bandCount; ++band)
+            {
+                const auto [first, last] = source.bandBins[band];
+                const float peak =
+                    *std::max_element(m_magnitudes.begin() + first,
+                                      m_magnitudes.begin() + last + 1);
+                float &level = source.levels[band];
+                level = std::max(toDb(peak), level - source.fallPerWindow);
+            }
+
+            offset += m_hop;
+            ++windows;
+        }
+        source.pending.erase(source.pending.begin(),
+                             source.pending.begin() + offset);
+
+        if (windows > 0)
+        {
+            std::lock_guard<std::mutex> lock(source.frameMutex);
+            source.frame.bands = source.levels;
+            source.frame.frames += windows;
+        }
+        return windows;
+    }
+
+    void SpectrumAnalyzer::start(std::chrono::milliseconds interval)
+    {
+        if (m_worker.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            m_stopRequested = false;
+        }
+        m_worker = std::thread(&SpectrumAnalyzer::run, this, interval);
+    }
+
+    void SpectrumAnalyzer::stop()
+    {
+        if (!m_worker.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            m_stopRequested = true;
+        }
+        m_workerWake.notify_one();
+        m_worker.join();
+    }
+
+    // Polls the taps rather than being woken by the audio thread, which
+    // must not touch a mutex to publish a block.
+    void SpectrumAnalyzer::run(std::chrono::milliseconds interval)
+    {
+        std::unique_lock<std::mutex> lock(m_workerMutex);
+        while (!m_stopRequested)
+        {
+            lock.unlock();
+            analyze();
+            lock.lock();
+
+            m_workerWake.wait_for(lock, interval,
+                                  [this] { return m_stopRequested; });
+        }
+    }
+} // namespace dtracker::audio
@@ -16,6 +16,7 @@ namespace dtracker::sample
         {
             // Update existing entry
             it->second.data = std::move(data);
+            it->second.variants.clear();
 
             // Move to the front of the usage list to mark as most recently
             // used.
@@ -30,7 +31,8 @@ namespace dtracker::sample
             m_cache[key] = {
                 std::move(data), properties,
                 m_useOrder
-                    .begin() // Iterator points to the front of the LRU list.
+                    .begin(), // Iterator points to the front of the LRU list.
+                {}            // No converted copies yet.
             };
         }
 
@@ -58,6 +60,57 @@ namespace dtracker::sample
         return nullptr;
     }
 
+    bool Cache::insertVariant(
+        const std::string &key, unsigned int sampleRate,
+        std::shared_ptr<const audio::types::PCMData> data,
+        const std::shared_ptr<const audio::types::PCMData> &source)
+    {
+        std::unique_lock lock(m_mutex);
+
+        auto it = m_cache.find(key);
+        if (it == m_cache.end() || it->second.data != source)
+            return false;
+
+        it->second.variants[sampleRate] = std::move(data);
+        return true;
+    }
+
+    std::shared_ptr<const audio::types::PCMData>
+    Cache::getVariant(const std::string &key, unsigned int sampleRate)
+    {
+        // Acquire a unique lock because we are modifying the LRU list.
+        std::unique_lock lock(m_mutex);
+
+        auto it = m_cache.find(key);
+        if (it == m_cache.end())
+            return nullptr;
+
+        auto variant = it->second.variants.find(sampleRate);
+        if (variant == it->second.variants.end())
+            return nullptr;
+
+        m_useOrder.erase(it->second.useIt);
+        m_useOrder.push_front(key);
+        it->second.useIt = m_useOrder.begin();
+        return variant->second;
+    }
+
+    void Cache::retainVariants(unsigned int sampleRate)
+    {
+        std::unique_lock lock(m_mutex);
+        for (auto &[key, entry] : m_cache)
+        {
+            for (auto it = entry.variants.begin();
+                 it != entry.variants.end();)
+            {
+                if (it->first != sampleRate)
+                    it = entry.variants.erase(it);
+                else
+                    ++it;
+            }
+        }
+    }
+
     bool Cache::erase(const std::string &key)
     {
         std::unique_lock lock(m_mutex);
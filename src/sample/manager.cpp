@@ -1,7 +1,20 @@
+#include <cmath>
+#include <dtracker/audio/dsp/resampler.hpp>
 #include <dtracker/sample/manager.hpp>
 
 namespace dtracker::sample
 {
+    Manager::~Manager()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_conversionMutex);
+            m_stopRequested = true;
+        }
+        m_conversionWake.notify_one();
+        if (m_converter.joinable())
+            m_converter.join();
+    }
+
     // Caches the sample data and then retrieves it to update its LRU status.
     std::shared_ptr<const audio::types::PCMData>
     Manager::cacheSample(const std::string &sampleLoc,
@@ -10,8 +23,11 @@ namespace dtracker::sample
     {
         // Insert (or update) the sample in the cache, moving the data
         // efficiently.
+        auto source = pcmData;
         m_cache.insert(sampleLoc, std::move(pcmData),
                        {metaData.sourceSampleRate, metaData.bitDepth, 2});
+        queueConversion(sampleLoc, std::move(source),
+                        metaData.sourceSampleRate);
 
         // Get the sample to mark it as most recently used.
         return m_cache.get(sampleLoc);
@@ -24,8 +40,11 @@ namespace dtracker::sample
                            const types::SampleMetadata &metaData)
     {
         // The cache has its own internal locking, so this call is thread-safe.
+        auto source = pcmData;
         m_cache.insert(sampleLoc, std::move(pcmData),
                        {metaData.sourceSampleRate, metaData.bitDepth, 2});
+        queueConversion(sampleLoc, std::move(source),
+                        metaData.sourceSampleRate);
 
         // Lock the registry to safely generate an ID and add the new entry.
         std::unique_lock lock(m_registryMutex);
@@ -58,7 +77,9 @@ namespace dtracker::sample
         return id;
     }
 
-    // Constructs a full SampleDescriptor from a registered ID.
+    // Constructs a full SampleDescriptor from a registered ID. A sample
+    // already converted to the target rate is handed out as its converted
+    // copy; one that is not yet is queued and handed out as it is.
     std::optional<types::SampleDescriptor> Manager::getSample(int id)
     {
         // Use a read-lock, allowing multiple threads to get samples
@@ -69,10 +90,26 @@ namespace dtracker::sample
         if (it != m_sampleRegistry.end())
         {
             const auto &entry = it->second;
+            const unsigned int targetRate = targetSampleRate();
+            if (targetRate != 0 && entry.metaData.sourceSampleRate != 0 &&
+                entry.metaData.sourceSampleRate != targetRate)
+            {
+                if (auto variant =
+                        m_cache.getVariant(entry.registryKey, targetRate))
+                {
+                    types::SampleMetadata converted = entry.metaData;
+                    converted.sourceSampleRate = targetRate;
+                    return types::SampleDescriptor{entry.id, std::move(variant),
+                                                   converted};
+                }
+            }
+
             // Get from cache, which updates the LRU order.
             auto pcm = m_cache.get(entry.registryKey);
             if (pcm)
             {
+                queueConversion(entry.registryKey, pcm,
+                                entry.metaData.sourceSampleRate);
                 // Move the retrieved shared_ptr for efficiency.
                 return types::SampleDescriptor{entry.id, std::move(pcm),
                                                entry.metaData};
@@ -125,4 +162,106 @@ namespace dtracker::sample
         // The cache has its own internal locking.
         return m_cache.contains(path);
     }
-} // namespace dtracker::sample
\ No newline at end of file
+
+    // Copies converted for an earlier rate are never handed out again, so
+    // they are dropped rather than left holding memory.
+    void Manager::setTargetSampleRate(unsigned int sampleRate)
+    {
+        m_targetSampleRate.store(sampleRate, std::memory_order_seq_cst);
+        m_cache.retainVariants(sampleRate);
+    }
+
+    unsigned int Manager::targetSampleRate() const
+    {
+        return m_targetSampleRate.load(std::memory_order_seq_cst);
+    }
+
+    void Manager::waitForConversions()
+    {
+        std::unique_lock lock(m_conversionMutex);
+        m_conversionDone.wait(lock,
+                              [this] { return m_pendingConversions.empty(); });
+    }
+
+    // The thread is started on first use, so a manager that never converts
+    // never has one.
+    void Manager::queueConversion(
+        const std::string &key,
+        std::shared_ptr<const audio::types::PCMData> source,
+        unsigned int sourceRate)
+    {
+        const unsigned int targetRate = targetSampleRate();
+        if (!source || targetRate == 0 || sourceRate == 0 ||
+            sourceRate == targetRate)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_conversionMutex);
+            if (m_stopRequested ||
+                !m_pendingConversions.emplace(key, targetRate).second)
+                return;
+
+            m_conversions.push_back(
+                {key, std::move(source), sourceRate, targetRate});
+            if (!m_converter.joinable())
+                m_converter = std::thread(&Manager::runConversions, this);
+        }
+        m_conversionWake.notify_one();
+    }
+
+    // Converts one sample at a time without holding the lock, so loading
+    // and playback carry on while it works.
+    void Manager::runConversions()
+    {
+        std::unique_lock lock(m_conversionMutex);
+        for (;;)
+        {
+            m_conversionWake.wait(lock, [this]
+                                  { return m_stopRequested ||
+                                           !m_conversions.empty(); });
+            if (m_stopRequested)
+                return;
+
+            ConversionJob job = std::move(m_conversions.front());
+            m_conversions.pop_front();
+            lock.unlock();
+
+            // A sample replaced or evicted meanwhile is not stored, and
+            // neither is a copy for a rate that stopped being the target. A
+            // change after the store is pruned by setTargetSampleRate(); one
+            // before it is caught by the second check.
+            if (job.targetRate == targetSampleRate() &&
+                m_cache.insertVariant(
+                    job.key, job.targetRate,
+                    convert(*job.source, job.sourceRate, job.targetRate),
+                    job.source) &&
+                job.targetRate != targetSampleRate())
+                m_cache.retainVariants(targetSampleRate());
+
+            lock.lock();
+            m_pendingConversions.erase({job.key, job.targetRate});
+            if (m_pendingConversions.empty())
+                m_conversionDone.notify_all();
+        }
+    }
+
+    // Nobody is waiting on a block here, so the sinc filter is always used.
+    std::shared_ptr<const audio::types::PCMData>
+    Manager::convert(const audio::types::PCMData &source,
+                     unsigned int sourceRate, unsigned int targetRate)
+    {
+        const size_t sourceFrames = source.size() / 2;
+        const double step = static_cast<double>(sourceRate) / targetRate;
+        const auto frames = static_cast<size_t>(
+            std::ceil(static_cast<double>(sourceFrames) / step));
+
+        audio::types::PCMData converted(frames * 2, 0.0f);
+        double position = 0.0;
+        const size_t written = audio::dsp::resampleStereo(
+            converted.data(), frames, source.data(), sourceFrames, position,
+            step, 1.0f, 1.0f, audio::dsp::ResampleQuality::Sinc);
+        converted.resize(written * 2);
+        return std::make_shared<const audio::types::PCMData>(
+            std::move(converted));
+    }
+} // namespace dtracker::sample
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
+#include "mocks/mock_playback_unit.hpp"
 #include <chrono>
+#include <dtracker/audio/backend/null_audio_backend.hpp>
 #include <dtracker/audio/device_manager.hpp>
 #include <dtracker/audio/engine.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
 #include <thread>
 
 // This test suite is for integration tests that use an Engine instance.
@@ -59,4 +62,145 @@ TEST(EngineIntegration, FailsToStartWithInvalidDevice)
     // The engine should fail to start and return false.
     EXPECT_FALSE(success);
     EXPECT_FALSE(engine.isStreamRunning());
-}
\ No newline at end of file
+}
+// The null backend runs the real callback path without any audio hardware.
+TEST(EngineIntegration, NullBackendDrivesCallbacksWithoutDevice)
+{
+    auto backend = std::make_unique<dtracker::audio::backend::NullAudioBackend>(
+        dtracker::audio::backend::NullAudioBackend::Mode::FreeRun);
+    auto *nullBackend = backend.get();
+
+    // Capture the output so we can check the graph was rendered.
+    dtracker::audio::render::MemoryRenderSink sink;
+    nullBackend->setBlockFrames(128);
+    nullBackend->setBlockLimit(8);
+    nullBackend->setSink(&sink);
+
+    dtracker::audio::Engine engine(std::move(backend));
+    auto mock = std::make_shared<MockPlaybackUnit>();
+    mock->fillValue = 0.5f;
+    engine.mixerUnit()->addUnit(mock);
+
+    // The driver has no devices to offer, and querying them is safe.
+    EXPECT_FALSE(engine.createDeviceManager().currentDeviceInfo().has_value());
+
+    // No output device is needed.
+    ASSERT_TRUE(engine.start());
+
+    // The driver stops by itself after the block limit.
+    while (engine.isStreamRunning())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    engine.stop();
+
+    EXPECT_EQ(engine.getSettings().bufferFrames, 128u);
+    EXPECT_EQ(nullBackend->blocksProcessed(), 8u);
+    // Each 128-frame buffer is rendered as two 64-frame quanta.
+    EXPECT_EQ(mock->renderCallCount, 16);
+
+    // Every callback was timed, and the mock was seen in the mix.
+    const auto performance = engine.performanceSnapshot();
+    EXPECT_EQ(performance.callbacks, 8u);
+    EXPECT_EQ(performance.xruns, 0u);
+    EXPECT_EQ(performance.activeUnits, 1u);
+    ASSERT_EQ(sink.frames(), 8u * 128u);
+    for (float sample : sink.data())
+        EXPECT_FLOAT_EQ(sample, 0.5f);
+}
+
+// Verifies that the graph is rendered in whole quanta on quantum boundaries,
+// even when the device buffer is not a multiple of the quantum.
+TEST(EngineIntegration, RendersInFixedQuantaAtAnyBufferSize)
+{
+    auto backend = std::make_unique<dtracker::audio::backend::NullAudioBackend>(
+        dtracker::audio::backend::NullAudioBackend::Mode::FreeRun);
+    auto *nullBackend = backend.get();
+
+    dtracker::audio::render::MemoryRenderSink sink;
+    nullBackend->setBlockFrames(100);
+    nullBackend->setBlockLimit(8);
+    nullBackend->setSink(&sink);
+
+    dtracker::audio::Engine engine(std::move(backend));
+    EXPECT_FALSE(engine.setProcessingQuantum(48));
+    ASSERT_TRUE(engine.setProcessingQuantum(64));
+
+    auto mock = std::make_shared<MockPlaybackUnit>();
+    mock->fillValue = 0.5f;
+    engine.mixerUnit()->addUnit(mock);
+
+    ASSERT_TRUE(engine.start());
+    while (engine.isStreamRunning())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    engine.stop();
+
+    // 800 frames need 13 quanta; the last is half carried over.
+    ASSERT_EQ(mock->renderCallCount, 13);
+    for (size_t i = 0; i < mock->renderedFrames.size(); ++i)
+    {
+        EXPECT_EQ(mock->renderedFrames[i], 64u);
+        EXPECT_EQ(mock->renderedAt[i], i * 64u);
+    }
+
+    // The carried frames play seamlessly at the start of the next buffer.
+    ASSERT_EQ(sink.frames(), 800u);
+    for (float sample : sink.data())
+        EXPECT_FLOAT_EQ(sample, 0.5f);
+}
+
+// Verifies that the realtime options are applied by the first callback and
+// that registered memory is locked when the stream opens, as far as the
+// machine allows.
+TEST(EngineIntegration, AppliesRealtimeOptionsOnFirstCallback)
+{
+    auto backend = std::make_unique<dtracker::audio::backend::NullAudioBackend>(
+        dtracker::audio::backend::NullAudioBackend::Mode::FreeRun);
+    backend->setBlockLimit(4);
+
+    dtracker::audio::Engine engine(std::move(backend));
+    dtracker::audio::realtime::Options options;
+    options.enabled = true;
+    options.raisePriority = false; // Leave the test machine's scheduler be
+    engine.setRealtimeOptions(options);
+
+    std::vector<float> pool(1024, 0.0f);
+    EXPECT_FALSE(engine.lockMemory(pool.data(), pool.size() * sizeof(float)));
+    EXPECT_FALSE(engine.realtimeReport().applied);
+
+    ASSERT_TRUE(engine.start());
+    while (engine.isStreamRunning())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    const auto report = engine.realtimeReport();
+    EXPECT_TRUE(report.applied);
+    EXPECT_FALSE(report.pinned);
+    EXPECT_FALSE(report.priorityRaised);
+    if (report.memoryLocked)
+    {
+        EXPECT_EQ(report.lockedBytes, pool.size() * sizeof(float));
+    }
+
+    engine.unlockMemory(pool.data(), pool.size() * sizeof(float));
+    EXPECT_EQ(engine.realtimeReport().lockedBytes, 0u);
+    engine.stop();
+}
+
+// In realtime mode the driver paces callbacks like a sound card would.
+TEST(EngineIntegration, NullBackendPacesRealtimeCallbacks)
+{
+    auto backend = std::make_unique<dtracker::audio::backend::NullAudioBackend>(
+        dtracker::audio::backend::NullAudioBackend::Mode::Realtime);
+    auto *nullBackend = backend.get();
+    nullBackend->setBlockFrames(441); // 10 ms at 44.1 kHz
+
+    dtracker::audio::Engine engine(std::move(backend));
+    ASSERT_TRUE(engine.start());
+    EXPECT_TRUE(engine.isStreamRunning());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    engine.stop();
+    EXPECT_FALSE(engine.isStreamRunning());
+
+    // Roughly ten blocks; allow generous slack for a loaded CI machine.
+    EXPECT_GE(nullBackend->blocksProcessed(), 5u);
+    EXPECT_LE(nullBackend->blocksProcessed(), 15u);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/playback/pattern_playback_unit.hpp>
+#include <memory>
+#include <vector>
+
+// A 10-frame click on sample ID 1, at a rate where one step is exactly 100
+// frames at 60 BPM (4 steps per beat).
+constexpr unsigned int kClickRate = 400;
+
+inline dtracker::audio::playback::SampleBlueprint clickBlueprint()
+{
+    dtracker::audio::playback::SampleBlueprint blueprint;
+    blueprint[1] = dtracker::sample::types::SampleDescriptor(
+        1,
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            dtracker::audio::types::PCMData(20, 1.0f)),
+        {kClickRate, 16});
+    return blueprint;
+}
+
+// Checks that a click starts exactly on 'frame' of the interleaved stereo
+// 'out': silent just before, full scale for its 10 frames, silent after.
+inline void expectClickAt(const std::vector<float> &out, unsigned int frame)
+{
+    SCOPED_TRACE(frame);
+    if (frame > 0)
+    {
+        EXPECT_FLOAT_EQ(out[(frame - 1) * 2], 0.0f);
+    }
+    EXPECT_FLOAT_EQ(out[frame * 2], 1.0f);
+    EXPECT_FLOAT_EQ(out[(frame + 9) * 2], 1.0f);
+    EXPECT_FLOAT_EQ(out[(frame + 10) * 2], 0.0f);
+}
@@ -52,7 +52,7 @@ class MockEngine : public dtracker::audio::IEngine
 
     const dtracker::audio::types::AudioSettings &getSettings() const override
     {
-        return dtracker::audio::types::AudioSettings{};
+        return m_settings;
     }
 
     dtracker::audio::playback::ProxyPlaybackUnit *proxyUnit() override
@@ -60,7 +60,39 @@ class MockEngine : public dtracker::audio::IEngine
         return nullptr;
     }
 
+    // The clock stands still; tests advance it through getMockTransport().
+    const dtracker::audio::playback::Transport &transport() const override
+    {
+        return m_transport;
+    }
+
+    dtracker::audio::playback::Transport &getMockTransport()
+    {
+        return m_transport;
+    }
+
+    // Nothing is ever locked in tests.
+    bool lockMemory(const void * /*data*/, size_t /*bytes*/) override
+    {
+        return false;
+    }
+
+    void unlockMemory(const void * /*data*/, size_t /*bytes*/) override {}
+
+    // Nothing is deferred; released objects are destroyed in place.
+    dtracker::audio::playback::ReclaimQueue *reclaimQueue() const override
+    {
+        return nullptr;
+    }
+
+    dtracker::audio::PerformanceSnapshot performanceSnapshot() const override
+    {
+        return {};
+    }
+
   private:
     std::unique_ptr<MockMixerPlaybackUnit> m_mockMixer;
+    dtracker::audio::playback::Transport m_transport;
+    dtracker::audio::types::AudioSettings m_settings;
     bool m_streamIsRunning = false;
 };
\ No newline at end of file
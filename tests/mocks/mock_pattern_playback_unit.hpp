@@ -45,6 +45,21 @@ class MockPatternPlaybackUnit
         isFinished_flag = true;
     }
 
+    void renderAdd(float *buffer, unsigned int nFrames, unsigned int channels,
+                   const dtracker::audio::types::RenderContext &context,
+                   float gainLeft, float gainRight) override
+    {
+        renderCallCount++;
+
+        for (unsigned int i = 0; i < nFrames; ++i)
+        {
+            buffer[i * 2] += leftValue * gainLeft;
+            buffer[i * 2 + 1] += rightValue * gainRight;
+        }
+
+        isFinished_flag = true;
+    }
+
     void reset() override
     {
         // Record that reset() was called.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <dtracker/audio/playback/playback_unit.hpp>
 #include <dtracker/audio/types.hpp>
 #include <vector>
@@ -12,10 +13,16 @@ class MockPlaybackUnit : public dtracker::audio::playback::PlaybackUnit
     float fillValue = 0.0f;
     bool finishedAfterRender = false;
 
+    // The size and transport frame of every block rendered.
+    std::vector<unsigned int> renderedFrames;
+    std::vector<std::uint64_t> renderedAt;
+
     void render(float *buffer, unsigned int frames, unsigned int channels,
                 const dtracker::audio::types::RenderContext &context) override
     {
         renderCallCount++;
+        renderedFrames.push_back(frames);
+        renderedAt.push_back(context.frame);
         std::fill(buffer, buffer + frames * channels, fillValue);
         hasRendered = true;
     }
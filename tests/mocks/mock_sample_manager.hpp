@@ -75,6 +75,14 @@ class MockSampleManager : public dtracker::sample::IManager
         return std::nullopt;
     }
 
+    void setTargetSampleRate(unsigned int sampleRate) override
+    {
+        targetSampleRate = sampleRate;
+    }
+
+    // The last rate passed to setTargetSampleRate().
+    unsigned int targetSampleRate = 0;
+
   private:
     // The mock's internal "database" of samples.
     std::unordered_map<int, dtracker::sample::types::SampleDescriptor>
@@ -12,9 +12,9 @@
 class MockUnitPool : public dtracker::audio::playback::UnitPool
 {
   public:
-    // We call the base constructor with a dummy size of 1.
-    // It doesn't matter, because we will override its acquire() method.
-    MockUnitPool() : dtracker::audio::playback::UnitPool(1) {}
+    // The base pool only supplies the units handed out by queueUnit(), so a
+    // handful is enough.
+    MockUnitPool() : dtracker::audio::playback::UnitPool(8) {}
 
     int acquireCallCount = 0;
 
@@ -40,10 +40,12 @@ class MockUnitPool : public dtracker::audio::playback::UnitPool
     }
 
     // This is a helper method for our tests to queue up a unit that
-    // the mock should return when acquire() is called.
-    void queueUnit(dtracker::audio::playback::UnitPool::PooledUnitPtr unit)
+    // the mock should return when acquire() is called. Units are taken from
+    // the base pool, since handles can only come from a pool.
+    void queueUnit()
     {
-        m_unitsToReturn.push_back(std::move(unit));
+        m_unitsToReturn.push_back(
+            dtracker::audio::playback::UnitPool::acquire());
     }
 
   private:
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include "mocks/mock_stereo_unit.hpp"
+#include <dtracker/audio/playback/graph_builder.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+#include <memory>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    std::shared_ptr<MockStereoUnit> makeUnit(float left, float right)
+    {
+        auto unit = std::make_shared<MockStereoUnit>();
+        unit->leftValue = left;
+        unit->rightValue = right;
+        return unit;
+    }
+} // namespace
+
+// Verifies that sources and nested buses are summed with their gains.
+TEST(CompiledGraph, MixesSourcesThroughNestedBuses)
+{
+    GraphBuilder builder;
+    const auto master = builder.addBus();
+    const auto group = builder.addBus(0.5f);
+    ASSERT_TRUE(builder.connect(builder.addSource(makeUnit(1.0f, 1.0f)),
+                                group));
+    ASSERT_TRUE(builder.connect(builder.addSource(makeUnit(0.5f, 0.25f)),
+                                group));
+    ASSERT_TRUE(builder.connect(builder.addSource(makeUnit(0.1f, 0.2f)),
+                                master));
+    ASSERT_TRUE(builder.connect(group, master));
+
+    auto graph = builder.compile(master, 64, 2);
+    ASSERT_NE(graph, nullptr);
+
+    std::vector<float> buffer(32 * 2, 9.0f);
+    graph->render(buffer.data(), 32, 2, types::RenderContext{});
+
+    EXPECT_FLOAT_EQ(buffer[0], 0.1f + 0.5f * 1.5f);
+    EXPECT_FLOAT_EQ(buffer[1], 0.2f + 0.5f * 1.25f);
+    EXPECT_FLOAT_EQ(buffer[62], buffer[0]);
+}
+
+// Verifies that slots are reused once a bus has been consumed, so a long
+// chain of buses needs only two buffers.
+TEST(CompiledGraph, ReusesSlotsAlongAChain)
+{
+    GraphBuilder builder;
+    auto previous = builder.addBus();
+    builder.connect(builder.addSource(makeUnit(0.5f, 0.5f)), previous);
+    for (int i = 0; i < 6; ++i)
+    {
+        const auto bus = builder.addBus();
+        ASSERT_TRUE(builder.connect(previous, bus));
+        previous = bus;
+    }
+
+    auto graph = builder.compile(previous, 16, 2);
+    ASSERT_NE(graph, nullptr);
+    EXPECT_EQ(graph->slotCount(), 2u);
+
+    std::vector<float> buffer(16 * 2);
+    graph->render(buffer.data(), 16, 2, types::RenderContext{});
+    EXPECT_FLOAT_EQ(buffer[0], 0.5f);
+}
+
+// Verifies that the process list runs every bus after all of its inputs,
+// whatever order the nodes were added in.
+TEST(CompiledGraph, OrdersBusesAfterTheirInputs)
+{
+    GraphBuilder builder;
+    const auto master = builder.addBus();
+    const auto late = builder.addBus();
+    const auto early = builder.addBus();
+    builder.connect(early, late);
+    builder.connect(late, master);
+    builder.connect(builder.addSource(makeUnit(1.0f, 1.0f)), early);
+
+    auto graph = builder.compile(master, 16, 2);
+    ASSERT_NE(graph, nullptr);
+
+    // early: clear, render; late: clear, mix early; master: clear, mix
+    // late; then the final mix into the caller's buffer.
+    const auto &steps = graph->steps();
+    ASSERT_EQ(steps.size(), 7u);
+    EXPECT_EQ(steps[1].op, GraphStep::Op::RenderSources);
+    EXPECT_EQ(steps[3].op, GraphStep::Op::MixBus);
+    EXPECT_EQ(steps[3].node, early);
+    EXPECT_EQ(steps[5].node, late);
+    EXPECT_EQ(steps[6].dst, GraphStep::kOutputSlot);
+}
+
+// Verifies that invalid graphs are refused.
+TEST(CompiledGraph, RejectsCyclesAndSharedSources)
+{
+    GraphBuilder builder;
+    const auto a = builder.addBus();
+    const auto b = builder.addBus();
+    const auto source = builder.addSource(makeUnit(1.0f, 1.0f));
+
+    EXPECT_TRUE(builder.connect(source, a));
+    EXPECT_FALSE(builder.connect(source, b)); // Rendered twice per block
+    EXPECT_FALSE(builder.connect(a, source)); // Sources have no inputs
+
+    builder.connect(a, b);
+    builder.connect(b, a);
+    EXPECT_EQ(builder.compile(a, 16, 2), nullptr);
+    EXPECT_EQ(builder.compile(source, 16, 2), nullptr);
+}
+
+// Verifies that blocks larger than the compiled size are processed in
+// pieces, and that the graph finishes with its sources.
+TEST(CompiledGraph, SplitsLargeBlocksAndFinishesWithSources)
+{
+    GraphBuilder builder;
+    const auto master = builder.addBus();
+    auto unit = makeUnit(0.25f, 0.75f);
+    unit->finishedAfterRender = true;
+    builder.connect(builder.addSource(unit), master);
+
+    auto graph = builder.compile(master, 16, 2);
+    ASSERT_NE(graph, nullptr);
+    EXPECT_FALSE(graph->isFinished());
+
+    std::vector<float> buffer(100 * 2);
+    graph->render(buffer.data(), 100, 2, types::RenderContext{});
+    EXPECT_FLOAT_EQ(buffer[0], 0.25f);
+    EXPECT_FLOAT_EQ(buffer[199], 0.75f);
+    EXPECT_TRUE(graph->isFinished());
+}
+
+// Verifies that sources rendered on a worker pool mix exactly like sources
+// rendered on one thread.
+TEST(CompiledGraph, ParallelSourcesMatchSerialRender)
+{
+    constexpr unsigned int kFrames = 128;
+    RenderWorkerPool pool(2, 16, kFrames, 2);
+
+    auto build = []()
+    {
+        GraphBuilder builder;
+        const auto master = builder.addBus(0.8f, 0.1f);
+        for (int i = 0; i < 9; ++i)
+        {
+            builder.connect(
+                builder.addSource(makeUnit(0.1f * static_cast<float>(i),
+                                           -0.07f * static_cast<float>(i)),
+                                  0.9f, -0.2f),
+                master);
+        }
+        return builder.compile(master, kFrames, 2);
+    };
+    auto serial = build();
+    auto parallel = build();
+
+    std::vector<float> expected(kFrames * 2);
+    std::vector<float> actual(kFrames * 2);
+    types::RenderContext parallelContext;
+    parallelContext.workers = &pool;
+
+    serial->render(expected.data(), kFrames, 2, types::RenderContext{});
+    parallel->render(actual.data(), kFrames, 2, parallelContext);
+    EXPECT_EQ(actual, expected);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <dtracker/audio/playback/level_meter.hpp>
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/types.hpp>
+#include <thread>
+#include <vector>
+
+#include "mocks/mock_playback_unit.hpp"
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    // A stereo sine at 'frequency' of the sample rate, with the right
+    // channel at half the left's amplitude.
+    std::vector<float> stereoSine(unsigned int frames, double frequency,
+                                  double phase, float amplitude)
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        std::vector<float> out(frames * 2);
+        for (unsigned int i = 0; i < frames; ++i)
+        {
+            const double angle = 2.0 * kPi * frequency * i + phase;
+            const float x = amplitude * static_cast<float>(std::sin(angle));
+            out[i * 2] = x;
+            out[i * 2 + 1] = 0.5f * x;
+        }
+        return out;
+    }
+} // namespace
+
+// Verifies that peak and RMS settle on the values of a steady sine, per
+// channel.
+TEST(LevelMeter, MeasuresPeakAndRmsPerChannel)
+{
+    LevelMeter meter(48000);
+    const auto sine = stereoSine(480, 0.0125, 0.0, 0.8f); // Six cycles
+
+    // Two seconds of the same block lets the RMS average settle.
+    for (int block = 0; block < 200; ++block)
+        meter.process(sine.data(), 480, 2, block * 480u);
+
+    const LevelReading reading = meter.read();
+    EXPECT_NEAR(reading.peak[0], 0.8f, 1e-3f);
+    EXPECT_NEAR(reading.peak[1], 0.4f, 1e-3f);
+    EXPECT_NEAR(reading.rms[0], 0.8f / std::sqrt(2.0f), 1e-3f);
+    EXPECT_NEAR(reading.rms[1], 0.4f / std::sqrt(2.0f), 1e-3f);
+    EXPECT_EQ(reading.frame, 200u * 480u);
+    EXPECT_EQ(reading.blocks, 200u);
+}
+
+// Verifies that a peak is held after the signal stops and falls back at the
+// documented rate.
+TEST(LevelMeter, PeaksFallBackOverTime)
+{
+    LevelMeter meter(1000);
+    const float burst[2] = {1.0f, -1.0f};
+    meter.process(burst, 1, 2, 0);
+    EXPECT_FLOAT_EQ(meter.read().peak[0], 1.0f);
+
+    // One second of silence.
+    std::vector<float> silence(2000, 0.0f);
+    meter.process(silence.data(), 1000, 2, 1);
+
+    const float expected =
+        std::pow(10.0f, -LevelMeter::kPeakFallDbPerSecond / 20.0f);
+    EXPECT_NEAR(meter.read().peak[0], expected, 1e-4f);
+    EXPECT_NEAR(meter.read().peak[1], expected, 1e-4f);
+}
+
+// Verifies that the true peak catches a sine whose crests fall between
+// samples, which the sample peak misses.
+TEST(LevelMeter, TruePeakFindsIntersamplePeaks)
+{
+    // A quarter of the sample rate, sampled 45 degrees off its crests.
+    const double kPi = 3.14159265358979323846;
+    const auto sine = stereoSine(256, 0.25, kPi / 4.0, 1.0f);
+
+    LevelMeter meter(48000);
+    meter.process(sine.data(), 256, 2, 0);
+    LevelReading reading = meter.read();
+    EXPECT_NEAR(reading.peak[0], std::sqrt(0.5f), 1e-4f);
+    EXPECT_GT(reading.truePeak[0], 0.95f);
+    EXPECT_LT(reading.truePeak[0], 1.05f);
+
+    // Turned off, the true peak is just the sample peak.
+    LevelMeter plain(48000);
+    plain.setTruePeakEnabled(false);
+    plain.process(sine.data(), 256, 2, 0);
+    reading = plain.read();
+    EXPECT_FLOAT_EQ(reading.truePeak[0], reading.peak[0]);
+}
+
+// Verifies that the true-peak filter carries its input across chunk and
+// block boundaries, so the estimate does not depend on how the signal is cut
+// into blocks.
+TEST(LevelMeter, TruePeakDoesNotDependOnBlockSize)
+{
+    // The sine of TruePeakFindsIntersamplePeaks, long enough to span
+    // several of the filter's chunks.
+    const double kPi = 3.14159265358979323846;
+    const auto sine = stereoSine(600, 0.25, kPi / 4.0, 1.0f);
+
+    LevelMeter whole(48000);
+    whole.process(sine.data(), 600, 2, 0);
+    const LevelReading expected = whole.read();
+
+    // Blocks far shorter than the filter only see the crests through the
+    // frames carried over from earlier blocks. The held peak falls a little
+    // more between many blocks than within one.
+    for (unsigned int size : {1u, 7u, 100u})
+    {
+        LevelMeter pieces(48000);
+        for (unsigned int start = 0; start < 600; start += size)
+            pieces.process(sine.data() + start * 2,
+                           std::min(size, 600u - start), 2, start);
+
+        const LevelReading reading = pieces.read();
+        EXPECT_NEAR(reading.truePeak[0], expected.truePeak[0], 5e-3f);
+        EXPECT_NEAR(reading.truePeak[1], expected.truePeak[1], 5e-3f);
+    }
+    EXPECT_GT(expected.truePeak[0], 0.95f);
+}
+
+// Verifies that a mono signal is reported on both channels.
+TEST(LevelMeter, MonoReadsOnBothChannels)
+{
+    LevelMeter meter(48000);
+    const float mono[4] = {0.1f, -0.6f, 0.2f, 0.3f};
+    meter.process(mono, 4, 1, 0);
+
+    const LevelReading reading = meter.read();
+    EXPECT_FLOAT_EQ(reading.peak[0], 0.6f);
+    EXPECT_FLOAT_EQ(reading.peak[1], 0.6f);
+}
+
+// Verifies that the mixer meters its master output.
+TEST(LevelMeter, MixerMetersTheMasterOutput)
+{
+    LevelMeter meter(48000);
+    MixerPlaybackUnit mixer;
+    mixer.setLevelMeter(&meter);
+
+    auto unit = std::make_shared<MockPlaybackUnit>();
+    unit->fillValue = -0.5f;
+    mixer.addUnit(unit);
+
+    std::vector<float> buffer(64 * 2);
+    types::RenderContext context;
+    context.frame = 128;
+    mixer.render(buffer.data(), 64, 2, context);
+
+    const LevelReading reading = meter.read();
+    EXPECT_FLOAT_EQ(reading.peak[0], 0.5f);
+    EXPECT_FLOAT_EQ(reading.peak[1], 0.5f);
+    EXPECT_EQ(reading.frame, 192u);
+}
+
+// Verifies that a reader racing the audio thread always gets a reading from
+// a single block. Each block is a constant, so its peak and RMS match.
+TEST(LevelMeter, ConcurrentReadsAreConsistent)
+{
+    LevelMeter meter(48000);
+    meter.setTruePeakEnabled(false);
+    std::atomic<bool> done{false};
+
+    std::thread audio(
+        [&]
+        {
+            std::vector<float> block(64 * 2);
+            for (int n = 0; n < 20000; ++n)
+            {
+                std::fill(block.begin(), block.end(),
+                          static_cast<float>(n % 100) / 100.0f);
+                meter.process(block.data(), 64, 2, n * 64u);
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+    bool consistent = true;
+    while (!done.load(std::memory_order_acquire))
+    {
+        const LevelReading reading = meter.read();
+        consistent &= reading.frame == reading.blocks * 64u;
+        consistent &= reading.peak[0] == reading.peak[1];
+    }
+    audio.join();
+    EXPECT_TRUE(consistent);
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <dtracker/audio/dsp/mix_kernels.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace dtracker::audio::dsp;
+
+namespace
+{
+    // Every instruction set this machine can run, scalar first.
+    std::vector<InstructionSet> supportedSets()
+    {
+        std::vector<InstructionSet> sets;
+        for (auto set : {InstructionSet::Scalar, InstructionSet::SSE2,
+                         InstructionSet::AVX2, InstructionSet::AVX512})
+        {
+            if (kernelsFor(set))
+                sets.push_back(set);
+        }
+        return sets;
+    }
+
+    // Deterministic test signal in roughly [-1.5, 1.5], so conversions clip.
+    std::vector<float> signal(size_t n, float seed)
+    {
+        std::vector<float> out(n);
+        for (size_t i = 0; i < n; ++i)
+            out[i] = 1.5f * static_cast<float>(((i * 37 + 11) % 101)) / 50.0f -
+                     1.5f + seed;
+        return out;
+    }
+
+    // Lengths that exercise the vector bodies and every tail size.
+    const size_t kLengths[] = {0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 33, 64, 127};
+
+    class MixKernelsTest : public ::testing::TestWithParam<InstructionSet>
+    {
+      protected:
+        const MixKernels &reference = *kernelsFor(InstructionSet::Scalar);
+        const MixKernels &subject = *kernelsFor(GetParam());
+    };
+} // namespace
+
+// Verifies that the dispatched table is one the CPU supports.
+TEST(MixKernels, DispatchesToASupportedSet)
+{
+    EXPECT_NE(kernelsFor(activeInstructionSet()), nullptr);
+    EXPECT_EQ(&kernels(), kernelsFor(activeInstructionSet()));
+}
+
+// Verifies the pan law matches the track's documented behaviour.
+TEST(MixKernels, PanGainsAttenuateTheFarSide)
+{
+    float left = 0.0f;
+    float right = 0.0f;
+
+    panGains(0.5f, -1.0f, left, right);
+    EXPECT_FLOAT_EQ(left, 0.5f);
+    EXPECT_FLOAT_EQ(right, 0.0f);
+
+    panGains(1.0f, 0.5f, left, right);
+    EXPECT_FLOAT_EQ(left, 0.5f);
+    EXPECT_FLOAT_EQ(right, 1.0f);
+}
+
+TEST_P(MixKernelsTest, ClearMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        // One guard sample past the end must stay untouched.
+        auto buffer = signal(n + 1, 0.0f);
+        const float guard = buffer[n];
+        subject.clear(buffer.data(), n);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(buffer[i], 0.0f) << "n=" << n;
+        EXPECT_EQ(buffer[n], guard) << "n=" << n;
+    }
+}
+
+TEST_P(MixKernelsTest, AccumulateMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        const auto src = signal(n, 0.1f);
+        auto expected = signal(n + 1, -0.2f);
+        auto actual = expected;
+
+        reference.accumulate(expected.data(), src.data(), n);
+        subject.accumulate(actual.data(), src.data(), n);
+        for (size_t i = 0; i <= n; ++i)
+            EXPECT_FLOAT_EQ(actual[i], expected[i]) << "n=" << n;
+    }
+}
+
+TEST_P(MixKernelsTest, AccumulateScaledMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        const auto src = signal(n, 0.1f);
+        auto expected = signal(n + 1, -0.2f);
+        auto actual = expected;
+
+        reference.accumulateScaled(expected.data(), src.data(), 0.3f, n);
+        subject.accumulateScaled(actual.data(), src.data(), 0.3f, n);
+        for (size_t i = 0; i <= n; ++i)
+            EXPECT_FLOAT_EQ(actual[i], expected[i]) << "n=" << n;
+    }
+}
+
+TEST_P(MixKernelsTest, AccumulateStereoMatchesScalar)
+{
+    for (size_t frames : kLengths)
+    {
+        const size_t n = frames * 2;
+        const auto src = signal(n, 0.1f);
+        auto expected = signal(n + 1, -0.2f);
+        auto actual = expected;
+
+        reference.accumulateStereo(expected.data(), src.data(), 0.25f, 0.75f,
+                                   frames);
+        subject.accumulateStereo(actual.data(), src.data(), 0.25f, 0.75f,
+                                 frames);
+        for (size_t i = 0; i <= n; ++i)
+            EXPECT_FLOAT_EQ(actual[i], expected[i]) << "frames=" << frames;
+    }
+}
+
+TEST_P(MixKernelsTest, ApplyStereoGainMatchesScalar)
+{
+    for (size_t frames : kLengths)
+    {
+        const size_t n = frames * 2;
+        auto expected = signal(n + 1, 0.0f);
+        auto actual = expected;
+
+        reference.applyStereoGain(expected.data(), 0.5f, -2.0f, frames);
+        subject.applyStereoGain(actual.data(), 0.5f, -2.0f, frames);
+        for (size_t i = 0; i <= n; ++i)
+            EXPECT_FLOAT_EQ(actual[i], expected[i]) << "frames=" << frames;
+    }
+}
+
+TEST_P(MixKernelsTest, FloatToInt16MatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        const auto src = signal(n, 0.0f);
+        std::vector<std::int16_t> expected(n + 1, 123);
+        std::vector<std::int16_t> actual(n + 1, 123);
+
+        reference.floatToInt16(expected.data(), src.data(), n);
+        subject.floatToInt16(actual.data(), src.data(), n);
+        EXPECT_EQ(actual, expected) << "n=" << n;
+    }
+}
+
+TEST_P(MixKernelsTest, Int16ToFloatMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        std::vector<std::int16_t> src(n);
+        for (size_t i = 0; i < n; ++i)
+            src[i] = static_cast<std::int16_t>(i * 2731 - 32768);
+
+        std::vector<float> expected(n + 1, 9.0f);
+        std::vector<float> actual(n + 1, 9.0f);
+
+        reference.int16ToFloat(expected.data(), src.data(), n);
+        subject.int16ToFloat(actual.data(), src.data(), n);
+        for (size_t i = 0; i <= n; ++i)
+            EXPECT_FLOAT_EQ(actual[i], expected[i]) << "n=" << n;
+    }
+}
+
+// The sums may be added in a different order, so they only need to agree
+// to rounding. The peaks must match exactly.
+TEST_P(MixKernelsTest, MeasureMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        const auto src = signal(n, 0.1f);
+        float expectedPeaks[2] = {0.25f, 0.0f};
+        float expectedSums[2] = {1.0f, 2.0f};
+        float actualPeaks[2] = {0.25f, 0.0f};
+        float actualSums[2] = {1.0f, 2.0f};
+
+        reference.measure(src.data(), n, expectedPeaks, expectedSums);
+        subject.measure(src.data(), n, actualPeaks, actualSums);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            EXPECT_EQ(actualPeaks[ch], expectedPeaks[ch]) << "n=" << n;
+            EXPECT_NEAR(actualSums[ch], expectedSums[ch],
+                        1e-5f * expectedSums[ch])
+                << "n=" << n;
+        }
+    }
+}
+
+// Like the measured sums, the products may be added in another order.
+TEST_P(MixKernelsTest, DotStereoMatchesScalar)
+{
+    for (size_t n : kLengths)
+    {
+        const auto src = signal(n, 0.1f);
+        const auto coeffs = signal(n, 0.7f);
+        float expected[2] = {1.0f, -1.0f};
+        float actual[2] = {1.0f, -1.0f};
+
+        reference.dotStereo(src.data(), coeffs.data(), n, expected);
+        subject.dotStereo(src.data(), coeffs.data(), n, actual);
+        for (int ch = 0; ch < 2; ++ch)
+            EXPECT_NEAR(actual[ch], expected[ch], 1e-4f) << "n=" << n;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllSupported, MixKernelsTest,
+                         ::testing::ValuesIn(supportedSets()),
+                         [](const auto &info)
+                         {
+                             std::string name =
+                                 instructionSetName(info.param);
+                             name.erase(std::remove(name.begin(), name.end(),
+                                                    '-'),
+                                        name.end());
+                             return name;
+                         });
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "mocks/mock_playback_unit.hpp"
+#include <cstdint>
+#include <cstring>
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/render/offline_renderer.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
+#include <dtracker/audio/render/wav_file_sink.hpp>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+using namespace dtracker::audio;
+
+namespace
+{
+    // Reads a little-endian 32-bit value from a byte buffer.
+    std::uint32_t readU32(const std::vector<char> &bytes, size_t offset)
+    {
+        std::uint32_t value = 0;
+        for (size_t i = 0; i < 4; ++i)
+            value |= static_cast<std::uint32_t>(
+                         static_cast<unsigned char>(bytes[offset + i]))
+                     << (8 * i);
+        return value;
+    }
+
+    types::AudioSettings makeSettings(unsigned int bufferFrames)
+    {
+        types::AudioSettings settings;
+        settings.bufferFrames = bufferFrames;
+        return settings;
+    }
+} // namespace
+
+// Verifies the renderer stops as soon as the graph reports finished.
+TEST(OfflineRenderer, StopsWhenGraphFinishes)
+{
+    auto mock = std::make_shared<MockPlaybackUnit>();
+    mock->fillValue = 0.25f;
+    mock->finishedAfterRender = true;
+
+    playback::MixerPlaybackUnit mixer;
+    mixer.addUnit(mock);
+
+    render::OfflineRenderer renderer(makeSettings(64));
+    render::MemoryRenderSink sink;
+    auto result = renderer.render(mixer, sink, {}, 44100);
+
+    EXPECT_TRUE(result.ok);
+    EXPECT_TRUE(result.finished);
+    EXPECT_EQ(result.framesRendered, 64u);
+    ASSERT_EQ(sink.frames(), 64u);
+    EXPECT_EQ(sink.channels(), 2u);
+    for (float sample : sink.data())
+        EXPECT_FLOAT_EQ(sample, 0.25f);
+}
+
+// Verifies that a graph which never finishes is cut off at the frame limit,
+// including a final partial block.
+TEST(OfflineRenderer, RespectsFrameLimit)
+{
+    playback::MixerPlaybackUnit mixer;
+    mixer.addUnit(std::make_shared<MockPlaybackUnit>());
+
+    render::OfflineRenderer renderer(makeSettings(64));
+    render::MemoryRenderSink sink;
+    auto result = renderer.render(mixer, sink, {}, 100);
+
+    EXPECT_TRUE(result.ok);
+    EXPECT_FALSE(result.finished);
+    EXPECT_EQ(result.framesRendered, 100u);
+    EXPECT_EQ(sink.frames(), 100u);
+}
+
+// Verifies the WAV sink writes a header whose sizes match the streamed data.
+TEST(WavFileSink, WritesValidHeader)
+{
+    const auto path =
+        std::filesystem::temp_directory_path() / "dtracker_wav_sink_test.wav";
+
+    {
+        render::WavFileSink sink(path.string(),
+                                 render::WavSampleFormat::Int16);
+        ASSERT_TRUE(sink.open(48000, 2));
+        std::vector<float> block(10 * 2, 0.5f);
+        ASSERT_TRUE(sink.write(block.data(), 10));
+        ASSERT_TRUE(sink.write(block.data(), 10));
+        ASSERT_TRUE(sink.close());
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    // 44 header bytes + 20 frames * 2 channels * 2 bytes.
+    ASSERT_EQ(bytes.size(), 44u + 80u);
+    EXPECT_EQ(std::memcmp(bytes.data(), "RIFF", 4), 0);
+    EXPECT_EQ(std::memcmp(bytes.data() + 8, "WAVE", 4), 0);
+    EXPECT_EQ(readU32(bytes, 4), 36u + 80u);  // RIFF chunk size
+    EXPECT_EQ(readU32(bytes, 24), 48000u);    // Sample rate
+    EXPECT_EQ(readU32(bytes, 40), 80u);       // data chunk size
+}
+
+// Verifies that a float file carries the extended fmt chunk and the fact
+// chunk required of formats other than PCM.
+TEST(WavFileSink, WritesFactChunkForFloat)
+{
+    const auto path = std::filesystem::temp_directory_path() /
+                      "dtracker_wav_sink_float_test.wav";
+
+    {
+        render::WavFileSink sink(path.string(),
+                                 render::WavSampleFormat::Float32);
+        ASSERT_TRUE(sink.open(44100, 2));
+        std::vector<float> block(6 * 2, 0.25f);
+        ASSERT_TRUE(sink.write(block.data(), 6));
+        ASSERT_TRUE(sink.close());
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    // 58 header bytes + 6 frames * 2 channels * 4 bytes.
+    ASSERT_EQ(bytes.size(), 58u + 48u);
+    EXPECT_EQ(readU32(bytes, 4), 50u + 48u);   // RIFF chunk size
+    EXPECT_EQ(readU32(bytes, 16), 18u);        // fmt chunk size
+    EXPECT_EQ(bytes[20], 3);                   // WAVE_FORMAT_IEEE_FLOAT
+    EXPECT_EQ(bytes[36] | bytes[37], 0);       // cbSize
+    EXPECT_EQ(std::memcmp(bytes.data() + 38, "fact", 4), 0);
+    EXPECT_EQ(readU32(bytes, 42), 4u);         // fact chunk size
+    EXPECT_EQ(readU32(bytes, 46), 6u);         // Frames
+    EXPECT_EQ(std::memcmp(bytes.data() + 50, "data", 4), 0);
+    EXPECT_EQ(readU32(bytes, 54), 48u);        // data chunk size
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/performance_monitor.hpp>
+
+using namespace dtracker::audio;
+
+// Verifies that loads, overloads and xruns are counted and binned.
+TEST(PerformanceMonitor, RecordsLoadPerCallback)
+{
+    PerformanceMonitor monitor;
+    monitor.recordCallback(5000000, 10000000, false);  // 50%
+    monitor.recordCallback(15000000, 10000000, true);  // 150%, xrun
+    monitor.recordCallback(50000000, 10000000, false); // Off the scale
+
+    const PerformanceSnapshot snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.callbacks, 3u);
+    EXPECT_EQ(snapshot.xruns, 1u);
+    EXPECT_EQ(snapshot.overloads, 2u);
+    EXPECT_EQ(snapshot.lastCallbackNanos, 50000000u);
+    EXPECT_FLOAT_EQ(snapshot.load, 5.0f);
+    EXPECT_FLOAT_EQ(snapshot.peakLoad, 5.0f);
+    EXPECT_FLOAT_EQ(snapshot.averageLoad, 7.0f / 3.0f);
+
+    EXPECT_EQ(snapshot.loadHistogram[5], 1u);
+    EXPECT_EQ(snapshot.loadHistogram[15], 1u);
+    EXPECT_EQ(snapshot.loadHistogram[PerformanceSnapshot::kLoadBins - 1], 1u);
+
+    monitor.reset();
+    EXPECT_EQ(monitor.snapshot().callbacks, 0u);
+    EXPECT_EQ(monitor.snapshot().loadHistogram[5], 0u);
+}
+
+// Verifies that voices counted during a block are published together and
+// the tally starts over for the next block.
+TEST(PerformanceMonitor, PublishesVoicesPerBlock)
+{
+    PerformanceMonitor monitor;
+    monitor.countVoices(3);
+    monitor.countVoices(4);
+    EXPECT_EQ(monitor.snapshot().activeVoices, 0u);
+
+    monitor.publishVoices();
+    EXPECT_EQ(monitor.snapshot().activeVoices, 7u);
+
+    monitor.publishVoices();
+    EXPECT_EQ(monitor.snapshot().activeVoices, 0u);
+}
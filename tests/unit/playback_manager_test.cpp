@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
 
+#include "mocks/click_sample.hpp"
 #include "mocks/mock_engine.hpp"
 #include "mocks/mock_mixer_playback_unit.hpp"
 #include "mocks/mock_sample_manager.hpp"
 #include <dtracker/audio/playback/sample_playback_unit.hpp>
 #include <dtracker/audio/playback_manager.hpp>
+#include <dtracker/audio/render/render_sink.hpp>
 #include <dtracker/sample/types.hpp>
+#include <dtracker/tracker/track_manager.hpp>
 #include <memory>
 
 // --- Test Fixture ---
@@ -79,3 +82,76 @@ TEST_F(PlaybackManagerTest, StopPlaybackStopsPlayback)
     // It should no longer report that it is playing.
     EXPECT_FALSE(pm->isPlaying());
 }
+
+// Verifies that the sample manager is told which rate to convert samples to.
+TEST_F(PlaybackManagerTest, SetsTheTargetSampleRate)
+{
+    EXPECT_EQ(m_mockSampleManager.targetSampleRate,
+              engine.getSettings().sampleRate);
+}
+
+// Verifies that previews count against the voice limit, so they can be
+// stolen like any other voice.
+TEST_F(PlaybackManagerTest, PreviewsGoThroughThePolyphonyManager)
+{
+    dtracker::sample::types::SampleDescriptor descriptor{
+        -1,
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            dtracker::audio::types::PCMData(64, 0.1f)),
+        {44100, 16}};
+
+    auto &polyphony = pm->polyphony();
+    polyphony.setTrackLimit(
+        dtracker::audio::PlaybackManager::kPreviewTrackId, 1);
+    pm->playSample(descriptor);
+    EXPECT_EQ(polyphony.activeVoices(), 1u);
+
+    pm->playSample(descriptor);
+    EXPECT_EQ(polyphony.activeVoices(), 1u);
+    EXPECT_EQ(polyphony.trackStealCount(
+                  dtracker::audio::PlaybackManager::kPreviewTrackId),
+              1u);
+
+    // The mock engine outlives the manager, so hand the pooled voices back
+    // while their pool still exists.
+    pm->stopPlayback();
+}
+
+// Verifies that the waveform entry points hand out readers: one of the
+// master tap, and one without a tap for a track that is not playing.
+TEST_F(PlaybackManagerTest, WaveformQueuesHandOutReaders)
+{
+    EXPECT_NE(pm->getMasterWaveformQueue().tap(), nullptr);
+    EXPECT_EQ(pm->getWaveformQueueForTrack(3).tap(), nullptr);
+}
+
+// Verifies that an export schedules its steps through the same sequencer as
+// live playback, starting each note on its exact frame.
+TEST_F(PlaybackManagerTest, RendersTracksThroughTheSequencer)
+{
+    m_mockSampleManager.addSampleToMock(
+        1, dtracker::sample::types::SampleDescriptor(
+               1,
+               std::make_shared<const dtracker::audio::types::PCMData>(
+                   dtracker::audio::types::PCMData(20, 1.0f)),
+               {44100, 16}));
+
+    dtracker::tracker::TrackManager tracks;
+    const int trackId = tracks.createTrack();
+    dtracker::tracker::types::ActivePattern pattern;
+    pattern.steps = {1, -1, 1};
+    tracks.addPatternToTrack(trackId, pattern);
+
+    dtracker::audio::PlaybackManager manager(&engine, &m_mockSampleManager,
+                                             &tracks);
+    dtracker::audio::render::MemoryRenderSink sink;
+    ASSERT_TRUE(manager.renderAllTracks(sink, 44100));
+
+    // At 120 BPM and 44.1 kHz a step is 5512.5 frames, so the third step
+    // starts on frame 11025. The song ends in the block holding the end of
+    // that step.
+    EXPECT_GE(sink.frames(), 16538u);
+    EXPECT_LT(sink.frames(), 16538u + engine.getSettings().bufferFrames);
+    expectClickAt(sink.data(), 0);
+    expectClickAt(sink.data(), 11025);
+}
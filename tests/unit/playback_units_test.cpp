@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "mocks/click_sample.hpp"
 #include "mocks/mock_pattern_playback_unit.hpp"
 #include "mocks/mock_playback_unit.hpp"
 #include "mocks/mock_stereo_unit.hpp"
@@ -10,7 +11,9 @@
 #include <dtracker/audio/playback/pattern_playback_unit.hpp>
 #include <dtracker/audio/playback/proxy_playback_unit.hpp>
 #include <dtracker/audio/playback/sample_playback_unit.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
 #include <dtracker/audio/playback/track_playback_unit.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
 #include <dtracker/audio/types.hpp>
 #include <dtracker/sample/types.hpp>
 #include <memory>
@@ -191,6 +194,114 @@ TEST(SamplePlaybackUnit, ResetRestartsPlaybackFromBeginning)
         EXPECT_NEAR(sample, 0.25f, 0.0001f);
 }
 
+// Verifies that renderAdd() sums into the buffer with per-channel gains
+// instead of overwriting it.
+TEST(SamplePlaybackUnit, RenderAddAccumulatesWithGain)
+{
+    dtracker::sample::types::SampleDescriptor descriptor{
+        -1,
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            dtracker::audio::types::PCMData{1.0f, 1.0f}), // 1 stereo frame
+        {44100, 16}};
+    auto unit = playback::makePlaybackUnit(std::move(descriptor));
+
+    std::vector<float> buffer(4, 0.5f); // Request 2 frames.
+    unit->renderAdd(buffer.data(), 2, 2, context, 0.5f, 0.25f);
+
+    // Expect: [1.0, 0.75, 0.5, 0.5]; the frame past the end is untouched.
+    EXPECT_FLOAT_EQ(buffer[0], 1.0f);
+    EXPECT_FLOAT_EQ(buffer[1], 0.75f);
+    EXPECT_FLOAT_EQ(buffer[2], 0.5f);
+    EXPECT_FLOAT_EQ(buffer[3], 0.5f);
+    EXPECT_TRUE(unit->isFinished());
+}
+
+// Verifies that a start offset delays the sample into the block, even when
+// the offset spans more than one block.
+TEST(SamplePlaybackUnit, StartOffsetDelaysPlayback)
+{
+    dtracker::sample::types::SampleDescriptor descriptor{
+        -1,
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            dtracker::audio::types::PCMData(8, 1.0f)), // 4 stereo frames
+        {44100, 16}};
+    auto unit = playback::makePlaybackUnit(std::move(descriptor));
+    unit->setStartOffset(6);
+
+    std::vector<float> buffer(4 * 2, 0.0f);
+    unit->renderAdd(buffer.data(), 4, 2, context);
+    EXPECT_EQ(buffer, std::vector<float>(8, 0.0f));
+
+    // Two frames of delay remain, then the sample starts.
+    unit->renderAdd(buffer.data(), 4, 2, context);
+    EXPECT_FLOAT_EQ(buffer[3], 0.0f);
+    EXPECT_FLOAT_EQ(buffer[4], 1.0f);
+    EXPECT_FLOAT_EQ(buffer[7], 1.0f);
+    EXPECT_FALSE(unit->isFinished());
+}
+
+// Verifies that a sample recorded at twice the stream's rate plays in half
+// the frames, at its own pitch, and that a context without a rate leaves it
+// alone.
+TEST(SamplePlaybackUnit, ResamplesToTheContextRate)
+{
+    // A ramp, which linear and cubic interpolation both follow exactly.
+    dtracker::audio::types::PCMData ramp(64 * 2);
+    for (size_t i = 0; i < ramp.size(); ++i)
+        ramp[i] = static_cast<float>(i / 2) / 64.0f;
+    dtracker::sample::types::SampleDescriptor descriptor{
+        -1, std::make_shared<const dtracker::audio::types::PCMData>(ramp),
+        {48000, 16}};
+
+    types::RenderContext resampled;
+    resampled.sampleRate = 24000;
+    resampled.resampleQuality = dsp::ResampleQuality::Linear;
+
+    playback::SamplePlaybackUnit unit(descriptor);
+    std::vector<float> buffer(40 * 2, 0.0f);
+    unit.render(buffer.data(), 20, 2, resampled);
+    EXPECT_FALSE(unit.isFinished());
+    unit.render(buffer.data() + 40, 20, 2, resampled);
+    EXPECT_TRUE(unit.isFinished());
+
+    for (size_t i = 0; i < 32; ++i)
+    {
+        EXPECT_FLOAT_EQ(buffer[i * 2], static_cast<float>(i * 2) / 64.0f);
+        EXPECT_FLOAT_EQ(buffer[i * 2 + 1], buffer[i * 2]);
+    }
+    EXPECT_EQ(buffer[32 * 2], 0.0f);
+
+    // Without a stream rate, every frame is copied as it is.
+    playback::SamplePlaybackUnit direct(descriptor);
+    direct.render(buffer.data(), 40, 2, context);
+    EXPECT_FLOAT_EQ(buffer[39 * 2], 39.0f / 64.0f);
+    EXPECT_FALSE(direct.isFinished());
+}
+
+// Verifies that a stolen voice fades out while it is being resampled.
+TEST(SamplePlaybackUnit, FadesOutWhileResampling)
+{
+    dtracker::sample::types::SampleDescriptor descriptor{
+        -1,
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            dtracker::audio::types::PCMData(400 * 2, 1.0f)),
+        {44100, 16}};
+    types::RenderContext resampled;
+    resampled.sampleRate = 48000;
+
+    playback::SamplePlaybackUnit unit(descriptor);
+    std::vector<float> buffer(100 * 2, 0.0f);
+    unit.renderAdd(buffer.data(), 10, 2, resampled);
+    unit.fadeOut(80);
+    unit.renderAdd(buffer.data() + 20, 90, 2, resampled);
+
+    EXPECT_TRUE(unit.isFinished());
+    EXPECT_NEAR(buffer[10 * 2], 1.0f, 1e-3f);
+    EXPECT_LT(buffer[50 * 2], buffer[20 * 2]);
+    EXPECT_GT(buffer[89 * 2], 0.0f);
+    EXPECT_EQ(buffer[90 * 2], 0.0f);
+}
+
 // -------------------------
 // MixerPlaybackUnit Tests
 // -------------------------
@@ -262,6 +373,85 @@ TEST(MixerPlaybackUnit, ClearRemovesAllUnits)
         EXPECT_FLOAT_EQ(sample, 0.0f);
 }
 
+// Verifies that queued changes only take effect at the start of a block.
+TEST(MixerPlaybackUnit, AppliesRemoveAtNextBlock)
+{
+    auto unitA = std::make_shared<MockPlaybackUnit>();
+    auto unitB = std::make_shared<MockPlaybackUnit>();
+    unitA->fillValue = 0.25f;
+    unitB->fillValue = 0.5f;
+
+    playback::MixerPlaybackUnit mixer;
+    mixer.addUnit(unitA);
+    mixer.addUnit(unitB);
+
+    float buffer[64];
+    mixer.render(buffer, 32, 2, context);
+    EXPECT_FLOAT_EQ(buffer[0], 0.75f);
+
+    mixer.removeUnit(unitA);
+    mixer.render(buffer, 32, 2, context);
+    EXPECT_FLOAT_EQ(buffer[0], 0.5f);
+    EXPECT_EQ(unitA->renderCallCount, 1);
+    EXPECT_EQ(unitB->renderCallCount, 2);
+}
+
+// Verifies that parameter changes are delivered to units through the queue.
+TEST(MixerPlaybackUnit, SetUnitParameterReachesTrack)
+{
+    auto pattern = std::make_unique<MockPatternPlaybackUnit>();
+    auto track = std::make_shared<playback::TrackPlaybackUnit>();
+    track->addUnit(std::move(pattern));
+
+    playback::MixerPlaybackUnit mixer;
+    mixer.addUnit(track);
+    mixer.setUnitParameter(track, playback::UnitParam::Volume, 0.5f);
+
+    float buffer[64];
+    mixer.render(buffer, 32, 2, context);
+    EXPECT_FLOAT_EQ(buffer[0], 0.5f);
+    EXPECT_FLOAT_EQ(buffer[1], 0.5f);
+}
+
+// Stress-tests the mixer by mutating it from a control thread while the
+// audio thread renders.
+TEST(MixerPlaybackUnit, ConcurrentMutationIsSafe)
+{
+    playback::MixerPlaybackUnit mixer;
+    std::atomic<bool> done = false;
+
+    std::thread control(
+        [&]
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                mixer.addUnit(std::make_shared<MockPlaybackUnit>());
+                if (i % 7 == 0)
+                    mixer.clear();
+            }
+            done = true;
+        });
+
+    std::thread audio(
+        [&]
+        {
+            float buffer[128];
+            while (!done)
+                mixer.render(buffer, 64, 2, context);
+        });
+
+    control.join();
+    audio.join();
+
+    // Drain whatever is still pending, then empty the mix.
+    float buffer[128];
+    mixer.render(buffer, 64, 2, context);
+    mixer.clear();
+    EXPECT_TRUE(mixer.isFinished());
+    mixer.render(buffer, 64, 2, context);
+    EXPECT_TRUE(mixer.isFinished());
+}
+
 // -------------------------
 // TrackPlaybackUnit Tests
 // -------------------------
@@ -336,6 +526,47 @@ TEST(TrackPlaybackUnit, PanBiasesLeftOrRight)
     }
 }
 
+// Verifies that a track's tap sees it after its own fader but before the
+// parent's gains, and that the parent still gets the full mix.
+TEST(TrackPlaybackUnit, TapsPostFaderOutput)
+{
+    auto unit = std::make_unique<MockPatternPlaybackUnit>();
+    auto tap = std::make_shared<playback::WaveformTap>(2, 32, 2);
+    playback::WaveformTap::Reader reader(tap);
+    playback::TrackPlaybackUnit track(tap);
+    track.setVolume(0.5f);
+    track.addUnit(std::move(unit));
+
+    playback::ScratchArena arena;
+    arena.configure(32, 2);
+    types::RenderContext tapContext;
+    tapContext.scratch = &arena;
+
+    float buffer[64] = {};
+    track.renderAdd(buffer, 32, 2, tapContext, 0.5f, 0.5f);
+    for (float sample : buffer)
+        EXPECT_FLOAT_EQ(sample, 0.25f);
+
+    std::vector<float> block;
+    ASSERT_TRUE(reader.read(block));
+    for (float sample : block)
+        EXPECT_FLOAT_EQ(sample, 0.5f);
+
+    // Without scratch memory a track still plays, and its tap counts the
+    // block it could not be given.
+    auto starvedUnit = std::make_unique<MockPatternPlaybackUnit>();
+    auto starvedTap = std::make_shared<playback::WaveformTap>(2, 32, 2);
+    playback::TrackPlaybackUnit starved(starvedTap);
+    starved.setVolume(0.5f);
+    starved.addUnit(std::move(starvedUnit));
+
+    float direct[64] = {};
+    starved.renderAdd(direct, 32, 2, context, 0.5f, 0.5f);
+    EXPECT_FLOAT_EQ(direct[0], 0.25f);
+    EXPECT_EQ(starvedTap->droppedBlocks(), 1u);
+    EXPECT_EQ(starvedTap->publishedBlocks(), 0u);
+}
+
 // Verifies that resetting a track also resets all contained sample units.
 // TEST(TrackPlaybackUnit, ResetResetsAllSamples)
 // {
@@ -370,8 +601,8 @@ TEST_F(PatternPlaybackTest, TriggersNotesFromPool)
     auto patternUnit =
         playback::PatternPlaybackUnit(pattern, blueprint, &pool, 44100);
 
-    pool.queueUnit(std::make_shared<playback::SamplePlaybackUnit>());
-    pool.queueUnit(std::make_shared<playback::SamplePlaybackUnit>());
+    pool.queueUnit();
+    pool.queueUnit();
 
     // Act: Render enough audio to play through the entire pattern.
     std::vector<float> buffer(13230 * 2); // 3 steps * 100ms = 300ms
@@ -382,6 +613,79 @@ TEST_F(PatternPlaybackTest, TriggersNotesFromPool)
     EXPECT_EQ(pool.acquireCallCount, 2);
 }
 
+namespace
+{
+    types::RenderContext clickContext(bool looping)
+    {
+        types::RenderContext clickContext;
+        clickContext.bpm = 60.0f;
+        clickContext.isLooping = looping;
+        return clickContext;
+    }
+
+    // Renders 'total' frames in blocks of 'blockFrames', advancing the
+    // transport frame like the engine does.
+    std::vector<float> renderInBlocks(playback::PlaybackUnit &unit,
+                                      unsigned int total,
+                                      unsigned int blockFrames,
+                                      types::RenderContext ctx)
+    {
+        std::vector<float> out(total * 2, 0.0f);
+        for (unsigned int offset = 0; offset < total; offset += blockFrames)
+        {
+            ctx.frame = offset;
+            unit.render(out.data() + offset * 2,
+                        std::min(blockFrames, total - offset), 2, ctx);
+        }
+        return out;
+    }
+} // namespace
+
+// Verifies that notes start on the exact frame of their step, whatever the
+// block size.
+TEST(PatternPlaybackUnit, TriggersNotesAtExactFrame)
+{
+    dtracker::tracker::types::ActivePattern pattern;
+    pattern.steps = {1, -1, 1};
+
+    for (unsigned int blockFrames : {256u, 64u, 37u})
+    {
+        playback::UnitPool pool(4);
+        playback::PatternPlaybackUnit unit(pattern, clickBlueprint(), &pool,
+                                           kClickRate);
+        auto out = renderInBlocks(unit, 300, blockFrames, clickContext(false));
+
+        SCOPED_TRACE(blockFrames);
+        EXPECT_FLOAT_EQ(out[0], 1.0f);      // Step 0 at frame 0
+        EXPECT_FLOAT_EQ(out[9 * 2], 1.0f);  // Click lasts 10 frames
+        EXPECT_FLOAT_EQ(out[10 * 2], 0.0f);
+        EXPECT_FLOAT_EQ(out[100 * 2], 0.0f); // Step 1 is a rest
+        EXPECT_FLOAT_EQ(out[199 * 2], 0.0f);
+        EXPECT_FLOAT_EQ(out[200 * 2], 1.0f); // Step 2 at frame 200
+        EXPECT_FLOAT_EQ(out[209 * 2], 1.0f);
+        EXPECT_FLOAT_EQ(out[210 * 2], 0.0f);
+        EXPECT_TRUE(unit.hasFinishedLoop());
+    }
+}
+
+// Verifies that a looping track restarts its pattern on the exact frame the
+// previous loop ends, even in the middle of a block.
+TEST(TrackPlaybackUnit, LoopsPatternOnExactFrame)
+{
+    dtracker::tracker::types::ActivePattern pattern;
+    pattern.steps = {1, -1}; // Loops every 200 frames
+
+    playback::UnitPool pool(4);
+    playback::TrackPlaybackUnit track;
+    track.addUnit(std::make_unique<playback::PatternPlaybackUnit>(
+        pattern, clickBlueprint(), &pool, kClickRate));
+
+    auto out = renderInBlocks(track, 512, 512, clickContext(true));
+
+    for (unsigned int loopStart : {0u, 200u, 400u})
+        expectClickAt(out, loopStart);
+}
+
 //==============================================================================
 // UPDATED: TrackPlaybackUnit Tests
 //==============================================================================
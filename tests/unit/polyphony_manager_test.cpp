@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <dtracker/audio/playback/unit_pool.hpp>
+#include <dtracker/audio/types.hpp>
+#include <memory>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    // A descriptor for 'frames' stereo frames of a constant value.
+    dtracker::sample::types::SampleDescriptor constantSample(size_t frames,
+                                                             float value)
+    {
+        return {-1,
+                std::make_shared<const types::PCMData>(
+                    types::PCMData(frames * 2, value)),
+                {44100, 16}};
+    }
+} // namespace
+
+// Verifies that a note over the voice limit steals the oldest voice rather
+// than being dropped.
+TEST(PolyphonyManager, StealsOldestVoiceAtTheLimit)
+{
+    UnitPool pool(4);
+    PolyphonyManager polyphony(&pool, 2);
+
+    auto first = polyphony.acquire(1);
+    auto second = polyphony.acquire(1);
+    auto third = polyphony.acquire(1);
+
+    ASSERT_NE(third, nullptr);
+    EXPECT_TRUE(first->isFadingOut());
+    EXPECT_FALSE(second->isFadingOut());
+    EXPECT_EQ(polyphony.stealCount(), 1u);
+    EXPECT_EQ(polyphony.trackStealCount(1), 1u);
+    EXPECT_EQ(polyphony.dropCount(), 0u);
+    EXPECT_EQ(polyphony.activeVoices(), 2u);
+}
+
+// Verifies that the quietest policy picks the voice with the lowest level.
+TEST(PolyphonyManager, StealsQuietestVoice)
+{
+    UnitPool pool(4);
+    PolyphonyManager polyphony(&pool, 2, StealPolicy::Quietest);
+    types::RenderContext context;
+    std::vector<float> buffer(16 * 2, 0.0f);
+
+    auto loud = polyphony.acquire(1);
+    loud->reinitialize(constantSample(64, 1.0f));
+    loud->renderAdd(buffer.data(), 16, 2, context);
+
+    auto quiet = polyphony.acquire(1);
+    quiet->reinitialize(constantSample(64, 0.2f));
+    quiet->renderAdd(buffer.data(), 16, 2, context);
+
+    auto next = polyphony.acquire(1);
+    ASSERT_NE(next, nullptr);
+    EXPECT_TRUE(quiet->isFadingOut());
+    EXPECT_FALSE(loud->isFadingOut());
+}
+
+// Verifies that a track over its own limit steals from itself and leaves
+// other tracks alone.
+TEST(PolyphonyManager, EnforcesPerTrackLimits)
+{
+    UnitPool pool(8);
+    PolyphonyManager polyphony(&pool);
+    polyphony.setTrackLimit(1, 1);
+
+    auto drum = polyphony.acquire(1);
+    auto bass = polyphony.acquire(2);
+    auto nextDrum = polyphony.acquire(1);
+
+    ASSERT_NE(nextDrum, nullptr);
+    EXPECT_TRUE(drum->isFadingOut());
+    EXPECT_FALSE(bass->isFadingOut());
+    EXPECT_EQ(polyphony.trackStealCount(1), 1u);
+    EXPECT_EQ(polyphony.trackStealCount(2), 0u);
+}
+
+// Verifies that a note is dropped only when every spare unit is still
+// fading, and that the pool recovers once the fade has played out.
+TEST(PolyphonyManager, DropsOnlyWhileVoicesAreFading)
+{
+    UnitPool pool(2);
+    PolyphonyManager polyphony(&pool, 2);
+
+    auto first = polyphony.acquire(1);
+    auto second = polyphony.acquire(1);
+    EXPECT_EQ(polyphony.acquire(1), nullptr);
+    EXPECT_EQ(polyphony.dropCount(), 1u);
+    EXPECT_TRUE(first->isFadingOut());
+
+    // The stolen voice finishes and goes back to the pool.
+    first.reset();
+    EXPECT_NE(polyphony.acquire(1), nullptr);
+}
+
+// Verifies that a stolen voice ramps down to silence instead of stopping
+// dead, then finishes.
+TEST(PolyphonyManager, StolenVoiceFadesOut)
+{
+    SamplePlaybackUnit unit(constantSample(64, 1.0f));
+    types::RenderContext context;
+    std::vector<float> buffer(8 * 2, 0.0f);
+
+    unit.fadeOut(4);
+    unit.renderAdd(buffer.data(), 8, 2, context);
+
+    const float expected[] = {1.0f, 0.75f, 0.5f, 0.25f, 0.0f};
+    for (size_t frame = 0; frame < 5; ++frame)
+    {
+        EXPECT_FLOAT_EQ(buffer[frame * 2], expected[frame]);
+        EXPECT_FLOAT_EQ(buffer[frame * 2 + 1], expected[frame]);
+    }
+    EXPECT_TRUE(unit.isFinished());
+}
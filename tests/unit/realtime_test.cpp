@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <dtracker/audio/realtime.hpp>
+#include <thread>
+#include <vector>
+
+using namespace dtracker::audio;
+
+// Verifies that once denormals are flushed, a product that would be
+// denormal comes out as zero. Runs on its own thread so the test runner's
+// floating-point mode is left alone.
+TEST(Realtime, FlushesDenormalsToZero)
+{
+    bool supported = false;
+    float product = 1.0f;
+    std::thread thread(
+        [&]
+        {
+            supported = realtime::flushDenormals();
+            volatile float smallest = FLT_MIN;
+            product = smallest * 0.5f;
+        });
+    thread.join();
+
+    if (!supported)
+        GTEST_SKIP() << "No flush-to-zero mode on this CPU";
+    EXPECT_EQ(product, 0.0f);
+}
+
+// Verifies that invalid requests are refused rather than passed to the OS.
+TEST(Realtime, RejectsInvalidRequests)
+{
+    EXPECT_FALSE(realtime::pinToCore(-1));
+    EXPECT_FALSE(realtime::lockMemory(nullptr, 4096));
+
+    std::vector<char> memory(4096);
+    EXPECT_FALSE(realtime::lockMemory(memory.data(), 0));
+
+    // Locking may be refused by the OS limit; unlocking must be safe
+    // either way.
+    realtime::lockMemory(memory.data(), memory.size());
+    realtime::unlockMemory(memory.data(), memory.size());
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
+#include <dtracker/audio/playback/sample_playback_unit.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    // Records whether, and on which thread, it was destroyed.
+    struct DestructionProbe
+    {
+        DestructionProbe(std::atomic<bool> *destroyed,
+                         std::atomic<std::thread::id> *destroyedOn)
+            : destroyed(destroyed), destroyedOn(destroyedOn)
+        {
+        }
+
+        ~DestructionProbe()
+        {
+            if (destroyedOn)
+                destroyedOn->store(std::this_thread::get_id());
+            destroyed->store(true);
+        }
+
+        std::atomic<bool> *destroyed;
+        std::atomic<std::thread::id> *destroyedOn;
+    };
+} // namespace
+
+// Verifies that retired objects stay alive until collect() runs.
+TEST(ReclaimQueue, DefersDestructionUntilCollect)
+{
+    ReclaimQueue queue(16);
+    std::atomic<bool> destroyed{false};
+
+    auto probe = std::make_shared<DestructionProbe>(&destroyed, nullptr);
+    EXPECT_TRUE(queue.retire(std::move(probe)));
+    EXPECT_FALSE(destroyed.load());
+
+    EXPECT_EQ(queue.collect(), 1u);
+    EXPECT_TRUE(destroyed.load());
+    EXPECT_EQ(queue.reclaimedCount(), 1u);
+}
+
+// Verifies that a full queue releases the object in place instead of leaking.
+TEST(ReclaimQueue, OverflowReleasesInPlace)
+{
+    ReclaimQueue queue(2);
+    std::atomic<bool> destroyed{false};
+
+    queue.retire(std::make_shared<int>(1));
+    queue.retire(std::make_shared<int>(2));
+    EXPECT_FALSE(
+        queue.retire(std::make_shared<DestructionProbe>(&destroyed, nullptr)));
+
+    EXPECT_TRUE(destroyed.load());
+    EXPECT_EQ(queue.overflowCount(), 1u);
+}
+
+// Verifies that the collector thread, not the retiring thread, runs the
+// destructor.
+TEST(ReclaimQueue, CollectorDestroysOffTheRetiringThread)
+{
+    ReclaimQueue queue(16);
+    std::atomic<bool> destroyed{false};
+    std::atomic<std::thread::id> destroyedOn{};
+
+    queue.startCollector(std::chrono::milliseconds(1));
+    queue.retire(
+        std::make_shared<DestructionProbe>(&destroyed, &destroyedOn));
+
+    for (int i = 0; i < 1000 && !destroyed.load(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    queue.stopCollector();
+
+    ASSERT_TRUE(destroyed.load());
+    EXPECT_NE(destroyedOn.load(), std::this_thread::get_id());
+}
+
+// Verifies that several threads can retire concurrently without losing
+// anything.
+TEST(ReclaimQueue, AcceptsConcurrentProducers)
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 1000;
+    ReclaimQueue queue(kThreads * kPerThread);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        producers.emplace_back(
+            [&queue]
+            {
+                for (int i = 0; i < kPerThread; ++i)
+                    queue.retire(std::make_shared<int>(i));
+            });
+    }
+    for (auto &producer : producers)
+        producer.join();
+
+    EXPECT_EQ(queue.collect(), static_cast<size_t>(kThreads * kPerThread));
+    EXPECT_EQ(queue.overflowCount(), 0u);
+}
+
+// Verifies that the mixer hands finished units to the queue instead of
+// destroying them during render().
+TEST(ReclaimQueue, MixerRetiresFinishedUnits)
+{
+    ReclaimQueue queue(16);
+    MixerPlaybackUnit mixer;
+
+    // A unit with no data reports finished on its first block.
+    auto unit = std::make_shared<SamplePlaybackUnit>();
+    std::weak_ptr<SamplePlaybackUnit> watcher = unit;
+    mixer.addUnit(std::move(unit));
+
+    types::RenderContext context;
+    context.reclaim = &queue;
+    std::vector<float> buffer(64 * 2);
+    mixer.render(buffer.data(), 64, 2, context);
+
+    EXPECT_TRUE(mixer.isFinished());
+    EXPECT_FALSE(watcher.expired()) << "Unit was destroyed on render thread";
+
+    queue.collect();
+    EXPECT_TRUE(watcher.expired());
+}
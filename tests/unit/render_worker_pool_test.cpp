@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "mocks/mock_stereo_unit.hpp"
+#include <atomic>
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/playback/render_worker_pool.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    // Records which thread-visible state each task saw.
+    struct TaskLog
+    {
+        std::vector<std::atomic<int>> runs;
+        std::atomic<int> badContexts{0};
+
+        explicit TaskLog(size_t tasks) : runs(tasks) {}
+    };
+
+    void fillWithIndex(void *userData, size_t index, float *output,
+                       unsigned int nFrames, unsigned int channels,
+                       const types::RenderContext &context)
+    {
+        auto *log = static_cast<TaskLog *>(userData);
+        log->runs[index].fetch_add(1);
+
+        // Tasks must get scratch memory of their own and no pool to recurse
+        // into.
+        ScratchArena::Frame frame(context.scratch);
+        if (context.workers != nullptr ||
+            frame.allocate(static_cast<size_t>(nFrames) * channels) == nullptr)
+            log->badContexts.fetch_add(1);
+
+        for (size_t i = 0; i < static_cast<size_t>(nFrames) * channels; ++i)
+            output[i] += static_cast<float>(index + 1);
+    }
+} // namespace
+
+// Verifies that every task of every batch runs exactly once and writes to
+// its own cleared slot.
+TEST(RenderWorkerPool, RunsEveryTaskExactlyOnce)
+{
+    constexpr size_t kTasks = 40;
+    constexpr unsigned int kFrames = 64;
+    RenderWorkerPool pool(3, kTasks, kFrames, 2);
+    EXPECT_EQ(pool.workerCount(), 3u);
+
+    types::RenderContext context;
+    for (int batch = 1; batch <= 50; ++batch)
+    {
+        TaskLog log(kTasks);
+        pool.run(kTasks, &fillWithIndex, &log, context, kFrames, 2);
+
+        EXPECT_EQ(log.badContexts.load(), 0);
+        for (size_t i = 0; i < kTasks; ++i)
+        {
+            ASSERT_EQ(log.runs[i].load(), 1) << "task " << i;
+            // Slots are cleared before each task, so nothing accumulates
+            // across batches.
+            EXPECT_EQ(pool.slot(i)[0], static_cast<float>(i + 1));
+            EXPECT_EQ(pool.slot(i)[kFrames * 2 - 1], static_cast<float>(i + 1));
+        }
+    }
+}
+
+// Verifies that a pool without workers still renders on the calling thread.
+TEST(RenderWorkerPool, RunsOnCallerWithoutWorkers)
+{
+    RenderWorkerPool pool(0, 4, 16, 2);
+
+    TaskLog log(4);
+    pool.run(4, &fillWithIndex, &log, types::RenderContext{}, 16, 2);
+
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_EQ(log.runs[i].load(), 1);
+    EXPECT_EQ(pool.slot(3)[0], 4.0f);
+}
+
+// Verifies that, when realtime priority is required, workers refused it
+// take no tasks and the caller renders their share.
+TEST(RenderWorkerPool, WorkersWithoutRealtimePrioritySitOut)
+{
+    RenderWorkerPool relaxed(2, 8, 16, 2);
+    EXPECT_EQ(relaxed.activeWorkerCount(), 2u);
+
+    // Whether the OS grants the priority depends on the machine, so check
+    // both outcomes.
+    RenderWorkerPool pool(2, 8, 16, 2, false, true);
+    EXPECT_EQ(pool.workerCount(), 2u);
+    EXPECT_LE(pool.activeWorkerCount(), 2u);
+    EXPECT_EQ(pool.canRun(8, 16, 2), pool.activeWorkerCount() > 0);
+
+    for (int batch = 0; batch < 20; ++batch)
+    {
+        TaskLog log(8);
+        pool.run(8, &fillWithIndex, &log, types::RenderContext{}, 16, 2);
+        for (size_t i = 0; i < 8; ++i)
+            ASSERT_EQ(log.runs[i].load(), 1) << "task " << i;
+    }
+}
+
+// Verifies that batches that do not fit the preallocated slots are refused.
+TEST(RenderWorkerPool, RejectsShapesItWasNotSizedFor)
+{
+    RenderWorkerPool pool(1, 8, 128, 2);
+    EXPECT_TRUE(pool.canRun(8, 128, 2));
+    EXPECT_FALSE(pool.canRun(9, 128, 2));
+    EXPECT_FALSE(pool.canRun(8, 256, 2));
+    EXPECT_FALSE(pool.canRun(8, 128, 1));
+
+    EXPECT_THROW(RenderWorkerPool(1, 0, 128, 2), std::invalid_argument);
+    EXPECT_THROW(RenderWorkerPool(1, 8, 0, 2), std::invalid_argument);
+}
+
+// Verifies that a mixer spread across workers produces exactly the same mix
+// as one rendered on a single thread.
+TEST(RenderWorkerPool, ParallelMixerMatchesSerialMix)
+{
+    constexpr unsigned int kFrames = 256;
+    RenderWorkerPool pool(3, MixerPlaybackUnit::kMaxUnits, kFrames, 2);
+    MixerPlaybackUnit serial;
+    MixerPlaybackUnit parallel;
+
+    for (int i = 0; i < 12; ++i)
+    {
+        for (MixerPlaybackUnit *mixer : {&serial, &parallel})
+        {
+            auto unit = std::make_shared<MockStereoUnit>();
+            unit->leftValue = 0.1f * static_cast<float>(i + 1);
+            unit->rightValue = -0.03f * static_cast<float>(i);
+            mixer->addUnit(unit);
+        }
+    }
+
+    std::vector<float> expected(kFrames * 2);
+    std::vector<float> actual(kFrames * 2);
+    types::RenderContext serialContext;
+    types::RenderContext parallelContext;
+    parallelContext.workers = &pool;
+
+    for (int block = 0; block < 3; ++block)
+    {
+        serial.render(expected.data(), kFrames, 2, serialContext);
+        parallel.render(actual.data(), kFrames, 2, parallelContext);
+        ASSERT_EQ(actual, expected);
+    }
+    EXPECT_NE(expected[0], 0.0f);
+}
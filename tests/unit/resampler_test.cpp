@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <dtracker/audio/dsp/resampler.hpp>
+#include <vector>
+
+using namespace dtracker::audio::dsp;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    // A stereo sine, with the right channel at half the level.
+    std::vector<float> stereoSine(size_t frames, double cyclesPerFrame)
+    {
+        std::vector<float> samples(frames * 2);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const float value =
+                static_cast<float>(std::sin(2.0 * kPi * cyclesPerFrame * i));
+            samples[i * 2] = value;
+            samples[i * 2 + 1] = 0.5f * value;
+        }
+        return samples;
+    }
+
+    class ResamplerTest : public ::testing::TestWithParam<ResampleQuality>
+    {
+    };
+} // namespace
+
+// Verifies that reading at a step of one reproduces a sine well inside the
+// passband, whatever the quality. The ends are left out: there the sinc
+// filter reaches past the source and reads silence.
+TEST_P(ResamplerTest, UnitStepCopiesTheSource)
+{
+    const auto source = stereoSine(64, 0.03);
+    std::vector<float> out(64 * 2, 0.0f);
+    double position = 0.0;
+
+    EXPECT_EQ(resampleStereo(out.data(), 64, source.data(), 64, position, 1.0,
+                             1.0f, 1.0f, GetParam()),
+              64u);
+    EXPECT_DOUBLE_EQ(position, 64.0);
+    for (size_t i = 32; i < 96; ++i)
+        EXPECT_NEAR(out[i], source[i], 1e-5f) << i;
+}
+
+// Verifies that a sine read at another rate comes out as the same pitch at
+// the new rate, at the same level on both channels.
+TEST_P(ResamplerTest, KeepsPitchAcrossRates)
+{
+    // 1 kHz recorded at 44.1 kHz, played on a 48 kHz stream.
+    constexpr double kStep = 44100.0 / 48000.0;
+    const auto source = stereoSine(2048, 1000.0 / 44100.0);
+    std::vector<float> out(1024 * 2, 0.25f);
+    double position = 0.0;
+
+    ASSERT_EQ(resampleStereo(out.data(), 1024, source.data(), 2048, position,
+                             kStep, 1.0f, 2.0f, GetParam()),
+              1024u);
+    EXPECT_NEAR(position, 1024 * kStep, 1e-9);
+
+    const float tolerance =
+        GetParam() == ResampleQuality::Linear ? 5e-3f : 1e-3f;
+    for (size_t i = 16; i < 1024; ++i)
+    {
+        const float expected =
+            static_cast<float>(std::sin(2.0 * kPi * 1000.0 * i / 48000.0));
+        EXPECT_NEAR(out[i * 2], 0.25f + expected, tolerance) << i;
+        EXPECT_NEAR(out[i * 2 + 1], 0.25f + expected, tolerance) << i;
+    }
+}
+
+// Verifies that reading stops at the end of the source.
+TEST_P(ResamplerTest, StopsAtTheEnd)
+{
+    const std::vector<float> source(10 * 2, 1.0f);
+    std::vector<float> out(16 * 2, 0.0f);
+    double position = 4.0;
+
+    EXPECT_EQ(resampleStereo(out.data(), 16, source.data(), 10, position,
+                             2.0, 1.0f, 1.0f, GetParam()),
+              3u);
+    EXPECT_DOUBLE_EQ(position, 10.0);
+    EXPECT_EQ(out[6], 0.0f);
+}
+
+namespace
+{
+    // The highest magnitude on the left channel between two frames.
+    float peakBetween(const std::vector<float> &samples, size_t begin,
+                      size_t end)
+    {
+        float peak = 0.0f;
+        for (size_t i = begin; i < end; ++i)
+            peak = std::max(peak, std::fabs(samples[i * 2]));
+        return peak;
+    }
+} // namespace
+
+// Verifies that the sinc filter band-limits to the output's rate when
+// downsampling: a tone above the output's Nyquist frequency is filtered
+// out instead of folding back, while one well inside it passes.
+TEST(SincResampler, DownsamplingFiltersAboveTheTargetNyquist)
+{
+    // 96 kHz read onto a 44.1 kHz stream.
+    constexpr double kStep = 96000.0 / 44100.0;
+    for (const double tone : {35000.0, 40000.0})
+    {
+        const auto source = stereoSine(4096, tone / 96000.0);
+        std::vector<float> out(1024 * 2, 0.0f);
+        double position = 0.0;
+        ASSERT_EQ(resampleStereo(out.data(), 1024, source.data(), 4096,
+                                 position, kStep, 1.0f, 1.0f,
+                                 ResampleQuality::Sinc),
+                  1024u);
+        EXPECT_LT(peakBetween(out, 64, 1024), 0.01f) << tone;
+    }
+
+    const auto source = stereoSine(4096, 5000.0 / 96000.0);
+    std::vector<float> out(1024 * 2, 0.0f);
+    double position = 0.0;
+    resampleStereo(out.data(), 1024, source.data(), 4096, position, kStep,
+                   1.0f, 1.0f, ResampleQuality::Sinc);
+    EXPECT_NEAR(peakBetween(out, 64, 1024), 1.0f, 0.01f);
+}
+
+// Verifies that steps past the largest stretch still read the source at
+// the right pace and pass DC at unity gain.
+TEST(SincResampler, ClampsTheStretchAtLargeSteps)
+{
+    const std::vector<float> source(2000 * 2, 0.5f);
+    std::vector<float> out(100 * 2, 0.0f);
+    double position = 0.0;
+    EXPECT_EQ(resampleStereo(out.data(), 100, source.data(), 2000, position,
+                             12.0, 1.0f, 1.0f, ResampleQuality::Sinc),
+              100u);
+    EXPECT_DOUBLE_EQ(position, 1200.0);
+    for (size_t i = 20; i < 100; ++i)
+        EXPECT_NEAR(out[i * 2], 0.5f, 1e-4f) << i;
+}
+
+INSTANTIATE_TEST_SUITE_P(AllQualities, ResamplerTest,
+                         ::testing::Values(ResampleQuality::Linear,
+                                           ResampleQuality::Cubic,
+                                           ResampleQuality::Sinc),
+                         [](const auto &info)
+                         {
+                             switch (info.param)
+                             {
+                             case ResampleQuality::Linear:
+                                 return "Linear";
+                             case ResampleQuality::Cubic:
+                                 return "Cubic";
+                             default:
+                                 return "Sinc";
+                             }
+                         });
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/rt_log.hpp>
+#include <dtracker/audio/types.hpp>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "mocks/mock_playback_unit.hpp"
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+// Verifies that records are only turned into text when flushed, and that
+// warnings go to the error stream.
+TEST(RtLog, FormatsRecordsWhenFlushed)
+{
+    RtLog log(8);
+    EXPECT_TRUE(log.write(LogLevel::Info, "Test", "{} of {} done", 512, 3,
+                          4));
+    EXPECT_TRUE(log.write(LogLevel::Warning, "Test", "late by", 1024, -7));
+
+    std::ostringstream out;
+    std::ostringstream errors;
+    EXPECT_EQ(log.flush(out, errors), 2u);
+    EXPECT_EQ(out.str(), "Test [info @512]: 3 of 4 done\n");
+    EXPECT_EQ(errors.str(), "Test [warning @1024]: late by -7\n");
+
+    // Everything was consumed.
+    EXPECT_EQ(log.flush(out, errors), 0u);
+}
+
+// Verifies that a full ring drops records, counts them and reports the drop
+// on the next flush.
+TEST(RtLog, CountsDroppedRecords)
+{
+    RtLog log(2);
+    EXPECT_TRUE(log.write(LogLevel::Error, "Test", "a", 0));
+    EXPECT_TRUE(log.write(LogLevel::Error, "Test", "b", 0));
+    EXPECT_FALSE(log.write(LogLevel::Error, "Test", "c", 0));
+    EXPECT_EQ(log.droppedCount(), 1u);
+
+    std::ostringstream out;
+    EXPECT_EQ(log.flush(out), 2u);
+    EXPECT_NE(out.str().find("1 records dropped"), std::string::npos);
+}
+
+// Verifies that records below the level are discarded at write().
+TEST(RtLog, FiltersByLevel)
+{
+    RtLog log(8);
+    log.setLevel(LogLevel::Warning);
+    EXPECT_FALSE(log.write(LogLevel::Info, "Test", "quiet", 0));
+    EXPECT_EQ(log.droppedCount(), 0u);
+
+    std::ostringstream out;
+    EXPECT_EQ(log.flush(out), 0u);
+}
+
+// Verifies that several threads can write at once and every record arrives.
+TEST(RtLog, AcceptsConcurrentWriters)
+{
+    constexpr int kThreads = 4;
+    constexpr int kRecords = 200;
+    RtLog log(kThreads * kRecords);
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+        writers.emplace_back(
+            [&log, t]
+            {
+                for (int i = 0; i < kRecords; ++i)
+                    log.write(LogLevel::Info, "Test", "{}", i, t);
+            });
+    for (auto &writer : writers)
+        writer.join();
+
+    std::ostringstream out;
+    EXPECT_EQ(log.flush(out), static_cast<size_t>(kThreads * kRecords));
+    EXPECT_EQ(log.droppedCount(), 0u);
+}
+
+// Verifies that the mixer logs a finished unit through the context instead
+// of printing from the render path.
+TEST(RtLog, MixerLogsFinishedUnits)
+{
+    RtLog log(8);
+    MixerPlaybackUnit mixer;
+    auto unit = std::make_shared<MockPlaybackUnit>();
+    unit->finishedAfterRender = true;
+    mixer.addUnit(unit);
+
+    types::RenderContext context;
+    context.log = &log;
+    context.frame = 256;
+    std::vector<float> buffer(64 * 2);
+    mixer.render(buffer.data(), 64, 2, context);
+
+    std::ostringstream out;
+    EXPECT_EQ(log.flush(out), 1u);
+    EXPECT_EQ(out.str(),
+              "MixerPlaybackUnit [info @256]: unit finished, erasing "
+              "(0 left)\n");
+}
@@ -124,3 +124,42 @@ TEST_F(CacheTest, StoresAndRetrievesProperties)
     EXPECT_EQ(retrievedEntry->properties.bitDepth, 24);
     EXPECT_EQ(retrievedEntry->properties.numChannels, 1);
 }
+
+// Verifies that a variant is only stored against the data it was made from,
+// and is dropped when that data is replaced.
+TEST_F(CacheTest, VariantsFollowTheirSourceData)
+{
+    auto original = makePCM(1.0f);
+    cache.insert("sample1", original, {48000, 16, 2});
+    EXPECT_EQ(cache.getVariant("sample1", 44100), nullptr);
+
+    EXPECT_TRUE(cache.insertVariant("sample1", 44100, makePCM(1.5f, 2),
+                                    original));
+    auto variant = cache.getVariant("sample1", 44100);
+    ASSERT_NE(variant, nullptr);
+    EXPECT_EQ(variant->size(), 2u);
+    EXPECT_EQ(cache.getVariant("sample1", 96000), nullptr);
+
+    cache.insert("sample1", makePCM(2.0f), {48000, 16, 2});
+    EXPECT_EQ(cache.getVariant("sample1", 44100), nullptr);
+    EXPECT_FALSE(cache.insertVariant("sample1", 44100, makePCM(1.5f, 2),
+                                     original));
+    EXPECT_FALSE(
+        cache.insertVariant("missing", 44100, makePCM(1.5f, 2), original));
+}
+
+// Verifies that retaining one rate drops every other rate's variants and
+// leaves the entries themselves alone.
+TEST_F(CacheTest, RetainVariantsDropsOtherRates)
+{
+    auto original = makePCM(1.0f);
+    cache.insert("sample1", original, {48000, 16, 2});
+    cache.insertVariant("sample1", 44100, makePCM(1.5f, 2), original);
+    cache.insertVariant("sample1", 96000, makePCM(1.5f, 8), original);
+
+    cache.retainVariants(96000);
+    EXPECT_EQ(cache.getVariant("sample1", 44100), nullptr);
+    EXPECT_NE(cache.getVariant("sample1", 96000), nullptr);
+    EXPECT_EQ(cache.peek("sample1")->variants.size(), 1u);
+    EXPECT_EQ(cache.get("sample1"), original);
+}
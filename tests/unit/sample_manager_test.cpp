@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
 #include <dtracker/sample/manager.hpp>
 #include <memory>
 #include <string>
@@ -156,3 +157,118 @@ TEST(SampleManager, IsThreadSafe)
     EXPECT_EQ(manager.getAllSampleIds().size(),
               num_threads * samples_per_thread);
 }
+
+// Verifies that a sample recorded at another rate is handed out converted
+// once its conversion is done, with the metadata of the converted copy.
+TEST(SampleManager, ConvertsSamplesToTheTargetRate)
+{
+    dtracker::sample::Manager manager;
+    manager.setTargetSampleRate(24000);
+
+    auto data = std::make_shared<const dtracker::audio::types::PCMData>(
+        1000 * 2, 0.5f);
+    int converted = manager.addSample("48k", data, {48000, 24});
+    int native = manager.addSample(
+        "24k",
+        std::make_shared<const dtracker::audio::types::PCMData>(100 * 2,
+                                                                0.5f),
+        {24000, 16});
+    manager.waitForConversions();
+
+    auto sample = manager.getSample(converted);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_EQ(sample->metadata().sourceSampleRate, 24000u);
+    EXPECT_EQ(sample->metadata().bitDepth, 24u);
+    ASSERT_EQ(sample->pcmData()->size(), 500u * 2);
+    // A constant signal stays constant away from the edges.
+    EXPECT_NEAR((*sample->pcmData())[500], 0.5f, 1e-3f);
+
+    // A sample already at the target rate is handed out as it is.
+    auto same = manager.getSample(native);
+    ASSERT_TRUE(same.has_value());
+    EXPECT_EQ(same->pcmData()->size(), 100u * 2);
+
+    // The original stays in the cache.
+    EXPECT_EQ(manager.peekCache("48k")->data, data);
+}
+
+// Verifies that samples cached before the rate changes play at their own
+// rate and are converted lazily, the first time they are asked for.
+TEST(SampleManager, ConvertsCachedSamplesAfterARateChange)
+{
+    dtracker::sample::Manager manager;
+    auto data = std::make_shared<const dtracker::audio::types::PCMData>(
+        400 * 2, 0.25f);
+    int id = manager.addSample("sample", data, {44100, 16});
+
+    manager.setTargetSampleRate(22050);
+    auto first = manager.getSample(id);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->pcmData(), data);
+    EXPECT_EQ(first->metadata().sourceSampleRate, 44100u);
+
+    manager.waitForConversions();
+    auto second = manager.getSample(id);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->metadata().sourceSampleRate, 22050u);
+    EXPECT_EQ(second->pcmData()->size(), 200u * 2);
+
+    // Without a target rate, samples are handed out unconverted again, and
+    // the copy made for the old rate is dropped.
+    manager.setTargetSampleRate(0);
+    EXPECT_EQ(manager.getSample(id)->pcmData(), data);
+    EXPECT_TRUE(manager.peekCache("sample")->variants.empty());
+}
+
+// Verifies that switching rates keeps only the copy for the current rate.
+TEST(SampleManager, DropsCopiesForEarlierRates)
+{
+    dtracker::sample::Manager manager;
+    manager.setTargetSampleRate(22050);
+    int id = manager.addSample(
+        "sample",
+        std::make_shared<const dtracker::audio::types::PCMData>(400 * 2,
+                                                                0.25f),
+        {44100, 16});
+    manager.waitForConversions();
+
+    manager.setTargetSampleRate(11025);
+    manager.getSample(id);
+    manager.waitForConversions();
+
+    auto entry = manager.peekCache("sample");
+    ASSERT_TRUE(entry.has_value());
+    ASSERT_EQ(entry->variants.size(), 1u);
+    EXPECT_EQ(entry->variants.begin()->first, 11025u);
+}
+
+// Verifies that converting down to a lower rate filters out what the new
+// rate cannot hold, so the cached copy does not carry aliasing.
+TEST(SampleManager, ConvertedCopiesDoNotAlias)
+{
+    dtracker::sample::Manager manager;
+    manager.setTargetSampleRate(44100);
+
+    // 35 kHz at 96 kHz would fold to 9.1 kHz at 44.1 kHz.
+    constexpr double kPi = 3.14159265358979323846;
+    dtracker::audio::types::PCMData pcm(8192 * 2);
+    for (size_t i = 0; i < pcm.size(); ++i)
+        pcm[i] = static_cast<float>(std::sin(2.0 * kPi * 35000.0 *
+                                             static_cast<double>(i / 2) /
+                                             96000.0));
+    int id = manager.addSample(
+        "tone",
+        std::make_shared<const dtracker::audio::types::PCMData>(
+            std::move(pcm)),
+        {96000, 24});
+    manager.waitForConversions();
+
+    auto sample = manager.getSample(id);
+    ASSERT_TRUE(sample.has_value());
+    ASSERT_EQ(sample->metadata().sourceSampleRate, 44100u);
+    const auto &converted = *sample->pcmData();
+    float peak = 0.0f;
+    for (size_t i = 128; i + 128 < converted.size(); ++i)
+        peak = std::max(peak, std::fabs(converted[i]));
+    EXPECT_LT(peak, 0.01f);
+}
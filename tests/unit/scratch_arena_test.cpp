@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "mocks/mock_stereo_unit.hpp"
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+// Verifies that buffers start on a cache line and do not overlap.
+TEST(ScratchArena, HandsOutAlignedNonOverlappingBuffers)
+{
+    ScratchArena arena;
+    arena.configure(100, 2, 4);
+
+    ScratchArena::Frame frame(&arena);
+    float *a = frame.allocate(200);
+    float *b = frame.allocate(200);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % ScratchArena::kAlignment,
+              0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % ScratchArena::kAlignment,
+              0u);
+    EXPECT_GE(b, a + 200);
+}
+
+// Verifies that a frame gives back everything it borrowed.
+TEST(ScratchArena, FrameReleasesOnScopeExit)
+{
+    ScratchArena arena;
+    arena.configure(64, 2);
+
+    {
+        ScratchArena::Frame outer(&arena);
+        outer.allocate(128);
+        const size_t outerUsed = arena.used();
+
+        {
+            ScratchArena::Frame inner(&arena);
+            inner.allocate(128);
+            EXPECT_GT(arena.used(), outerUsed);
+        }
+        EXPECT_EQ(arena.used(), outerUsed);
+    }
+    EXPECT_EQ(arena.used(), 0u);
+}
+
+// Verifies that an exhausted or missing arena reports failure instead of
+// handing out memory it does not have, and that the arena counts it.
+TEST(ScratchArena, FailsWhenExhaustedOrMissing)
+{
+    ScratchArena arena;
+    arena.configure(64, 2, 1);
+
+    ScratchArena::Frame frame(&arena);
+    EXPECT_NE(frame.allocate(128), nullptr);
+    EXPECT_EQ(frame.allocate(1), nullptr);
+    EXPECT_EQ(arena.overflowCount(), 1u);
+
+    ScratchArena::Frame none(nullptr);
+    EXPECT_EQ(none.allocate(1), nullptr);
+}
+
+// Verifies that the default renderAdd() borrows its temp buffer from the
+// context's arena and gives it back.
+TEST(ScratchArena, DefaultRenderAddBorrowsFromContext)
+{
+    MockStereoUnit unit;
+    unit.leftValue = 0.5f;
+    unit.rightValue = 0.25f;
+
+    ScratchArena arena;
+    arena.configure(2, 2);
+    types::RenderContext context;
+    context.scratch = &arena;
+
+    std::vector<float> buffer(4, 1.0f);
+    unit.renderAdd(buffer.data(), 2, 2, context, 2.0f, 2.0f);
+
+    EXPECT_FLOAT_EQ(buffer[0], 2.0f);
+    EXPECT_FLOAT_EQ(buffer[1], 1.5f);
+    EXPECT_EQ(arena.used(), 0u);
+}
+
+// Verifies that the default renderAdd() still renders a whole block when
+// the arena cannot lend it a buffer, and that the arena counts the miss.
+TEST(ScratchArena, DefaultRenderAddCopesWithExhaustedArena)
+{
+    MockStereoUnit unit;
+    unit.leftValue = 0.5f;
+    unit.rightValue = 0.25f;
+
+    ScratchArena arena;
+    arena.configure(2, 2, 1);
+    types::RenderContext context;
+    context.scratch = &arena;
+
+    // Larger than both the arena and the stack buffer it falls back on.
+    const unsigned int frames = 1000;
+    std::vector<float> buffer(frames * 2, 1.0f);
+    unit.renderAdd(buffer.data(), frames, 2, context, 2.0f, 2.0f);
+
+    for (unsigned int i = 0; i < frames; ++i)
+    {
+        SCOPED_TRACE(i);
+        EXPECT_FLOAT_EQ(buffer[i * 2], 2.0f);
+        EXPECT_FLOAT_EQ(buffer[i * 2 + 1], 1.5f);
+    }
+    EXPECT_EQ(arena.overflowCount(), 1u);
+    EXPECT_EQ(arena.used(), 0u);
+}
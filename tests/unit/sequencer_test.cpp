@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "mocks/click_sample.hpp"
+#include <dtracker/audio/playback/polyphony_manager.hpp>
+#include <dtracker/audio/playback/sequenced_track_playback_unit.hpp>
+#include <dtracker/audio/playback/sequencer.hpp>
+#include <dtracker/audio/playback/track_sequencer.hpp>
+#include <dtracker/audio/playback/transport.hpp>
+#include <memory>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+namespace
+{
+    std::shared_ptr<TrackSequencer> makeTrack(std::vector<int> steps,
+                                              UnitPool &pool,
+                                              size_t capacity = 16)
+    {
+        dtracker::tracker::types::ActivePattern pattern;
+        pattern.steps = std::move(steps);
+        return std::make_shared<TrackSequencer>(
+            std::vector<dtracker::tracker::types::ActivePattern>{pattern},
+            clickBlueprint(), &pool, kClickRate, capacity);
+    }
+} // namespace
+
+// Verifies that steps are scheduled only up to the window's end, at their
+// exact frames, and that rests produce no notes.
+TEST(TrackSequencer, SchedulesStepsUpToTheWindow)
+{
+    UnitPool pool(8);
+    auto track = makeTrack({1, -1, 1}, pool);
+
+    track->scheduleUntil(150, 60.0f, false);
+    ASSERT_EQ(track->events().size(), 1u);
+    EXPECT_EQ(track->events().front()->frame, 0u);
+    EXPECT_FALSE(track->hasFinished());
+
+    track->events().pop();
+    track->scheduleUntil(1000, 60.0f, false);
+    ASSERT_EQ(track->events().size(), 1u);
+    EXPECT_EQ(track->events().front()->frame, 200u);
+    EXPECT_TRUE(track->hasFinished());
+    EXPECT_EQ(track->endFrame(), 300u);
+}
+
+// Verifies that a full ring leaves the step to be retried later, without
+// holding a voice for it meanwhile.
+TEST(TrackSequencer, RetriesStepsWhenTheRingIsFull)
+{
+    UnitPool pool(2);
+    auto track = makeTrack({1, 1, 1}, pool, 1);
+
+    track->scheduleUntil(1000, 60.0f, false);
+    ASSERT_EQ(track->events().size(), 1u);
+    EXPECT_NE(pool.acquire(), nullptr); // No voice was taken for the retry
+
+    track->events().pop();
+    track->scheduleUntil(1000, 60.0f, false);
+    ASSERT_EQ(track->events().size(), 1u);
+    EXPECT_EQ(track->events().front()->frame, 100u);
+    EXPECT_FALSE(track->hasFinished());
+}
+
+// Verifies that retrying a step while the ring is full never steals a
+// voice, which would cut off a note for one that cannot be queued.
+TEST(TrackSequencer, FullRingDoesNotStealVoices)
+{
+    UnitPool pool(4);
+    PolyphonyManager polyphony(&pool, 1);
+    auto track = makeTrack({1, 1, 1}, pool, 1);
+    track->setPolyphony(&polyphony, 0);
+
+    for (int pass = 0; pass < 3; ++pass)
+        track->scheduleUntil(1000, 60.0f, false);
+
+    ASSERT_EQ(track->events().size(), 1u);
+    EXPECT_EQ(polyphony.stealCount(), 0u);
+    EXPECT_EQ(polyphony.activeVoices(), 1u);
+}
+
+// Verifies that the player starts scheduled notes on their exact frame,
+// counted from wherever the transport was when it first rendered.
+TEST(SequencedTrackPlaybackUnit, StartsNotesAtTheirExactFrame)
+{
+    UnitPool pool(8);
+    auto track = makeTrack({1, -1, 1}, pool);
+    track->scheduleUntil(1000, 60.0f, false);
+
+    SequencedTrackPlaybackUnit unit(track);
+    types::RenderContext context;
+    context.bpm = 60.0f;
+
+    constexpr unsigned int kBlock = 64;
+    constexpr std::uint64_t kOrigin = 1000;
+    std::vector<float> out(384 * 2, 0.0f);
+    for (unsigned int offset = 0; offset < 384; offset += kBlock)
+    {
+        context.frame = kOrigin + offset;
+        unit.render(out.data() + offset * 2, kBlock, 2, context);
+    }
+
+    EXPECT_EQ(track->origin(), kOrigin);
+    EXPECT_FLOAT_EQ(out[0], 1.0f);
+    EXPECT_FLOAT_EQ(out[10 * 2], 0.0f);
+    EXPECT_FLOAT_EQ(out[199 * 2], 0.0f);
+    EXPECT_FLOAT_EQ(out[200 * 2], 1.0f);
+    EXPECT_FLOAT_EQ(out[209 * 2], 1.0f);
+    EXPECT_FLOAT_EQ(out[210 * 2], 0.0f);
+    EXPECT_TRUE(unit.isFinished());
+}
+
+// Verifies that, offline, the player schedules each block itself, even when
+// the block holds more notes than the ring.
+TEST(SequencedTrackPlaybackUnit, SchedulesItselfOffline)
+{
+    for (unsigned int blockFrames : {512u, 64u})
+    {
+        SCOPED_TRACE(blockFrames);
+        UnitPool pool(8);
+        SequencedTrackPlaybackUnit unit(makeTrack({1, 1, 1, 1}, pool, 1));
+        unit.setSelfScheduling(true);
+
+        types::RenderContext context;
+        context.bpm = 60.0f;
+        std::vector<float> out(512 * 2, 0.0f);
+        for (unsigned int offset = 0; offset < 512; offset += blockFrames)
+        {
+            context.frame = offset;
+            unit.render(out.data() + offset * 2, blockFrames, 2, context);
+        }
+
+        for (unsigned int step : {0u, 100u, 200u, 300u})
+            expectClickAt(out, step);
+        EXPECT_TRUE(unit.isFinished());
+    }
+}
+
+// Verifies that the sequencer keeps a looping track's ring filled ahead of
+// the transport, so every loop plays on time.
+TEST(Sequencer, KeepsLoopingTracksScheduledAhead)
+{
+    UnitPool pool(16);
+    Transport transport;
+    Sequencer sequencer(transport);
+    sequencer.setLookahead(256, kClickRate);
+    sequencer.setBpm(60.0f);
+    sequencer.setLooping(true);
+
+    auto track = makeTrack({1, -1}, pool); // Loops every 200 frames
+    sequencer.addTrack(track);
+    sequencer.stop(); // Drive the passes by hand from here on
+
+    // The first window was filled before the track ever played.
+    EXPECT_EQ(track->events().size(), 2u);
+
+    SequencedTrackPlaybackUnit unit(track);
+    types::RenderContext context;
+    context.bpm = 60.0f;
+    context.isLooping = true;
+
+    constexpr unsigned int kBlock = 64;
+    std::vector<float> out(1024 * 2, 0.0f);
+    for (unsigned int offset = 0; offset < 1024; offset += kBlock)
+    {
+        context.frame = transport.frame();
+        unit.render(out.data() + offset * 2, kBlock, 2, context);
+        transport.advance(kBlock);
+        sequencer.schedule();
+    }
+
+    for (unsigned int loopStart : {0u, 200u, 400u, 600u, 800u, 1000u})
+        expectClickAt(out, loopStart);
+    EXPECT_FALSE(unit.isFinished());
+}
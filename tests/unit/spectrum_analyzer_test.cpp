@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <dtracker/audio/dsp/fft.hpp>
+#include <dtracker/audio/playback/scratch_arena.hpp>
+#include <dtracker/audio/playback/sequenced_track_playback_unit.hpp>
+#include <dtracker/audio/playback/track_sequencer.hpp>
+#include <dtracker/audio/spectrum_analyzer.hpp>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace dtracker::audio;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Writes a sine to a mono tap in engine-sized quanta.
+    void writeSine(playback::WaveformTap &tap, double frequency,
+                   unsigned int sampleRate, unsigned int frames,
+                   float amplitude = 1.0f)
+    {
+        std::vector<float> quantum(128);
+        unsigned int phase = 0;
+        for (unsigned int done = 0; done < frames; done += 128)
+        {
+            for (float &sample : quantum)
+                sample = amplitude *
+                         static_cast<float>(std::sin(
+                             2.0 * kPi * frequency * phase++ / sampleRate));
+            tap.write(quantum.data(), 128, 1);
+        }
+    }
+
+    // The band whose level is highest.
+    size_t loudestBand(const SpectrumFrame &frame)
+    {
+        return std::max_element(frame.bands.begin(), frame.bands.end()) -
+               frame.bands.begin();
+    }
+} // namespace
+
+// Verifies the FFT against a direct DFT, worked out in double.
+TEST(RealFft, MatchesDirectTransform)
+{
+    for (size_t size : {4u, 8u, 64u, 512u})
+    {
+        std::vector<float> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = static_cast<float>(std::sin(i * 0.37) +
+                                          0.5 * std::cos(i * 1.9) - 0.1);
+
+        dsp::RealFft fft(size);
+        ASSERT_EQ(fft.bins(), size / 2 + 1);
+        std::vector<float> real(fft.bins());
+        std::vector<float> imag(fft.bins());
+        fft.forward(input.data(), real.data(), imag.data());
+
+        for (size_t k = 0; k < fft.bins(); ++k)
+        {
+            double expectedReal = 0.0;
+            double expectedImag = 0.0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                const double angle = -2.0 * kPi * k * i / size;
+                expectedReal += input[i] * std::cos(angle);
+                expectedImag += input[i] * std::sin(angle);
+            }
+            EXPECT_NEAR(real[k], expectedReal, 1e-3) << size << " " << k;
+            EXPECT_NEAR(imag[k], expectedImag, 1e-3) << size << " " << k;
+        }
+    }
+}
+
+TEST(RealFft, RejectsSizesThatAreNotPowersOfTwo)
+{
+    EXPECT_THROW(dsp::RealFft(0), std::invalid_argument);
+    EXPECT_THROW(dsp::RealFft(2), std::invalid_argument);
+    EXPECT_THROW(dsp::RealFft(48), std::invalid_argument);
+    EXPECT_NO_THROW(dsp::RealFft(4));
+}
+
+// Verifies that a full-scale sine reads about 0 dB in the band holding its
+// frequency, and that bands far from it stay near silent.
+TEST(SpectrumAnalyzer, FindsASineInItsBand)
+{
+    constexpr unsigned int kRate = 48000;
+    SpectrumAnalyzer analyzer(kRate, 1024, 32);
+    auto tap = std::make_shared<playback::WaveformTap>(1, 256, 32);
+    analyzer.attach(1, tap);
+
+    // Bin 21 of 1024 at 48 kHz, so the window's scalloping is not measured.
+    const double frequency = 21.0 * kRate / 1024.0;
+    writeSine(*tap, frequency, kRate, 4096);
+    EXPECT_EQ(analyzer.analyze(), 13u);
+
+    const SpectrumFrame frame = analyzer.spectrum(1);
+    ASSERT_EQ(frame.bands.size(), 32u);
+    EXPECT_EQ(frame.frames, 13u);
+    // A bin is wider than 20 Hz here, so the bands start at the first one.
+    EXPECT_FLOAT_EQ(frame.minFrequency, 46.875f);
+    EXPECT_FLOAT_EQ(frame.maxFrequency, 24000.0f);
+
+    const size_t band = loudestBand(frame);
+    const float low = frame.minFrequency *
+                      std::pow(frame.maxFrequency / frame.minFrequency,
+                               static_cast<float>(band) / 32.0f);
+    const float high = frame.minFrequency *
+                       std::pow(frame.maxFrequency / frame.minFrequency,
+                                static_cast<float>(band + 1) / 32.0f);
+    EXPECT_LE(low, frequency);
+    EXPECT_GT(high, frequency);
+    EXPECT_NEAR(frame.bands[band], 0.0f, 0.1f);
+    EXPECT_LT(frame.bands.back(), -60.0f);
+}
+
+// Verifies that bands fall back gradually once the signal stops.
+TEST(SpectrumAnalyzer, BandsFallBackAfterSilence)
+{
+    constexpr unsigned int kRate = 48000;
+    SpectrumAnalyzer analyzer(kRate, 1024, 32);
+    auto tap = std::make_shared<playback::WaveformTap>(1, 256, 32);
+    analyzer.attach(1, tap);
+
+    writeSine(*tap, 21.0 * kRate / 1024.0, kRate, 4096);
+    analyzer.analyze();
+    const SpectrumFrame loud = analyzer.spectrum(1);
+    const size_t band = loudestBand(loud);
+
+    // 32 windows of 256 frames fall about 10 dB at 60 dB a second.
+    writeSine(*tap, 0.0, kRate, 8192);
+    analyzer.analyze();
+    const SpectrumFrame quiet = analyzer.spectrum(1);
+    EXPECT_LT(quiet.bands[band], loud.bands[band] - 5.0f);
+    EXPECT_GT(quiet.bands[band], loud.bands[band] - 15.0f);
+}
+
+// Verifies that a source only sees audio published after it was attached,
+// and that a detached source has no spectrum.
+TEST(SpectrumAnalyzer, AttachStartsAtTheNextBlock)
+{
+    SpectrumAnalyzer analyzer(48000, 1024, 16);
+    auto tap = std::make_shared<playback::WaveformTap>(1, 256, 32);
+    writeSine(*tap, 1000.0, 48000, 4096);
+
+    analyzer.attach(7, tap);
+    EXPECT_EQ(analyzer.analyze(), 0u);
+    EXPECT_TRUE(analyzer.spectrum(7).bands.empty());
+
+    writeSine(*tap, 1000.0, 48000, 1024);
+    EXPECT_EQ(analyzer.analyze(), 1u);
+    EXPECT_EQ(analyzer.spectrum(7).bands.size(), 16u);
+
+    analyzer.detach(7);
+    EXPECT_TRUE(analyzer.spectrum(7).bands.empty());
+    EXPECT_TRUE(analyzer.spectrum(8).bands.empty());
+}
+
+// Verifies that a decimating tap is analyzed at its reduced rate.
+TEST(SpectrumAnalyzer, DecimatedTapsStopAtTheirNyquist)
+{
+    SpectrumAnalyzer analyzer(48000, 1024, 16);
+    analyzer.attach(1, std::make_shared<playback::WaveformTap>(2, 128, 32, 4));
+    analyzer.attach(2, std::make_shared<playback::WaveformTap>(2, 128, 32));
+    EXPECT_FLOAT_EQ(analyzer.spectrum(1).maxFrequency, 6000.0f);
+    EXPECT_FLOAT_EQ(analyzer.spectrum(2).maxFrequency, 24000.0f);
+}
+
+// Verifies that a track's spectrum tap sees its full bandwidth: a tone above
+// the scope tap's decimated Nyquist frequency shows up in its own band and
+// does not fold into a lower one.
+TEST(SpectrumAnalyzer, TrackSpectrumKeepsHighTonesInTheirBand)
+{
+    constexpr unsigned int kRate = 44100;
+    constexpr unsigned int kBlock = 128;
+    constexpr double kTone = 8000.0;
+
+    // Half a second of the tone, as a stereo sample at the stream's rate.
+    types::PCMData pcm(kRate);
+    for (size_t i = 0; i < pcm.size(); ++i)
+        pcm[i] = 0.5f * static_cast<float>(
+                            std::sin(2.0 * kPi * kTone * (i / 2) / kRate));
+    playback::SampleBlueprint blueprint;
+    blueprint[1] = dtracker::sample::types::SampleDescriptor(
+        1, std::make_shared<const types::PCMData>(std::move(pcm)),
+        {kRate, 16});
+
+    dtracker::tracker::types::ActivePattern pattern;
+    pattern.steps = {1};
+    playback::UnitPool pool(4);
+    auto sequence = std::make_shared<playback::TrackSequencer>(
+        std::vector<dtracker::tracker::types::ActivePattern>{pattern},
+        std::move(blueprint), &pool, kRate);
+    sequence->scheduleUntil(kRate, 120.0f, false);
+
+    // Wired like PlaybackManager: a peak-decimated scope tap and a
+    // full-rate tap for the analyzer.
+    playback::SequencedTrackPlaybackUnit track(sequence);
+    auto spectrumTap = std::make_shared<playback::WaveformTap>(2);
+    track.setWaveformTap(
+        std::make_shared<playback::WaveformTap>(2, 64, 32, 4));
+    track.setSpectrumTap(spectrumTap);
+
+    SpectrumAnalyzer analyzer(kRate, 2048, 64);
+    analyzer.attach(1, spectrumTap);
+
+    playback::ScratchArena arena;
+    arena.configure(kBlock, 2);
+    types::RenderContext context;
+    context.scratch = &arena;
+    context.bpm = 120.0f;
+    std::vector<float> buffer(kBlock * 2);
+    for (unsigned int frame = 0; frame < 16384; frame += kBlock)
+    {
+        context.frame = frame;
+        track.render(buffer.data(), kBlock, 2, context);
+        analyzer.analyze();
+    }
+
+    const SpectrumFrame frame = analyzer.spectrum(1);
+    ASSERT_EQ(frame.bands.size(), 64u);
+    EXPECT_FLOAT_EQ(frame.maxFrequency, kRate / 2.0f);
+
+    const auto bandOf = [&](double frequency)
+    {
+        return static_cast<size_t>(
+            std::log(frequency / frame.minFrequency) /
+            std::log(frame.maxFrequency / frame.minFrequency) * 64.0);
+    };
+    EXPECT_EQ(loudestBand(frame), bandOf(kTone));
+    // Peak-holding every 4th frame would fold the tone to 3025 Hz.
+    EXPECT_LT(frame.bands[bandOf(kRate / 4.0 - kTone)], -60.0f);
+}
+
+// Verifies that the worker thread analyzes a tap the audio thread is
+// writing, while another thread reads the spectrum.
+TEST(SpectrumAnalyzer, WorkerAnalyzesInTheBackground)
+{
+    SpectrumAnalyzer analyzer(48000, 512, 16);
+    auto tap = std::make_shared<playback::WaveformTap>(1, 256, 32);
+    analyzer.attach(1, tap);
+    analyzer.start(std::chrono::milliseconds(1));
+
+    std::thread writer(
+        [&]
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                writeSine(*tap, 1000.0, 48000, 512);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+    std::uint64_t frames = 0;
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (frames == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        const SpectrumFrame frame = analyzer.spectrum(1);
+        if (!frame.bands.empty())
+        {
+            EXPECT_EQ(frame.bands.size(), 16u);
+        }
+        frames = frame.frames;
+        std::this_thread::yield();
+    }
+    writer.join();
+    analyzer.stop();
+
+    EXPECT_GT(frames, 0u);
+}
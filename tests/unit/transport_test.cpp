@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <dtracker/audio/playback/pattern_playback_unit.hpp>
+#include <dtracker/audio/playback/track_playback_unit.hpp>
+#include <dtracker/audio/playback/transport.hpp>
+#include <dtracker/audio/playback/unit_pool.hpp>
+#include <memory>
+#include <vector>
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+// Verifies that a step length keeps its fraction instead of rounding to
+// whole frames.
+TEST(Transport, StepLengthKeepsFractionalFrames)
+{
+    // 120 BPM, 16th notes at 44.1 kHz: 5512.5 frames per step.
+    const Transport::Time step = Transport::stepLength(44100, 120.0f, 4.0f);
+    EXPECT_EQ(step, Transport::toTime(5512) + (Transport::Time{1} << 31));
+
+    EXPECT_EQ(Transport::stepLength(44100, 0.0f, 4.0f), 0u);
+    EXPECT_EQ(Transport::stepLength(0, 120.0f, 4.0f), 0u);
+}
+
+// Verifies that fractional times round up to the next whole frame.
+TEST(Transport, RoundsTimesUpToWholeFrames)
+{
+    EXPECT_EQ(Transport::frameAtOrAfter(Transport::toTime(10)), 10u);
+    EXPECT_EQ(Transport::frameAtOrAfter(Transport::toTime(10) + 1), 11u);
+    EXPECT_EQ(Transport::frameAtOrAfter(0), 0u);
+}
+
+// Verifies that the clock counts frames past 32 bits.
+TEST(Transport, CountsFramesPastThirtyTwoBits)
+{
+    Transport transport;
+    for (int i = 0; i < 3; ++i)
+        transport.advance(0x80000000u);
+    EXPECT_EQ(transport.frame(), 0x180000000ull);
+
+    transport.reset();
+    EXPECT_EQ(transport.frame(), 0u);
+}
+
+// Verifies that looping patterns of different lengths stay locked to the
+// transport: after thousands of loops, each loop still ends on an exact
+// multiple of its length, fraction included.
+TEST(Transport, LoopingTracksStayPhaseLocked)
+{
+    dtracker::tracker::types::ActivePattern threeSteps;
+    threeSteps.steps = {-1, -1, -1};
+    dtracker::tracker::types::ActivePattern fiveSteps;
+    fiveSteps.steps = {-1, -1, -1, -1, -1};
+
+    UnitPool pool(1);
+    SampleBlueprint blueprint;
+    std::vector<PatternPlaybackUnit *> patterns;
+    std::vector<std::unique_ptr<TrackPlaybackUnit>> tracks;
+    for (const auto *pattern : {&threeSteps, &fiveSteps})
+    {
+        auto unit = std::make_unique<PatternPlaybackUnit>(*pattern, blueprint,
+                                                          &pool, 44100);
+        patterns.push_back(unit.get());
+        tracks.push_back(std::make_unique<TrackPlaybackUnit>());
+        tracks.back()->addUnit(std::move(unit));
+    }
+
+    types::RenderContext context;
+    context.isLooping = true;
+    context.bpm = 133.0f; // A step that is nowhere near a whole frame
+
+    // Roughly ten minutes at 44.1 kHz, in odd-sized blocks.
+    constexpr unsigned int kBlock = 4093;
+    std::vector<float> buffer(kBlock * 2);
+    Transport transport;
+    for (int block = 0; block < 6500; ++block)
+    {
+        context.frame = transport.frame();
+        for (auto &track : tracks)
+            track->render(buffer.data(), kBlock, 2, context);
+        transport.advance(kBlock);
+    }
+
+    const Transport::Time step = Transport::stepLength(44100, 133.0f, 4.0f);
+    context.frame = transport.frame();
+    EXPECT_EQ(patterns[0]->loopEndTime(context) % (3 * step), 0u);
+    EXPECT_EQ(patterns[1]->loopEndTime(context) % (5 * step), 0u);
+    EXPECT_GT(patterns[0]->loopEndTime(context),
+              Transport::toTime(transport.frame()));
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <dtracker/audio/playback/pattern_playback_unit.hpp>
+#include <dtracker/audio/playback/reclaim_queue.hpp>
 #include <dtracker/audio/playback/unit_pool.hpp>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -100,4 +103,85 @@ TEST(UnitPool, IsThreadSafe)
     // We should acquire exactly the number of objects the pool started
     // with. This proves no objects were lost or duplicated during the test.
     EXPECT_EQ(final_acquire.size(), pool_size);
-}
\ No newline at end of file
+}
+
+// Verifies that a move-only handle carries the unit and returns it exactly
+// once, from whichever handle holds it last.
+TEST(UnitPool, HandleMovesOwnership)
+{
+    dtracker::audio::playback::UnitPool pool(1);
+
+    auto first = pool.acquire();
+    ASSERT_NE(first, nullptr);
+    auto *unit = first.get();
+
+    auto second = std::move(first);
+    EXPECT_EQ(first, nullptr);
+    EXPECT_EQ(second.get(), unit);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    const auto generation = pool.generation(unit);
+    second.reset();
+    EXPECT_NE(pool.generation(unit), generation);
+    EXPECT_EQ(pool.acquire().get(), unit);
+}
+
+// Verifies that a finished note goes straight back to the pool on the render
+// thread without keeping its sample alive there, and without freeing it
+// mid-callback: the reference goes to the reclaim queue instead.
+TEST(UnitPool, PatternReleasesNotesThroughReclaimQueue)
+{
+    using namespace dtracker::audio;
+
+    auto pcm = std::make_shared<const types::PCMData>(16, 0.5f);
+    playback::SampleBlueprint blueprint;
+    blueprint[0] = dtracker::sample::types::SampleDescriptor(0, pcm, {});
+
+    dtracker::tracker::types::ActivePattern pattern;
+    pattern.steps = {0};
+
+    playback::ReclaimQueue reclaim;
+    playback::UnitPool pool(1);
+    pool.setReclaimQueue(&reclaim);
+    playback::PatternPlaybackUnit unit(pattern, blueprint, &pool, 44100);
+
+    // Render until the single short note has played out, moving the
+    // transport along like the engine does.
+    types::RenderContext context;
+    std::vector<float> buffer(512 * 2);
+    for (int i = 0; i < 100 && !unit.isFinished(); ++i)
+    {
+        unit.render(buffer.data(), 512, 2, context);
+        context.frame += 512;
+    }
+    ASSERT_TRUE(unit.isFinished());
+
+    // The idle voice no longer holds the sample; the queue does, alongside
+    // the test and the two blueprints (ours and the pattern's).
+    auto voice = pool.acquire();
+    ASSERT_NE(voice, nullptr);
+    EXPECT_EQ(pcm.use_count(), 4);
+
+    // The collector lets go of it off the audio thread, even though the
+    // voice is checked out again.
+    EXPECT_EQ(reclaim.collect(), 1u);
+    EXPECT_EQ(pcm.use_count(), 3);
+}
+
+// Verifies that without a reclaim queue a released unit drops its sample in
+// place, so an evicted sample is freed even while the pool sits idle.
+TEST(UnitPool, ReleaseDropsSampleWithoutReclaimQueue)
+{
+    using namespace dtracker::audio;
+
+    auto pcm = std::make_shared<const types::PCMData>(16, 0.5f);
+    playback::UnitPool pool(1);
+
+    auto voice = pool.acquire();
+    ASSERT_NE(voice, nullptr);
+    voice->reinitialize(dtracker::sample::types::SampleDescriptor(0, pcm, {}));
+    EXPECT_EQ(pcm.use_count(), 2);
+
+    voice.reset();
+    EXPECT_EQ(pcm.use_count(), 1);
+}
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <dtracker/audio/playback/level_meter.hpp>
+#include <dtracker/audio/playback/mixer_playback.hpp>
+#include <dtracker/audio/playback/waveform_tap.hpp>
+#include <dtracker/audio/types.hpp>
+#include <thread>
+#include <vector>
+
+#include "mocks/mock_playback_unit.hpp"
+
+using namespace dtracker::audio;
+using namespace dtracker::audio::playback;
+
+// Verifies that blocks are only published once full, whatever size the
+// writes come in, and that samples arrive in order.
+TEST(WaveformTap, PublishesOnlyFullBlocks)
+{
+    auto tap = std::make_shared<WaveformTap>(1, 4, 4);
+    WaveformTap::Reader reader(tap);
+    std::vector<float> block;
+
+    const float first[3] = {1.0f, 2.0f, 3.0f};
+    tap->write(first, 3, 1);
+    EXPECT_EQ(tap->publishedBlocks(), 0u);
+    EXPECT_FALSE(reader.read(block));
+
+    const float second[6] = {4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+    tap->write(second, 6, 1);
+    EXPECT_EQ(tap->publishedBlocks(), 2u);
+
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block, (std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f}));
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block, (std::vector<float>{5.0f, 6.0f, 7.0f, 8.0f}));
+    EXPECT_FALSE(reader.read(block));
+    EXPECT_EQ(reader.skippedBlocks(), 0u);
+}
+
+// Verifies that audio with the wrong channel count is ignored rather than
+// misread as interleaved frames.
+TEST(WaveformTap, IgnoresMismatchedChannels)
+{
+    WaveformTap tap(2, 2, 2);
+    const float mono[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    tap.write(mono, 4, 1);
+    EXPECT_EQ(tap.publishedBlocks(), 0u);
+}
+
+// Verifies that a reader that falls behind skips to the oldest intact block
+// and counts what it missed, while the writer never waits.
+TEST(WaveformTap, LaggingReaderSkipsAhead)
+{
+    auto tap = std::make_shared<WaveformTap>(1, 2, 4);
+    WaveformTap::Reader reader(tap);
+    for (int i = 0; i < 10; ++i)
+    {
+        const float frames[2] = {static_cast<float>(i), static_cast<float>(i)};
+        tap->write(frames, 2, 1);
+    }
+    EXPECT_EQ(tap->publishedBlocks(), 10u);
+
+    // Only the three blocks before the newest slot are left intact.
+    std::vector<float> block;
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block[0], 7.0f);
+    EXPECT_EQ(reader.skippedBlocks(), 7u);
+
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block[0], 8.0f);
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block[0], 9.0f);
+    EXPECT_FALSE(reader.read(block));
+}
+
+// Verifies that a decimating tap keeps the loudest sample of each group of
+// frames per channel, carrying partial groups across writes.
+TEST(WaveformTap, DecimationKeepsPeaks)
+{
+    auto tap = std::make_shared<WaveformTap>(2, 2, 4, 3);
+    WaveformTap::Reader reader(tap);
+    const float first[8] = {0.1f, 0.0f, -0.9f, 0.2f, 0.3f, -0.4f, 0.5f, 0.0f};
+    tap->write(first, 4, 2);
+    EXPECT_EQ(tap->publishedBlocks(), 0u);
+
+    const float second[4] = {0.0f, 0.6f, 0.2f, 0.1f};
+    tap->write(second, 2, 2);
+
+    std::vector<float> block;
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block, (std::vector<float>{-0.9f, -0.4f, 0.5f, 0.6f}));
+}
+
+// Verifies that discarding abandons the unfinished block and counts the gap
+// once, however long it lasts.
+TEST(WaveformTap, DiscardDropsThePartialBlock)
+{
+    auto tap = std::make_shared<WaveformTap>(1, 4, 4);
+    WaveformTap::Reader reader(tap);
+    const float frames[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    tap->write(frames, 2, 1);
+    tap->discard();
+    tap->discard();
+    EXPECT_EQ(tap->droppedBlocks(), 1u);
+
+    tap->write(frames, 4, 1);
+    std::vector<float> block;
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block, (std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f}));
+
+    tap->discard();
+    EXPECT_EQ(tap->droppedBlocks(), 2u);
+}
+
+// Verifies that the mixer feeds the tap it was given with the mixed output.
+TEST(WaveformTap, MixerWritesRenderedBlocks)
+{
+    auto tap = std::make_shared<WaveformTap>(2, 4, 4);
+    WaveformTap::Reader reader(tap);
+    MixerPlaybackUnit mixer;
+    mixer.setWaveformTap(tap.get());
+
+    auto unit = std::make_shared<MockPlaybackUnit>();
+    unit->fillValue = 0.5f;
+    mixer.addUnit(unit);
+
+    std::vector<float> buffer(8 * 2);
+    types::RenderContext context;
+    mixer.render(buffer.data(), 8, 2, context);
+
+    EXPECT_EQ(tap->publishedBlocks(), 2u);
+    std::vector<float> block;
+    ASSERT_TRUE(reader.read(block));
+    EXPECT_EQ(block, std::vector<float>(buffer.begin(), buffer.begin() + 8));
+
+    // Once detached, rendering no longer touches the tap.
+    mixer.setWaveformTap(nullptr);
+    mixer.render(buffer.data(), 8, 2, context);
+    EXPECT_EQ(tap->publishedBlocks(), 2u);
+}
+
+// Verifies that readers each see every block, whenever they read, and that
+// a new reader starts with the next block published.
+TEST(WaveformTap, ReadersDoNotStealBlocksFromEachOther)
+{
+    auto tap = std::make_shared<WaveformTap>(1, 2, 8);
+    WaveformTap::Reader scope(tap);
+    WaveformTap::Reader meter(tap);
+
+    const float frames[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    tap->write(frames, 2, 1);
+
+    std::vector<float> block;
+    ASSERT_TRUE(scope.read(block));
+    EXPECT_EQ(block, (std::vector<float>{1.0f, 2.0f}));
+    EXPECT_FALSE(scope.read(block));
+
+    WaveformTap::Reader recorder(tap);
+    tap->write(frames + 2, 2, 1);
+
+    ASSERT_TRUE(meter.read(block));
+    EXPECT_EQ(block, (std::vector<float>{1.0f, 2.0f}));
+    ASSERT_TRUE(meter.read(block));
+    EXPECT_EQ(block, (std::vector<float>{3.0f, 4.0f}));
+    ASSERT_TRUE(recorder.read(block));
+    EXPECT_EQ(block, (std::vector<float>{3.0f, 4.0f}));
+    ASSERT_TRUE(scope.read(block));
+    EXPECT_EQ(block, (std::vector<float>{3.0f, 4.0f}));
+
+    // A copy carries on from where the original is.
+    WaveformTap::Reader copy = scope;
+    EXPECT_FALSE(copy.read(block));
+
+    // A reader without a tap is never handed anything.
+    WaveformTap::Reader detached;
+    EXPECT_EQ(detached.tap(), nullptr);
+    EXPECT_FALSE(detached.read(block));
+}
+
+// Verifies that readers racing the writer only ever see whole blocks, and
+// that each of them sees or counts every block on its own. Every sample of
+// block n is n, so a torn copy shows up as mixed values.
+TEST(WaveformTap, ConcurrentReadersNeverSeeTornBlocks)
+{
+    constexpr unsigned int kFrames = 64;
+    constexpr int kBlocks = 20000;
+    constexpr int kReaders = 3;
+    auto tap = std::make_shared<WaveformTap>(2, kFrames, 4);
+
+    struct Result
+    {
+        std::uint64_t read{0};
+        std::uint64_t skipped{0};
+        bool torn{false};
+        bool ordered{true};
+    };
+    std::vector<Result> results(kReaders);
+    std::vector<WaveformTap::Reader> readers(kReaders,
+                                             WaveformTap::Reader(tap));
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < kReaders; ++r)
+    {
+        threads.emplace_back(
+            [&, r]
+            {
+                Result &result = results[r];
+                std::vector<float> block;
+                float last = -1.0f;
+                for (;;)
+                {
+                    const bool finished = done.load(std::memory_order_acquire);
+                    if (!readers[r].read(block))
+                    {
+                        if (finished)
+                            break;
+                        continue;
+                    }
+                    ++result.read;
+                    for (float sample : block)
+                        result.torn |= sample != block[0];
+                    result.ordered &= block[0] > last;
+                    last = block[0];
+                }
+                result.skipped = readers[r].skippedBlocks();
+            });
+    }
+
+    std::vector<float> frames(kFrames * 2);
+    for (int n = 0; n < kBlocks; ++n)
+    {
+        std::fill(frames.begin(), frames.end(), static_cast<float>(n));
+        // Split each block across two writes, like a small quantum.
+        tap->write(frames.data(), kFrames / 2, 2);
+        tap->write(frames.data() + kFrames, kFrames / 2, 2);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &thread : threads)
+        thread.join();
+
+    for (const Result &result : results)
+    {
+        EXPECT_FALSE(result.torn);
+        EXPECT_TRUE(result.ordered);
+        EXPECT_GT(result.read, 0u);
+        EXPECT_EQ(result.read + result.skipped,
+                  static_cast<std::uint64_t>(kBlocks));
+    }
+}
+
+// Verifies that detaching the tap and meter from a mixer rendering on
+// another thread waits for the block using them, so they can be destroyed
+// right after. Run under a sanitizer, a premature return shows up as a
+// use after free.
+TEST(WaveformTap, MixerDetachWaitsForTheAudioThread)
+{
+    MixerPlaybackUnit mixer;
+    auto unit = std::make_shared<MockPlaybackUnit>();
+    unit->fillValue = 0.5f;
+    mixer.addUnit(unit);
+
+    std::atomic<bool> done{false};
+    std::thread audio(
+        [&]
+        {
+            // Long blocks keep the meter busy, widening the window.
+            std::vector<float> buffer(2048 * 2);
+            types::RenderContext context;
+            while (!done.load(std::memory_order_acquire))
+                mixer.render(buffer.data(), 2048, 2, context);
+        });
+
+    for (int i = 0; i < 20; ++i)
+    {
+        auto tap = std::make_unique<WaveformTap>(2, 256, 4);
+        auto meter = std::make_unique<LevelMeter>();
+        mixer.setLevelMeter(meter.get());
+        mixer.setWaveformTap(tap.get());
+
+        // Detach while a block is most likely still metering.
+        while (tap->publishedBlocks() == 0)
+            std::this_thread::yield();
+        mixer.setWaveformTap(nullptr);
+        mixer.setLevelMeter(nullptr);
+    }
+
+    done.store(true, std::memory_order_release);
+    audio.join();
+}